@@ -0,0 +1,50 @@
+#-------------------------------------------------
+#
+# Benchmarks for the FlySight Configurator track tools
+#
+#-------------------------------------------------
+
+QT       += core concurrent
+QT       -= gui
+
+TARGET = FlySightBench
+TEMPLATE = app
+
+CONFIG   += console
+CONFIG   -= app_bundle
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+INCLUDEPATH += ../src
+
+SOURCES += main.cpp \
+    ../src/atmosphere.cpp \
+    ../src/configuration.cpp \
+    ../src/configurationfile.cpp \
+    ../src/configurationgenerator.cpp \
+    ../src/configurationprofiles.cpp \
+    ../src/configurationwriter.cpp \
+    ../src/gnssparser.cpp \
+    ../src/jumpsegmenter.cpp \
+    ../src/timezoneresolver.cpp \
+    ../src/track.cpp \
+    ../src/trackcache.cpp \
+    ../src/trackreader.cpp \
+    ../src/tracksmoother.cpp
+
+HEADERS  += \
+    ../src/atmosphere.h \
+    ../src/configuration.h \
+    ../src/configurationfile.h \
+    ../src/configurationgenerator.h \
+    ../src/configurationprofiles.h \
+    ../src/configurationwriter.h \
+    ../src/gnssparser.h \
+    ../src/jumpsegmenter.h \
+    ../src/spscqueue.h \
+    ../src/timezoneresolver.h \
+    ../src/track.h \
+    ../src/trackcache.h \
+    ../src/trackcolumn.h \
+    ../src/trackreader.h \
+    ../src/tracksmoother.h
@@ -0,0 +1,553 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QPointF>
+#include <QStringList>
+#include <QTextStream>
+#include <QVector>
+
+#include <cmath>
+#include <cstdio>
+#include <limits>
+
+#include "atmosphere.h"
+#include "configurationgenerator.h"
+#include "configurationprofiles.h"
+#include "configurationwriter.h"
+#include "gnssparser.h"
+#include "timezoneresolver.h"
+#include "track.h"
+#include "trackcache.h"
+#include "trackreader.h"
+#include "tracksmoother.h"
+
+#define DEFAULT_ROWS 2000000
+#define SMOOTH_ROWS 10000000
+#define TIMEZONE_LOOKUPS 1000000
+#define GNSS_FIXES 1000000
+#define PROFILE_JUMPERS 5000
+#define PROFILE_DISCIPLINES 10
+#define GENERATOR_VARIANTS 10000
+
+// Bytes per read when parsing, about what a serial adapter delivers
+#define GNSS_READ_CHUNK 64
+
+static void report(
+        const char *name,
+        qint64 bytes,
+        int rows,
+        qint64 nsecs)
+{
+    const double seconds = nsecs / 1e9;
+    printf("%-24s %10d rows %9.3f s %9.1f MB/s\n",
+           name, rows, seconds, bytes / seconds / 1e6);
+}
+
+static QString writeSyntheticTrack(
+        int rows)
+{
+    const QString fileName = QDir::temp().filePath("flysight-bench-track.csv");
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) return QString();
+
+    QTextStream out(&file);
+    out << "time,lat,lon,hMSL,velN,velE,velD,hAcc,vAcc,sAcc,heading,cAcc,gpsFix,numSV" << endl;
+    out << ",(deg),(deg),(m),(m/s),(m/s),(m/s),(m),(m),(m/s),(deg),(deg),," << endl;
+
+    const qint64 start = QDateTime::fromString("2018-05-12T17:00:00Z", Qt::ISODate).toMSecsSinceEpoch();
+    for (int i = 0; i < rows; ++i)
+    {
+        const QDateTime time = QDateTime::fromMSecsSinceEpoch(start + i * 200, Qt::UTC);
+        out << time.toString("yyyy-MM-ddThh:mm:ss.zzz").left(22) << "Z,"
+            << QString::number(51.0 + i * 1e-7, 'f', 7) << ","
+            << QString::number(-114.0 - i * 1e-7, 'f', 7) << ","
+            << QString::number(4000.0 - i * 0.01, 'f', 3) << ","
+            << QString::number(10.0 + (i % 100) * 0.01, 'f', 2) << ","
+            << QString::number(-5.0 + (i % 50) * 0.02, 'f', 2) << ","
+            << QString::number(50.0 + (i % 30) * 0.1, 'f', 2) << ","
+            << "3.456,5.678,0.52,180.12345,1.23456,3," << (6 + i % 8) << endl;
+    }
+
+    return fileName;
+}
+
+// Reference reader in the style of MainWindow::loadFile
+static int readNaive(
+        const QString &fileName,
+        Track &track)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) return 0;
+
+    track.clear();
+
+    QTextStream in(&file);
+    in.readLine();
+    in.readLine();
+
+    while (!in.atEnd())
+    {
+        QStringList cols = in.readLine().split(",");
+        if (cols.length() < 14) continue;
+
+        const QDateTime time = QDateTime::fromString(cols[0], Qt::ISODateWithMs);
+
+        track.time.append(time.toMSecsSinceEpoch() / 1000.);
+        track.lat.append(cols[1].toDouble());
+        track.lon.append(cols[2].toDouble());
+        track.hMSL.append(cols[3].toFloat());
+        track.velN.append(cols[4].toFloat());
+        track.velE.append(cols[5].toFloat());
+        track.velD.append(cols[6].toFloat());
+        track.hAcc.append(cols[7].toFloat());
+        track.vAcc.append(cols[8].toFloat());
+        track.sAcc.append(cols[9].toFloat());
+        track.numSV.append(cols[13].toFloat());
+    }
+
+    return track.size();
+}
+
+// Reports each column where the readers disagree
+static void compareTracks(
+        const Track &expected,
+        const Track &actual)
+{
+    static const char *const names[Track::ColumnCount] =
+    {
+        "time", "lat", "lon", "hMSL", "velN", "velE", "velD",
+        "hAcc", "vAcc", "sAcc", "numSV"
+    };
+
+    if (expected.size() != actual.size())
+    {
+        printf("%-24s %10d rows, expected %d\n",
+               "TrackReader mismatch", actual.size(), expected.size());
+        return;
+    }
+
+    for (int c = 0; c < Track::ColumnCount; ++c)
+    {
+        const Track::Column column = (Track::Column) c;
+
+        // Times are summed from their fields rather than divided from ms
+        const double tolerance = (column == Track::Time) ? 1e-6 : 0;
+
+        int mismatches = 0;
+        for (int i = 0; i < expected.size(); ++i)
+        {
+            if (fabs(expected.value(column, i) - actual.value(column, i)) > tolerance)
+            {
+                ++mismatches;
+            }
+        }
+
+        if (mismatches > 0)
+        {
+            printf("%-24s %10d rows differ in %s\n",
+                   "TrackReader mismatch", mismatches, names[c]);
+        }
+    }
+}
+
+static void benchTrackReader(
+        const QString &fileName)
+{
+    const qint64 bytes = QFileInfo(fileName).size();
+
+    QElapsedTimer timer;
+    Track expected, track;
+
+    timer.start();
+    const int naiveRows = readNaive(fileName, expected);
+    report("QTextStream::readLine", bytes, naiveRows, timer.nsecsElapsed());
+
+    TrackReader reader;
+
+    timer.start();
+    if (!reader.read(fileName, track))
+    {
+        printf("TrackReader failed: %s\n", qPrintable(reader.errorString()));
+        return;
+    }
+    report("TrackReader", bytes, track.size(), timer.nsecsElapsed());
+
+    compareTracks(expected, track);
+}
+
+static void benchTrackCache(
+        const QString &fileName)
+{
+    const qint64 bytes = QFileInfo(fileName).size();
+
+    TrackCache cache;
+    cache.setFolder(QDir::temp().filePath("flysight-bench-cache"));
+    QFile::remove(cache.cachePath(fileName));
+
+    QElapsedTimer timer;
+
+    timer.start();
+    {
+        Track track;
+        cache.load(fileName, track);
+        report("TrackCache (cold)", bytes, track.size(), timer.nsecsElapsed());
+    }
+
+    timer.start();
+    {
+        Track track;
+        cache.load(fileName, track);
+        report("TrackCache (warm)", bytes, track.size(), timer.nsecsElapsed());
+    }
+}
+
+static void benchAtmosphere(
+        int rows)
+{
+    QVector< float > hMSL(rows);
+    QVector< float > direct(rows);
+    QVector< float > table(rows);
+
+    for (int i = 0; i < rows; ++i)
+    {
+        hMSL[i] = 4500.f - i * (4500.f / rows);
+    }
+
+    QElapsedTimer timer;
+
+    timer.start();
+    for (int i = 0; i < rows; ++i)
+    {
+        direct[i] = Atmosphere::airspeedFactorDirect(hMSL[i]);
+    }
+    const qint64 directTime = timer.nsecsElapsed();
+
+    timer.start();
+    Atmosphere::airspeedFactors(hMSL.constData(), table.data(), rows);
+    const qint64 tableTime = timer.nsecsElapsed();
+
+    double error = 0;
+    for (int i = 0; i < rows; ++i)
+    {
+        error = qMax(error, (double) fabs(direct[i] - table[i]));
+    }
+
+    // Missing altitudes in both the vector and scalar parts of a batch
+    // must match a single lookup
+    const float nan = std::numeric_limits< float >::quiet_NaN();
+    const float missing[7] = { nan, 1000.f, nan, 3000.f, -5000.f, nan, nan };
+    float batch[7];
+    Atmosphere::airspeedFactors(missing, batch, 7);
+
+    int mismatches = 0;
+    for (int i = 0; i < 7; ++i)
+    {
+        if (batch[i] != Atmosphere::airspeedFactor(missing[i])) ++mismatches;
+    }
+
+    printf("%-24s %10d rows %9.3f ns/row\n",
+           "Atmosphere (direct)", rows, (double) directTime / rows);
+    printf("%-24s %10d rows %9.3f ns/row, max error %g, NaN mismatches %d\n",
+           "Atmosphere (table)", rows, (double) tableTime / rows, error, mismatches);
+}
+
+static void benchConfigurationProfiles(
+        int jumpers)
+{
+    typedef ConfigurationFile::Setting Setting;
+
+    ConfigurationProfiles profiles;
+
+    ConfigurationFile::Settings base;
+    base << Setting("Mode", "2") << Setting("Min", "0") << Setting("Max", "300")
+         << Setting("Limits", "1") << Setting("Mode_2", "9") << Setting("Min_Val_2", "300")
+         << Setting("Max_Val_2", "1500") << Setting("Min_Rate", "100") << Setting("Max_Rate", "500")
+         << Setting("Sp_Rate", "0") << Setting("V_Thresh", "1000") << Setting("H_Thresh", "0")
+         << Setting("Alarm_Elev", "1000") << Setting("Alarm_Type", "1");
+    const int root = profiles.add("base", -1, base);
+
+    QVector< int > disciplines;
+    for (int i = 0; i < PROFILE_DISCIPLINES; ++i)
+    {
+        ConfigurationFile::Settings overrides;
+        overrides << Setting("Mode", QString::number(i % 5))
+                  << Setting("Max", QString::number(3000 + 100 * i));
+        disciplines.append(profiles.add(QString("discipline%1").arg(i), root, overrides));
+    }
+
+    QVector< int > ids;
+    for (int i = 0; i < jumpers; ++i)
+    {
+        ConfigurationFile::Settings overrides;
+        overrides << Setting("DZ_Elev", QString::number(i % 1500))
+                  << Setting("TZ_Offset", QString::number((i % 24 - 12) * 3600))
+                  << Setting("Alarm_Elev", QString::number(1000 + i % 500))
+                  << Setting("Alarm_Type", "2");
+        ids.append(profiles.add(QString("jumper%1").arg(i),
+                                disciplines[i % disciplines.size()], overrides));
+    }
+
+    QElapsedTimer timer;
+    qint64 checksum = 0;
+
+    timer.start();
+    foreach (int id, ids) checksum += profiles.resolve(id).maxTone;
+    const qint64 coldTime = timer.nsecsElapsed();
+    const int coldResolutions = profiles.resolutions();
+
+    timer.start();
+    foreach (int id, ids) checksum += profiles.resolve(id).maxTone;
+    const qint64 warmTime = timer.nsecsElapsed();
+
+    // An edit to the base reaches every jumper
+    base[0].second = "1";
+    profiles.setOverrides(root, base);
+
+    timer.start();
+    foreach (int id, ids) checksum += profiles.resolve(id).toneMode;
+    const qint64 editTime = timer.nsecsElapsed();
+
+    printf("%-24s %10d profiles %9.3f ms, %d resolved\n",
+           "Profiles (cold)", jumpers, coldTime / 1e6, coldResolutions);
+    printf("%-24s %10d profiles %9.3f ms\n",
+           "Profiles (cached)", jumpers, warmTime / 1e6);
+    printf("%-24s %10d profiles %9.3f ms, %d resolved, checksum %lld\n",
+           "Profiles (base edited)", jumpers, editTime / 1e6,
+           profiles.resolutions() - coldResolutions, checksum);
+}
+
+static void benchConfigurationGenerator(
+        int count)
+{
+    typedef ConfigurationFile::Setting Setting;
+
+    ConfigurationGenerator::Variants variants;
+    for (int i = 0; i < count; ++i)
+    {
+        ConfigurationGenerator::Variant variant;
+        variant.folder = QString("%1").arg(i, 5, 10, QChar('0'));
+        variant.overrides << Setting("Max", QString::number(3000 + i % 1000))
+                          << Setting("DZ_Elev", QString::number(i % 1500))
+                          << Setting("Alarm_Elev", "1000") << Setting("Alarm_Type", "1")
+                          << Setting("Alarm_Elev", QString::number(300 + i % 200))
+                          << Setting("Alarm_Type", "3");
+        variants.append(variant);
+    }
+
+    const Configuration base;
+    QElapsedTimer timer;
+    qint64 bytes = 0;
+
+    // Text only, to separate formatting from the file system
+    timer.start();
+    {
+        ConfigurationWriter writer;
+        foreach (const ConfigurationGenerator::Variant &variant, variants)
+        {
+            Configuration configuration = base;
+            ConfigurationProfiles::apply(variant.overrides, configuration);
+            bytes += writer.write(configuration).size();
+        }
+    }
+    const double writeTime = timer.nsecsElapsed() / 1e9;
+
+    const QString folder = QDir::temp().filePath("flysight-bench-variants");
+    QDir(folder).removeRecursively();
+
+    timer.start();
+    int written = 0;
+    foreach (const ConfigurationGenerator::Result &result,
+             ConfigurationGenerator::generate(variants, base, folder).results())
+    {
+        written += result.written;
+    }
+    const double generateTime = timer.nsecsElapsed() / 1e9;
+
+    printf("%-24s %10d files %9.3f s %9.0f files/s, %lld bytes\n",
+           "ConfigurationWriter", count, writeTime, count / writeTime, bytes);
+    printf("%-24s %10d files %9.3f s %9.0f files/s\n",
+           "ConfigurationGenerator", written, generateTime, written / generateTime);
+
+    QDir(folder).removeRecursively();
+}
+
+static void benchTrackSmoother(
+        int rows)
+{
+    Track track;
+    track.resize(rows);
+
+    double *time = track.time.data();
+    float *velN = track.velN.data();
+    float *velE = track.velE.data();
+    float *velD = track.velD.data();
+
+    for (int i = 0; i < rows; ++i)
+    {
+        time[i] = i * 0.2;
+        velN[i] = 40.f + (i % 7) * 0.1f;
+        velE[i] = 5.f - (i % 5) * 0.1f;
+        velD[i] = 50.f + (i % 3) * 0.1f;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    const Track smoothed = TrackSmoother(2.0).smooth(track);
+    const qint64 nsecs = timer.nsecsElapsed();
+
+    printf("%-24s %10d rows %9.3f s %9.3f ns/row\n",
+           "TrackSmoother (2 s)", smoothed.size(), nsecs / 1e9, (double) nsecs / rows);
+}
+
+static void benchTimeZoneResolver(
+        int lookups)
+{
+    TimeZoneResolver resolver;
+
+    // Ragged zones on a 12 degree grid, a few hundred edges each
+    for (int lat = -72; lat <= 72; lat += 12)
+    {
+        for (int lon = -174; lon <= 174; lon += 12)
+        {
+            const int points = 300;
+
+            QVector< QPointF > ring;
+            for (int i = 0; i < points; ++i)
+            {
+                const double a = 2 * M_PI * i / points;
+                const double r = 5.0 + 0.8 * sin(7 * a) + 0.3 * sin(31 * a + lon);
+                ring.append(QPointF(lon + r * cos(a), lat + r * sin(a)));
+            }
+
+            resolver.addPolygon(QString("Zone/%1/%2").arg(lat).arg(lon),
+                                QVector< QVector< QPointF > >() << ring);
+        }
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    resolver.build();
+    const qint64 buildTime = timer.nsecsElapsed();
+
+    // Points scattered over the whole globe
+    int found = 0;
+    timer.start();
+    for (int i = 0; i < lookups; ++i)
+    {
+        const double lat = -90 + 180.0 * (i * 7919LL % lookups) / lookups;
+        const double lon = -180 + 360.0 * (i * 104729LL % lookups) / lookups;
+        if (resolver.zoneIndex(lat, lon) >= 0) ++found;
+    }
+    const qint64 lookupTime = timer.nsecsElapsed();
+
+    printf("%-24s %9.3f s\n", "TimeZoneResolver build", buildTime / 1e9);
+    printf("%-24s %10d rows %9.3f ns/row, %d in a zone\n",
+           "TimeZoneResolver lookup", lookups, (double) lookupTime / lookups, found);
+}
+
+static void benchGnssParser(
+        int fixes,
+        bool nmea)
+{
+    QByteArray stream;
+    stream.reserve(fixes * GNSS_MAX_ENCODED);
+
+    for (int i = 0; i < fixes; ++i)
+    {
+        GnssFix fix;
+        fix.time = 1.5e9 + i * 0.2;
+        fix.lat = 49.0 + 1e-6 * (i % 1000);
+        fix.lon = -123.0 - 1e-6 * (i % 1000);
+        fix.hMSL = 4000 - 0.01f * (i % 100000);
+        fix.velN = 20 + (i % 13);
+        fix.velE = -10 + (i % 7);
+        fix.velD = 50 - (i % 11);
+        fix.hAcc = 2;
+        fix.vAcc = 3;
+        fix.sAcc = 0.5f;
+        fix.numSV = 12;
+        fix.received = 0;
+
+        char message[GNSS_MAX_ENCODED];
+        const int size = nmea
+                ? GnssParser::encodeNmea(fix, message)
+                : GnssParser::encodeUbx(fix, message);
+        stream.append(message, size);
+    }
+
+    GnssParser parser;
+    GnssQueue queue(256);
+    GnssFix fix;
+    int parsed = 0;
+
+    // Reads split messages, so the carry-over path is exercised too
+    QElapsedTimer timer;
+    timer.start();
+    for (int offset = 0; offset < stream.size(); offset += GNSS_READ_CHUNK)
+    {
+        parser.parse(stream.constData() + offset,
+                     qMin(GNSS_READ_CHUNK, stream.size() - offset),
+                     offset, queue);
+        while (queue.pop(fix)) ++parsed;
+    }
+    const qint64 nsecs = timer.nsecsElapsed();
+
+    report(nmea ? "GnssParser (NMEA)" : "GnssParser (UBX)", stream.size(), parsed, nsecs);
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    const QStringList args = a.arguments();
+
+    // Use the given track, or generate one
+    QString fileName;
+    if (args.size() > 1)
+    {
+        fileName = args[1];
+    }
+    else
+    {
+        fileName = writeSyntheticTrack(DEFAULT_ROWS);
+    }
+
+    benchTrackReader(fileName);
+    benchTrackCache(fileName);
+    benchAtmosphere(DEFAULT_ROWS);
+    benchTrackSmoother(SMOOTH_ROWS);
+    benchConfigurationProfiles(PROFILE_JUMPERS);
+    benchConfigurationGenerator(GENERATOR_VARIANTS);
+    benchTimeZoneResolver(TIMEZONE_LOOKUPS);
+    benchGnssParser(GNSS_FIXES, false);
+    benchGnssParser(GNSS_FIXES, true);
+
+    return 0;
+}
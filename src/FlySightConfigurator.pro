@@ -4,7 +4,7 @@
 #
 #-------------------------------------------------
 
-QT       += core gui
+QT       += core gui concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -33,10 +33,59 @@ SOURCES += main.cpp\
     speechform.cpp \
     thresholdsform.cpp \
     initializationform.cpp \
+    jumpsegmenter.cpp \
     alarmform.cpp \
     silenceform.cpp \
     miscellaneousform.cpp \
-    altitudeform.cpp
+    altitudeform.cpp \
+    alarmevaluator.cpp \
+    alarmreportdialog.cpp \
+    alarmrobustness.cpp \
+    alarmstage.cpp \
+    altitudedialog.cpp \
+    altitudeplot.cpp \
+    atmosphere.cpp \
+    comparisondialog.cpp \
+    configurationfile.cpp \
+    configurationgenerator.cpp \
+    configurationprofiles.cpp \
+    configurationwriter.cpp \
+    elevationdialog.cpp \
+    elevationfiller.cpp \
+    elevationmodel.cpp \
+    gnssparser.cpp \
+    gnssreceiver.cpp \
+    gnssreplay.cpp \
+    livedialog.cpp \
+    livesimulator.cpp \
+    quantilesketch.cpp \
+    rangestatistics.cpp \
+    rangesuggester.cpp \
+    regressiondialog.cpp \
+    regressionreport.cpp \
+    robustnessdialog.cpp \
+    sasstage.cpp \
+    simulationcache.cpp \
+    simulationcomparison.cpp \
+    simulationgraph.cpp \
+    simulator.cpp \
+    speechstage.cpp \
+    suggestdialog.cpp \
+    thumbnailservice.cpp \
+    timezonedialog.cpp \
+    timezonefiller.cpp \
+    timezoneresolver.cpp \
+    tonecurve.cpp \
+    tonestage.cpp \
+    track.cpp \
+    trackbrowserdialog.cpp \
+    trackcache.cpp \
+    trackdialog.cpp \
+    trackplot.cpp \
+    trackpyramid.cpp \
+    trackreader.cpp \
+    trackresampler.cpp \
+    tracksmoother.cpp
 
 HEADERS  += mainwindow.h \
     configuration.h \
@@ -47,10 +96,62 @@ HEADERS  += mainwindow.h \
     speechform.h \
     thresholdsform.h \
     initializationform.h \
+    jumpsegmenter.h \
     alarmform.h \
     silenceform.h \
     miscellaneousform.h \
-    altitudeform.h
+    altitudeform.h \
+    alarmevaluator.h \
+    alarmreportdialog.h \
+    alarmrobustness.h \
+    alarmstage.h \
+    altitudedialog.h \
+    altitudeplot.h \
+    atmosphere.h \
+    comparisondialog.h \
+    configurationfile.h \
+    configurationgenerator.h \
+    configurationprofiles.h \
+    configurationwriter.h \
+    counterrng.h \
+    elevationdialog.h \
+    elevationfiller.h \
+    elevationmodel.h \
+    gnssparser.h \
+    gnssreceiver.h \
+    gnssreplay.h \
+    livedialog.h \
+    livesimulator.h \
+    quantilesketch.h \
+    rangestatistics.h \
+    rangesuggester.h \
+    regressiondialog.h \
+    regressionreport.h \
+    robustnessdialog.h \
+    sasstage.h \
+    simulationcache.h \
+    simulationcomparison.h \
+    simulationgraph.h \
+    simulator.h \
+    speechstage.h \
+    spscqueue.h \
+    suggestdialog.h \
+    thumbnailservice.h \
+    timezonedialog.h \
+    timezonefiller.h \
+    timezoneresolver.h \
+    tonecurve.h \
+    tonestage.h \
+    track.h \
+    trackbrowserdialog.h \
+    trackcache.h \
+    trackcolumn.h \
+    trackdialog.h \
+    trackplot.h \
+    trackpyramid.h \
+    trackreader.h \
+    trackresampler.h \
+    tracksmoother.h
 
 FORMS    += mainwindow.ui \
     generalform.ui \
@@ -62,7 +163,18 @@ FORMS    += mainwindow.ui \
     alarmform.ui \
     silenceform.ui \
     miscellaneousform.ui \
-    altitudeform.ui
+    altitudeform.ui \
+    alarmreportdialog.ui \
+    altitudedialog.ui \
+    comparisondialog.ui \
+    elevationdialog.ui \
+    livedialog.ui \
+    regressiondialog.ui \
+    robustnessdialog.ui \
+    suggestdialog.ui \
+    timezonedialog.ui \
+    trackbrowserdialog.ui \
+    trackdialog.ui
 
 win32 {
     RC_ICONS = FlySightConfigurator.ico
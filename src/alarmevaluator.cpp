@@ -0,0 +1,305 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "alarmevaluator.h"
+
+#include <QObject>
+#include <QtConcurrentMap>
+
+#include <algorithm>
+
+#include "track.h"
+#include "trackcache.h"
+
+class EvaluateFile
+{
+public:
+    typedef AlarmEvaluator::Result result_type;
+
+    EvaluateFile(const Configuration &configuration) :
+        configuration(configuration)
+    {
+
+    }
+
+    AlarmEvaluator::Result operator()(const QString &fileName) const
+    {
+        AlarmEvaluator::Result result;
+        result.fileName = fileName;
+
+        Track track;
+        TrackCache cache;
+        if (cache.load(fileName, track))
+        {
+            AlarmEvaluator evaluator(configuration);
+
+            // Only exit to landing is evaluated, skipping the ride down
+            // in the aircraft
+            JumpSegmenter segmenter;
+            cache.segment(track, segmenter);
+            result.jumps = segmenter.jumps();
+
+            if (result.jumps.isEmpty())
+            {
+                result.events = evaluator.evaluate(track);
+            }
+
+            foreach (const JumpSegmenter::Jump &jump, result.jumps)
+            {
+                result.events += evaluator.evaluate(
+                            track, jump.exit, JumpSegmenter::jumpEnd(jump, track));
+            }
+        }
+        else
+        {
+            result.error = cache.errorString();
+        }
+
+        return result;
+    }
+
+private:
+    Configuration configuration;
+};
+
+AlarmEvaluator::AlarmEvaluator(
+        const Configuration &configuration) :
+    groundElevation(configuration.groundElevation)
+{
+    for (int i = 0; i < configuration.alarms.size(); ++i)
+    {
+        const Configuration::Alarm &alarm = configuration.alarms[i];
+
+        if (alarm.mode != Configuration::NoAlarm)
+        {
+            addEdge(alarm.elevation, Trigger, i);
+        }
+
+        if (configuration.alarmWindowAbove > 0 || configuration.alarmWindowBelow > 0)
+        {
+            addInterval(alarm.elevation - configuration.alarmWindowBelow,
+                        alarm.elevation + configuration.alarmWindowAbove,
+                        AlarmWindowEntered, AlarmWindowExited, i);
+        }
+    }
+
+    for (int i = 0; i < configuration.windows.size(); ++i)
+    {
+        const Configuration::Window &window = configuration.windows[i];
+        addInterval(window.bottom, window.top,
+                    SilenceWindowEntered, SilenceWindowExited, i);
+    }
+
+    std::stable_sort(edges.begin(), edges.end(), edgeLessThan);
+
+    reset();
+}
+
+bool AlarmEvaluator::edgeLessThan(
+        const Edge &a,
+        const Edge &b)
+{
+    return a.value < b.value;
+}
+
+void AlarmEvaluator::addEdge(
+        double value,
+        EdgeKind kind,
+        int index)
+{
+    Edge edge;
+    edge.value = value;
+    edge.kind = kind;
+    edge.index = index;
+    edges.append(edge);
+}
+
+void AlarmEvaluator::addInterval(
+        double bottom,
+        double top,
+        EventType entered,
+        EventType exited,
+        int index)
+{
+    if (top <= bottom) return;
+
+    Interval interval;
+    interval.bottom = bottom;
+    interval.top = top;
+    interval.entered = entered;
+    interval.exited = exited;
+    interval.index = index;
+
+    addEdge(bottom, Lower, intervals.size());
+    addEdge(top, Upper, intervals.size());
+    intervals.append(interval);
+}
+
+void AlarmEvaluator::reset()
+{
+    cursor = 0;
+    insideCount = 0;
+    started = false;
+    prevTime = 0;
+    prevAltitude = 0;
+}
+
+void AlarmEvaluator::process(
+        int sample,
+        double time,
+        double altitude,
+        Events &events)
+{
+    if (!started)
+    {
+        while (cursor < edges.size() && edges[cursor].value <= altitude)
+        {
+            ++cursor;
+        }
+
+        // Enter every interval containing the first sample
+        foreach (const Interval &interval, intervals)
+        {
+            if (interval.bottom <= altitude && altitude < interval.top)
+            {
+                Event event;
+                event.type = interval.entered;
+                event.index = interval.index;
+                event.sample = sample;
+                event.time = time;
+                event.altitude = altitude;
+                events.append(event);
+
+                ++insideCount;
+            }
+        }
+
+        started = true;
+    }
+    else if (altitude > prevAltitude)
+    {
+        while (cursor < edges.size() && edges[cursor].value <= altitude)
+        {
+            cross(edges[cursor], true, sample, time, altitude, events);
+            ++cursor;
+        }
+    }
+    else if (altitude < prevAltitude)
+    {
+        while (cursor > 0 && edges[cursor - 1].value > altitude)
+        {
+            cross(edges[cursor - 1], false, sample, time, altitude, events);
+            --cursor;
+        }
+    }
+
+    prevTime = time;
+    prevAltitude = altitude;
+}
+
+void AlarmEvaluator::cross(
+        const Edge &edge,
+        bool up,
+        int sample,
+        double time,
+        double altitude,
+        Events &events)
+{
+    Event event;
+    event.sample = sample;
+    event.altitude = edge.value;
+
+    // Interpolate time of crossing
+    event.time = prevTime + (edge.value - prevAltitude)
+            / (altitude - prevAltitude) * (time - prevTime);
+
+    switch (edge.kind)
+    {
+    case Trigger:
+        // Alarms only sound while descending
+        if (up) return;
+        event.type = AlarmTriggered;
+        event.index = edge.index;
+        break;
+    case Lower:
+        event.type = up ? intervals[edge.index].entered : intervals[edge.index].exited;
+        event.index = intervals[edge.index].index;
+        insideCount += up ? 1 : -1;
+        break;
+    case Upper:
+        event.type = up ? intervals[edge.index].exited : intervals[edge.index].entered;
+        event.index = intervals[edge.index].index;
+        insideCount += up ? -1 : 1;
+        break;
+    }
+
+    events.append(event);
+}
+
+AlarmEvaluator::Events AlarmEvaluator::evaluate(
+        const Track &track)
+{
+    return evaluate(track, 0, track.size());
+}
+
+AlarmEvaluator::Events AlarmEvaluator::evaluate(
+        const Track &track,
+        int begin,
+        int end)
+{
+    Events events;
+
+    reset();
+
+    const double *time = track.time.constData();
+    const float *hMSL = track.hMSL.constData();
+
+    for (int i = begin; i < end; ++i)
+    {
+        process(i, time[i], hMSL[i] - groundElevation, events);
+    }
+
+    return events;
+}
+
+QString AlarmEvaluator::eventName(
+        EventType type)
+{
+    switch (type)
+    {
+    case AlarmTriggered:       return QObject::tr("Alarm");
+    case AlarmWindowEntered:   return QObject::tr("Enter alarm window");
+    case AlarmWindowExited:    return QObject::tr("Exit alarm window");
+    case SilenceWindowEntered: return QObject::tr("Enter silence window");
+    case SilenceWindowExited:  return QObject::tr("Exit silence window");
+    }
+    return QString();
+}
+
+QFuture< AlarmEvaluator::Result > AlarmEvaluator::evaluateFiles(
+        const QStringList &fileNames,
+        const Configuration &configuration)
+{
+    // Each file is loaded and evaluated on the global thread pool
+    return QtConcurrent::mapped(fileNames, EvaluateFile(configuration));
+}
@@ -0,0 +1,123 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef ALARMEVALUATOR_H
+#define ALARMEVALUATOR_H
+
+#include <QFuture>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "configuration.h"
+#include "jumpsegmenter.h"
+
+class Track;
+
+class AlarmEvaluator
+{
+public:
+    typedef enum {
+        AlarmTriggered = 0,
+        AlarmWindowEntered,
+        AlarmWindowExited,
+        SilenceWindowEntered,
+        SilenceWindowExited
+    } EventType;
+
+    typedef struct {
+        EventType type;
+        int index;          // Alarm or silence window index
+        int sample;         // First sample past the crossing
+        double time;        // Seconds since epoch (UTC)
+        double altitude;    // m above ground
+    } Event;
+
+    typedef QVector< Event > Events;
+
+    typedef struct {
+        QString fileName;
+        QString error;
+        JumpSegmenter::Jumps jumps;
+        Events events;
+    } Result;
+
+    explicit AlarmEvaluator(const Configuration &configuration);
+
+    void reset();
+    void process(int sample, double time, double altitude, Events &events);
+    Events evaluate(const Track &track);
+    Events evaluate(const Track &track, int begin, int end);
+
+    // True while inside an alarm window or silence window
+    bool isSilenced() const { return insideCount > 0; }
+
+    static QString eventName(EventType type);
+    // Evaluates each jump found in the files, or the whole track if none
+    static QFuture< Result > evaluateFiles(const QStringList &fileNames,
+                                           const Configuration &configuration);
+
+private:
+    typedef enum {
+        Trigger,
+        Lower,
+        Upper
+    } EdgeKind;
+
+    typedef struct {
+        double value;
+        EdgeKind kind;
+        int index;
+    } Edge;
+
+    typedef struct {
+        double bottom;
+        double top;
+        EventType entered;
+        EventType exited;
+        int index;
+    } Interval;
+
+    int groundElevation;
+
+    // Alarm elevations and window bounds sorted by altitude
+    QVector< Edge > edges;
+    QVector< Interval > intervals;
+
+    int cursor;
+    int insideCount;
+    bool started;
+    double prevTime;
+    double prevAltitude;
+
+    static bool edgeLessThan(const Edge &a, const Edge &b);
+
+    void addEdge(double value, EdgeKind kind, int index);
+    void addInterval(double bottom, double top, EventType entered,
+                     EventType exited, int index);
+
+    void cross(const Edge &edge, bool up, int sample, double time,
+               double altitude, Events &events);
+};
+
+#endif // ALARMEVALUATOR_H
@@ -27,12 +27,14 @@
 #include <QComboBox>
 
 #include "configuration.h"
+#include "elevationdialog.h"
 
 #define MAX_ALARMS 10
 
 AlarmForm::AlarmForm(QWidget *parent) :
     ConfigurationPage(parent),
-    ui(new Ui::AlarmForm)
+    ui(new Ui::AlarmForm),
+    units(Configuration::Metric)
 {
     ui->setupUi(this);
 
@@ -47,6 +49,10 @@ AlarmForm::AlarmForm(QWidget *parent) :
     connect(ui->removeButton, SIGNAL(clicked(bool)),
             this, SLOT(remove()));
 
+    // Fill ground elevation from elevation tiles
+    connect(ui->groundElevationButton, SIGNAL(clicked(bool)),
+            this, SLOT(lookUpGroundElevation()));
+
     // Update controls when selection changes
     connect(ui->tableWidget, SIGNAL(itemSelectionChanged()),
             this, SLOT(updateControls()));
@@ -101,9 +107,26 @@ void AlarmForm::updateControls()
     ui->addButton->setEnabled(ui->tableWidget->rowCount() < MAX_ALARMS);
 }
 
+void AlarmForm::lookUpGroundElevation()
+{
+    ElevationDialog dialog(this);
+    if (dialog.exec() != QDialog::Accepted) return;
+
+    Configuration configuration(units);
+    configuration.groundElevation = dialog.elevation();
+
+    const QString text = QString::number(configuration.groundElevationToUnits());
+    ui->groundElevationEdit->setText(text);
+
+    // Open tracks are simulated again, as for a typed value
+    emit valuesEdited();
+}
+
 void AlarmForm::setConfiguration(
         const Configuration &configuration)
 {
+    units = configuration.displayUnits;
+
     ui->windowAboveLabel->setText(
                 tr("Window above (%1):").arg(configuration.distanceUnits()));
     ui->windowBelowLabel->setText(
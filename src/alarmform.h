@@ -24,6 +24,7 @@
 #ifndef ALARMFORM_H
 #define ALARMFORM_H
 
+#include "configuration.h"
 #include "configurationpage.h"
 
 namespace Ui {
@@ -47,10 +48,13 @@ public:
 private:
     Ui::AlarmForm *ui;
 
+    Configuration::DisplayUnits units;
+
 private slots:
     int add();
     void remove();
     void updateControls();
+    void lookUpGroundElevation();
 };
 
 #endif // ALARMFORM_H
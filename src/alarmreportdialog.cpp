@@ -0,0 +1,133 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "alarmreportdialog.h"
+#include "ui_alarmreportdialog.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QTreeWidgetItem>
+
+#include "trackreader.h"
+
+AlarmReportDialog::AlarmReportDialog(
+        const Configuration &configuration,
+        const QString &folder,
+        QWidget *parent) :
+    QDialog(parent),
+    ui(new Ui::AlarmReportDialog),
+    configuration(configuration)
+{
+    ui->setupUi(this);
+
+    ui->treeWidget->setHeaderLabels(
+                QStringList() << tr("Time") << tr("Event")
+                << tr("Altitude (%1)").arg(configuration.distanceUnits()));
+
+    const QStringList fileNames = TrackReader::findTracks(folder);
+    ui->statusLabel->setText(tr("Checking %1 tracks in %2...")
+                             .arg(fileNames.size())
+                             .arg(QDir::toNativeSeparators(folder)));
+
+    connect(&watcher, SIGNAL(progressRangeChanged(int,int)),
+            ui->progressBar, SLOT(setRange(int,int)));
+    connect(&watcher, SIGNAL(progressValueChanged(int)),
+            ui->progressBar, SLOT(setValue(int)));
+    connect(&watcher, SIGNAL(resultReadyAt(int)),
+            this, SLOT(addResult(int)));
+    connect(&watcher, SIGNAL(finished()),
+            this, SLOT(finished()));
+
+    watcher.setFuture(AlarmEvaluator::evaluateFiles(fileNames, configuration));
+}
+
+AlarmReportDialog::~AlarmReportDialog()
+{
+    // Stop processing before results are discarded
+    watcher.cancel();
+    watcher.waitForFinished();
+
+    delete ui;
+}
+
+void AlarmReportDialog::addResult(
+        int index)
+{
+    const AlarmEvaluator::Result result = watcher.resultAt(index);
+
+    QTreeWidgetItem *fileItem = new QTreeWidgetItem(ui->treeWidget);
+    fileItem->setText(0, QFileInfo(result.fileName).fileName());
+    fileItem->setToolTip(0, QDir::toNativeSeparators(result.fileName));
+
+    if (!result.error.isEmpty())
+    {
+        fileItem->setText(1, result.error);
+        return;
+    }
+
+    // Group events under the jump they belong to
+    QVector< QTreeWidgetItem* > jumpItems;
+    for (int i = 0; i < result.jumps.size(); ++i)
+    {
+        QTreeWidgetItem *jumpItem = new QTreeWidgetItem(fileItem);
+        jumpItem->setText(0, tr("Jump %1").arg(i + 1));
+        jumpItems.append(jumpItem);
+    }
+
+    int alarms = 0;
+    int jump = 0;
+    foreach (const AlarmEvaluator::Event &event, result.events)
+    {
+        while (jump + 1 < result.jumps.size()
+               && event.sample >= result.jumps[jump + 1].exit)
+        {
+            ++jump;
+        }
+
+        QTreeWidgetItem *item = new QTreeWidgetItem(
+                    jumpItems.isEmpty() ? fileItem : jumpItems[jump]);
+
+        if (event.type == AlarmEvaluator::AlarmTriggered) ++alarms;
+
+        const QDateTime time = QDateTime::fromMSecsSinceEpoch(
+                    qRound64(event.time * 1000), Qt::UTC);
+        item->setText(0, time.toString("yyyy-MM-dd hh:mm:ss.zzz"));
+
+        item->setText(1, QString("%1 %2")
+                      .arg(AlarmEvaluator::eventName(event.type))
+                      .arg(event.index + 1));
+
+        item->setText(2, QString::number(
+                          configuration.valueToDistanceUnits(qRound(event.altitude))));
+    }
+
+    fileItem->setText(1, tr("%n jump(s), ", 0, result.jumps.size())
+                      + tr("%n alarm(s)", 0, alarms));
+}
+
+void AlarmReportDialog::finished()
+{
+    ui->statusLabel->setText(tr("Checked %1 tracks.")
+                             .arg(ui->treeWidget->topLevelItemCount()));
+}
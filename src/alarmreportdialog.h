@@ -0,0 +1,58 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef ALARMREPORTDIALOG_H
+#define ALARMREPORTDIALOG_H
+
+#include <QDialog>
+#include <QFutureWatcher>
+
+#include "alarmevaluator.h"
+#include "configuration.h"
+
+namespace Ui {
+class AlarmReportDialog;
+}
+
+class AlarmReportDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit AlarmReportDialog(const Configuration &configuration,
+                               const QString &folder,
+                               QWidget *parent = 0);
+    ~AlarmReportDialog();
+
+private:
+    Ui::AlarmReportDialog *ui;
+
+    Configuration configuration;
+    QFutureWatcher< AlarmEvaluator::Result > watcher;
+
+private slots:
+    void addResult(int index);
+    void finished();
+};
+
+#endif // ALARMREPORTDIALOG_H
@@ -0,0 +1,336 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "alarmrobustness.h"
+
+#include <QtConcurrentMap>
+#include <QtMath>
+
+#include <limits>
+
+#include "counterrng.h"
+#include "jumpsegmenter.h"
+#include "track.h"
+#include "trackcache.h"
+
+// Random counters used for each sample
+#define NOISE_COUNTERS 4
+
+class RealizeOutcome
+{
+public:
+    typedef AlarmRobustness::Outcome result_type;
+
+    RealizeOutcome(const AlarmRobustness *robustness) :
+        robustness(robustness)
+    {
+
+    }
+
+    AlarmRobustness::Outcome operator()(int realization) const
+    {
+        return robustness->realize(realization);
+    }
+
+private:
+    const AlarmRobustness *robustness;
+};
+
+AlarmRobustness::AlarmRobustness(
+        const Configuration &configuration,
+        const NoiseModel &model,
+        quint64 seed) :
+    configuration(configuration),
+    model(model),
+    seed(seed)
+{
+    // Only the start of each alarm or window is tracked
+    for (int i = 0; i < configuration.alarms.size(); ++i)
+    {
+        if (configuration.alarms[i].mode != Configuration::NoAlarm)
+        {
+            Key key;
+            key.type = AlarmEvaluator::AlarmTriggered;
+            key.index = i;
+            keys.append(key);
+        }
+
+        if (configuration.alarmWindowAbove > 0 || configuration.alarmWindowBelow > 0)
+        {
+            Key key;
+            key.type = AlarmEvaluator::AlarmWindowEntered;
+            key.index = i;
+            keys.append(key);
+        }
+    }
+
+    for (int i = 0; i < configuration.windows.size(); ++i)
+    {
+        const Configuration::Window &window = configuration.windows[i];
+        if (window.bottom < window.top)
+        {
+            Key key;
+            key.type = AlarmEvaluator::SilenceWindowEntered;
+            key.index = i;
+            keys.append(key);
+        }
+    }
+}
+
+void AlarmRobustness::addTrack(
+        const Track &track)
+{
+    JumpSegmenter segmenter;
+    TrackCache().segment(track, segmenter);
+
+    QVector< QPair< int, int > > ranges;
+    foreach (const JumpSegmenter::Jump &jump, segmenter.jumps())
+    {
+        ranges.append(qMakePair(jump.exit, JumpSegmenter::jumpEnd(jump, track)));
+    }
+
+    if (ranges.isEmpty())
+    {
+        ranges.append(qMakePair(0, track.size()));
+    }
+
+    AlarmEvaluator evaluator(configuration);
+
+    for (int r = 0; r < ranges.size(); ++r)
+    {
+        const int begin = ranges[r].first;
+        const int end = ranges[r].second;
+        if (begin >= end) continue;
+
+        Jump jump;
+        jump.time.reserve(end - begin);
+        jump.altitude.reserve(end - begin);
+
+        for (int i = begin; i < end; ++i)
+        {
+            jump.time.append(track.time[i]);
+            jump.altitude.append(track.hMSL[i] - configuration.groundElevation);
+        }
+
+        // Events without noise are the reference for each realization
+        AlarmEvaluator::Events events;
+        evaluator.reset();
+        for (int i = 0; i < jump.time.size(); ++i)
+        {
+            evaluator.process(i, jump.time[i], jump.altitude[i], events);
+        }
+        count(events, jump.count, jump.first);
+
+        jumps.append(jump);
+    }
+}
+
+QFuture< AlarmRobustness::Outcome > AlarmRobustness::run(
+        int realizations) const
+{
+    QVector< int > indices(realizations);
+    for (int i = 0; i < realizations; ++i)
+    {
+        indices[i] = i;
+    }
+
+    return QtConcurrent::mapped(indices, RealizeOutcome(this));
+}
+
+AlarmRobustness::Outcome AlarmRobustness::realize(
+        int realization) const
+{
+    Tally zero;
+    zero.triggered = 0;
+    zero.missed = 0;
+    zero.extra = 0;
+    zero.timed = 0;
+    zero.delaySum = 0;
+    zero.delaySquares = 0;
+
+    Outcome outcome(keys.size(), zero);
+
+    AlarmEvaluator evaluator(configuration);
+    AlarmEvaluator::Events events;
+    QVector< int > counts;
+    QVector< double > first;
+
+    const double sigma = model.altitudeSigma;
+    const double dropoutRate = model.dropoutRate / 60;
+
+    for (int j = 0; j < jumps.size(); ++j)
+    {
+        const Jump &jump = jumps[j];
+        const double *time = jump.time.constData();
+        const float *altitude = jump.altitude.constData();
+
+        // Streams depend only on the realization and jump
+        const CounterRng rng(seed, ((quint64) realization << 32) | (quint64) j);
+
+        evaluator.reset();
+        events.clear();
+
+        double error = sigma * rng.normal(0);
+        double outageEnd = -std::numeric_limits< double >::infinity();
+
+        for (int i = 0; i < jump.time.size(); ++i)
+        {
+            const quint64 counter = (quint64) i * NOISE_COUNTERS;
+            const double dt = (i > 0) ? time[i] - time[i - 1] : 0;
+
+            if (i > 0)
+            {
+                // First-order Gauss-Markov error keeps the same variance
+                // for any sample spacing
+                const double phi = (model.correlationTime > 0)
+                        ? qExp(-dt / model.correlationTime) : 0;
+                error = phi * error
+                        + sigma * qSqrt(1 - phi * phi) * rng.normal(counter / 2);
+            }
+
+            if (time[i] < outageEnd) continue;
+
+            if (dropoutRate > 0
+                    && rng.uniform(counter + 2) < 1 - qExp(-dropoutRate * dt))
+            {
+                outageEnd = time[i] + rng.exponential(counter + 3, model.dropoutLength);
+                continue;
+            }
+
+            evaluator.process(i, time[i], altitude[i] + error, events);
+        }
+
+        count(events, counts, first);
+
+        for (int k = 0; k < keys.size(); ++k)
+        {
+            Tally &tally = outcome[k];
+            const int reference = jump.count[k];
+
+            if (counts[k] > 0) ++tally.triggered;
+            if (reference > 0 && counts[k] == 0) ++tally.missed;
+            if (counts[k] > reference) tally.extra += counts[k] - reference;
+
+            if (reference > 0 && counts[k] > 0)
+            {
+                const double delay = first[k] - jump.first[k];
+                ++tally.timed;
+                tally.delaySum += delay;
+                tally.delaySquares += delay * delay;
+            }
+        }
+    }
+
+    return outcome;
+}
+
+QVector< AlarmRobustness::Statistics > AlarmRobustness::summarize(
+        const QList< Outcome > &outcomes) const
+{
+    QVector< Statistics > statistics;
+
+    for (int k = 0; k < keys.size(); ++k)
+    {
+        // Sums are taken in realization order so results do not depend
+        // on how the work was scheduled
+        Tally total;
+        total.triggered = 0;
+        total.missed = 0;
+        total.extra = 0;
+        total.timed = 0;
+        total.delaySum = 0;
+        total.delaySquares = 0;
+
+        foreach (const Outcome &outcome, outcomes)
+        {
+            const Tally &tally = outcome[k];
+            total.triggered += tally.triggered;
+            total.missed += tally.missed;
+            total.extra += tally.extra;
+            total.timed += tally.timed;
+            total.delaySum += tally.delaySum;
+            total.delaySquares += tally.delaySquares;
+        }
+
+        Statistics s;
+        s.type = keys[k].type;
+        s.index = keys[k].index;
+        s.trials = jumps.size() * outcomes.size();
+
+        s.reference = 0;
+        foreach (const Jump &jump, jumps)
+        {
+            if (jump.count[k] > 0) ++s.reference;
+        }
+
+        const int referenceTrials = s.reference * outcomes.size();
+
+        s.probability = (s.trials > 0) ? (double) total.triggered / s.trials : 0;
+        s.missedRate = (referenceTrials > 0) ? (double) total.missed / referenceTrials : 0;
+        s.extraRate = (s.trials > 0) ? (double) total.extra / s.trials : 0;
+
+        s.meanDelay = 0;
+        s.delaySpread = 0;
+        if (total.timed > 0)
+        {
+            s.meanDelay = total.delaySum / total.timed;
+            s.delaySpread = qSqrt(qMax(0.0, total.delaySquares / total.timed
+                                       - s.meanDelay * s.meanDelay));
+        }
+
+        statistics.append(s);
+    }
+
+    return statistics;
+}
+
+int AlarmRobustness::keyIndex(
+        const AlarmEvaluator::Event &event) const
+{
+    for (int k = 0; k < keys.size(); ++k)
+    {
+        if (keys[k].type == event.type && keys[k].index == event.index)
+        {
+            return k;
+        }
+    }
+    return -1;
+}
+
+void AlarmRobustness::count(
+        const AlarmEvaluator::Events &events,
+        QVector< int > &counts,
+        QVector< double > &first) const
+{
+    counts.fill(0, keys.size());
+    first.fill(0, keys.size());
+
+    foreach (const AlarmEvaluator::Event &event, events)
+    {
+        const int k = keyIndex(event);
+        if (k < 0) continue;
+
+        if (counts[k] == 0) first[k] = event.time;
+        ++counts[k];
+    }
+}
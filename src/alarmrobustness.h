@@ -0,0 +1,110 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef ALARMROBUSTNESS_H
+#define ALARMROBUSTNESS_H
+
+#include <QFuture>
+#include <QList>
+#include <QVector>
+
+#include "alarmevaluator.h"
+#include "configuration.h"
+
+class Track;
+
+// Estimates how reliably alarms and windows fire when the recorded
+// altitude is perturbed by GPS noise and dropouts
+class AlarmRobustness
+{
+public:
+    typedef struct {
+        double altitudeSigma;   // m, standard deviation of altitude error
+        double correlationTime; // s, zero for independent samples
+        double dropoutRate;     // Outages per minute
+        double dropoutLength;   // s, mean outage length
+    } NoiseModel;
+
+    // Event counts summed over jumps for one realization
+    typedef struct {
+        int triggered;          // Jumps where the event occurred
+        int missed;             // Jumps where it occurred only without noise
+        int extra;              // Occurrences beyond those without noise
+        int timed;              // Jumps contributing to the delay sums
+        double delaySum;        // s, first occurrence relative to no noise
+        double delaySquares;
+    } Tally;
+
+    typedef QVector< Tally > Outcome;
+
+    typedef struct {
+        AlarmEvaluator::EventType type;
+        int index;
+        int trials;             // Jumps times realizations
+        int reference;          // Jumps where the event occurs without noise
+        double probability;     // Fraction of trials where the event occurred
+        double missedRate;      // Fraction of reference trials missed
+        double extraRate;       // Extra occurrences per trial
+        double meanDelay;       // s
+        double delaySpread;     // s, standard deviation
+    } Statistics;
+
+    AlarmRobustness(const Configuration &configuration,
+                    const NoiseModel &model, quint64 seed);
+
+    // Adds each jump found in the track, or the whole track if none
+    void addTrack(const Track &track);
+    int jumpCount() const { return jumps.size(); }
+
+    // Realizations run on the global thread pool
+    QFuture< Outcome > run(int realizations) const;
+    Outcome realize(int realization) const;
+
+    QVector< Statistics > summarize(const QList< Outcome > &outcomes) const;
+
+private:
+    typedef struct {
+        AlarmEvaluator::EventType type;
+        int index;
+    } Key;
+
+    typedef struct {
+        QVector< double > time;
+        QVector< float > altitude;  // m above ground
+        QVector< int > count;       // Occurrences of each key without noise
+        QVector< double > first;    // s, first occurrence of each key
+    } Jump;
+
+    Configuration configuration;
+    NoiseModel model;
+    quint64 seed;
+
+    QVector< Key > keys;
+    QVector< Jump > jumps;
+
+    int keyIndex(const AlarmEvaluator::Event &event) const;
+    void count(const AlarmEvaluator::Events &events, QVector< int > &counts,
+               QVector< double > &first) const;
+};
+
+#endif // ALARMROBUSTNESS_H
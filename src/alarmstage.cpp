@@ -0,0 +1,51 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "alarmstage.h"
+
+AlarmStage::AlarmStage(
+        const Configuration &configuration) :
+    evaluator(configuration),
+    events(0)
+{
+
+}
+
+void AlarmStage::start(
+        Simulation &simulation,
+        const Track &track)
+{
+    Q_UNUSED(track);
+
+    evaluator.reset();
+
+    events = &simulation.alarms;
+    events->clear();
+}
+
+void AlarmStage::process(
+        SimulationSample &sample)
+{
+    evaluator.process(sample.index, sample.time, sample.altitude, *events);
+    sample.silenced = evaluator.isSilenced();
+}
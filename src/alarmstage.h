@@ -0,0 +1,45 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef ALARMSTAGE_H
+#define ALARMSTAGE_H
+
+#include "alarmevaluator.h"
+#include "configuration.h"
+#include "simulator.h"
+
+// Runs the alarm evaluator so later stages know when tones are silenced
+class AlarmStage : public SimulationStage
+{
+public:
+    explicit AlarmStage(const Configuration &configuration);
+
+    void start(Simulation &simulation, const Track &track);
+    void process(SimulationSample &sample);
+
+private:
+    AlarmEvaluator evaluator;
+    AlarmEvaluator::Events *events;
+};
+
+#endif // ALARMSTAGE_H
@@ -0,0 +1,72 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+#include "altitudedialog.h"
+#include "ui_altitudedialog.h"
+
+#include <QDir>
+#include <QFileInfo>
+
+#include "track.h"
+#include "trackcache.h"
+
+AltitudeDialog::AltitudeDialog(
+        const Configuration &configuration,
+        const QString &fileName,
+        QWidget *parent) :
+    QDialog(parent),
+    ui(new Ui::AltitudeDialog)
+{
+    ui->setupUi(this);
+
+    setWindowTitle(tr("Altitude Profile - %1").arg(QFileInfo(fileName).fileName()));
+
+    connect(ui->plot, SIGNAL(configurationDragged(Configuration)),
+            this, SIGNAL(configurationChanged(Configuration)));
+
+    ui->plot->setConfiguration(configuration);
+
+    Track track;
+    TrackCache cache;
+    if (!cache.load(fileName, track))
+    {
+        ui->statusLabel->setText(cache.errorString());
+        return;
+    }
+
+    ui->plot->setTrack(track.time, track.hMSL);
+
+    ui->statusLabel->setText(tr("%1 samples from %2. Drag an alarm or silence window to move it.")
+                             .arg(track.size())
+                             .arg(QDir::toNativeSeparators(fileName)));
+}
+
+AltitudeDialog::~AltitudeDialog()
+{
+    delete ui;
+}
+
+void AltitudeDialog::setConfiguration(
+        const Configuration &configuration)
+{
+    ui->plot->setConfiguration(configuration);
+}
@@ -0,0 +1,400 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+#include "altitudeplot.h"
+
+#include <QMouseEvent>
+#include <QPainter>
+#include <QPolygonF>
+#include <QtMath>
+
+#include <algorithm>
+
+// Space reserved for altitude and time labels
+#define ALTITUDE_AXIS_WIDTH 50
+#define TIME_AXIS_HEIGHT    20
+
+// How close the pointer must be to grab a band (px)
+#define HANDLE_DISTANCE 4
+
+AltitudePlot::AltitudePlot(
+        QWidget *parent) :
+    QWidget(parent),
+    minimum(0),
+    maximum(0),
+    trackLayerValid(false),
+    dragType(NoHandle),
+    dragIndex(-1)
+{
+    setMinimumSize(320, 240);
+    setMouseTracking(true);
+}
+
+void AltitudePlot::setTrack(
+        const TrackColumn< double > &newTime,
+        const TrackColumn< float > &newHMSL)
+{
+    time = newTime;
+    hMSL = newHMSL;
+
+    const int size = qMin(time.size(), hMSL.size());
+    pyramid.build(hMSL.constData(), size);
+
+    minimum = maximum = 0;
+    if (size > 0) pyramid.range(0, size, minimum, maximum);
+
+    // Leave a little room above and below the track
+    const float margin = qMax(0.05f * (maximum - minimum), 10.f);
+    minimum -= margin;
+    maximum += margin;
+
+    trackLayerValid = false;
+    update();
+}
+
+void AltitudePlot::setConfiguration(
+        const Configuration &configuration)
+{
+    // Edits arriving mid-drag would move the band out from under the
+    // pointer
+    if (dragType != NoHandle) return;
+
+    current = configuration;
+
+    // Only the bands depend on the configuration
+    update();
+}
+
+QRect AltitudePlot::plotRect() const
+{
+    return rect().adjusted(ALTITUDE_AXIS_WIDTH, 4, -4, -TIME_AXIS_HEIGHT);
+}
+
+double AltitudePlot::yAt(
+        double elevation) const
+{
+    const QRect plot = plotRect();
+    const double scale = plot.height() / qMax((double) (maximum - minimum), 1.);
+    return plot.bottom() - (current.groundElevation + elevation - minimum) * scale;
+}
+
+double AltitudePlot::elevationAt(
+        double y) const
+{
+    const QRect plot = plotRect();
+    const double scale = plot.height() / qMax((double) (maximum - minimum), 1.);
+    return minimum + (plot.bottom() - y) / scale - current.groundElevation;
+}
+
+void AltitudePlot::resizeEvent(
+        QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    trackLayerValid = false;
+}
+
+void AltitudePlot::drawTrack()
+{
+    trackLayer = QPixmap(size());
+    trackLayer.fill(palette().base().color());
+    trackLayerValid = true;
+
+    const int size = qMin(time.size(), hMSL.size());
+    if (size < 2) return;
+
+    QPainter painter(&trackLayer);
+
+    const QRect plot = plotRect();
+    const double *t = time.constData();
+    const float *h = hMSL.constData();
+
+    const double first = t[0];
+    const double span = qMax(t[size - 1] - first, 1e-3);
+    const double xScale = plot.width() / span;
+    const double yScale = plot.height() / qMax((double) (maximum - minimum), 1.);
+
+    // Time grid of 1, 2 or 5 times a power of ten, about 100 px apart
+    const double target = span * 100 / qMax(plot.width(), 1);
+    const double power = qPow(10, qFloor(log10(target)));
+
+    double step = power;
+    if (target > 5 * power) step = 10 * power;
+    else if (target > 2 * power) step = 5 * power;
+    else if (target > power) step = 2 * power;
+
+    for (double s = 0; s <= span; s += step)
+    {
+        const double x = plot.left() + s * xScale;
+
+        painter.setPen(palette().midlight().color());
+        painter.drawLine(QPointF(x, plot.top()), QPointF(x, plot.bottom()));
+
+        painter.setPen(palette().text().color());
+        painter.drawText(QRectF(x - 50, plot.bottom(), 100, TIME_AXIS_HEIGHT),
+                         Qt::AlignCenter, tr("%1 s").arg(s));
+    }
+
+    // Minimum and maximum of the samples under each pixel column
+    QPolygonF points;
+    const int columns = plot.width();
+    int begin = 0;
+    for (int x = 0; x < columns && begin < size; ++x)
+    {
+        const double edge = first + (x + 1) / xScale;
+        const int stop = (x + 1 < columns) ?
+                    std::lower_bound(t + begin, t + size, edge) - t : size;
+        if (stop == begin) continue;
+
+        float low, high;
+        if (stop - begin == 1)
+        {
+            low = high = h[begin];
+        }
+        else
+        {
+            pyramid.range(begin, stop, low, high);
+        }
+
+        const double px = plot.left() + x + 0.5;
+        points << QPointF(px, plot.bottom() - (high - minimum) * yScale)
+               << QPointF(px, plot.bottom() - (low - minimum) * yScale);
+
+        begin = stop;
+    }
+
+    painter.setClipRect(plot);
+    painter.setPen(palette().text().color());
+    painter.drawPolyline(points);
+}
+
+void AltitudePlot::drawBand(
+        QPainter &painter,
+        int bottom,
+        int top,
+        const QColor &color) const
+{
+    const QRect plot = plotRect();
+    const double y0 = yAt(top);
+    const double y1 = yAt(bottom);
+
+    painter.fillRect(QRectF(plot.left(), y0, plot.width(), y1 - y0), color);
+}
+
+void AltitudePlot::drawLine(
+        QPainter &painter,
+        int elevation,
+        const QColor &color,
+        const QString &label) const
+{
+    const QRect plot = plotRect();
+    const double y = yAt(elevation);
+
+    painter.setPen(color);
+    painter.drawLine(QPointF(plot.left(), y), QPointF(plot.right(), y));
+#if QT_VERSION >= QT_VERSION_CHECK(5, 11, 0)
+    const int labelWidth = fontMetrics().horizontalAdvance(label);
+#else
+    const int labelWidth = fontMetrics().width(label);
+#endif
+
+    painter.drawText(QPointF(plot.right() - labelWidth - 4,
+                             y - fontMetrics().descent() - 1),
+                     label);
+}
+
+void AltitudePlot::paintEvent(
+        QPaintEvent *event)
+{
+    Q_UNUSED(event);
+
+    if (!trackLayerValid) drawTrack();
+
+    QPainter painter(this);
+    painter.drawPixmap(0, 0, trackLayer);
+
+    if (time.isEmpty()) return;
+
+    const QRect plot = plotRect();
+    const QString units = current.distanceUnits();
+
+    // Altitude above ground moves with DZ_Elev, so its axis is drawn here
+    // rather than with the track
+    const double span = current.valueToDistanceUnits(maximum - minimum);
+    const double target = span * 40 / qMax(plot.height(), 1);
+    const double power = qPow(10, qFloor(log10(qMax(target, 1e-3))));
+
+    double step = power;
+    if (target > 5 * power) step = 10 * power;
+    else if (target > 2 * power) step = 5 * power;
+    else if (target > power) step = 2 * power;
+
+    const double low = current.valueToDistanceUnits(minimum - current.groundElevation);
+    const double high = current.valueToDistanceUnits(maximum - current.groundElevation);
+    for (double v = qCeil(low / step) * step; v <= high; v += step)
+    {
+        const double y = yAt(current.valueFromDistanceUnits(v));
+
+        painter.setPen(palette().text().color());
+        painter.drawText(QRectF(0, y - 10, ALTITUDE_AXIS_WIDTH - 4, 20),
+                         Qt::AlignRight | Qt::AlignVCenter, QString::number(v));
+    }
+
+    painter.setClipRect(plot);
+
+    // Silence windows
+    for (int i = 0; i < current.windows.size(); ++i)
+    {
+        const Configuration::Window &window = current.windows[i];
+        drawBand(painter, window.bottom, window.top, QColor(128, 128, 128, 48));
+        drawLine(painter, window.top, Qt::darkGray,
+                 tr("Silence %1 top: %2 %3").arg(i + 1)
+                 .arg(current.valueToDistanceUnits(window.top)).arg(units));
+        drawLine(painter, window.bottom, Qt::darkGray,
+                 tr("Silence %1 bottom: %2 %3").arg(i + 1)
+                 .arg(current.valueToDistanceUnits(window.bottom)).arg(units));
+    }
+
+    // Alarms and the window around each
+    for (int i = 0; i < current.alarms.size(); ++i)
+    {
+        const Configuration::Alarm &alarm = current.alarms[i];
+        if (current.alarmWindowAbove > 0 || current.alarmWindowBelow > 0)
+        {
+            drawBand(painter, alarm.elevation - current.alarmWindowBelow,
+                     alarm.elevation + current.alarmWindowAbove,
+                     QColor(255, 0, 0, 32));
+        }
+        drawLine(painter, alarm.elevation, Qt::red,
+                 tr("Alarm %1: %2 %3").arg(i + 1)
+                 .arg(current.valueToDistanceUnits(alarm.elevation)).arg(units));
+    }
+
+    drawLine(painter, 0, Qt::darkGreen, tr("Ground"));
+}
+
+int &AltitudePlot::handleValue(
+        HandleType type,
+        int index)
+{
+    switch (type)
+    {
+    case SilenceTopHandle:    return current.windows[index].top;
+    case SilenceBottomHandle: return current.windows[index].bottom;
+    default:                  return current.alarms[index].elevation;
+    }
+}
+
+bool AltitudePlot::findHandle(
+        int y,
+        HandleType &type,
+        int &index)
+{
+    double nearest = HANDLE_DISTANCE + 1;
+    type = NoHandle;
+
+    for (int i = 0; i < current.alarms.size(); ++i)
+    {
+        const double d = qAbs(yAt(current.alarms[i].elevation) - y);
+        if (d < nearest)
+        {
+            nearest = d;
+            type = AlarmHandle;
+            index = i;
+        }
+    }
+
+    for (int i = 0; i < current.windows.size(); ++i)
+    {
+        double d = qAbs(yAt(current.windows[i].top) - y);
+        if (d < nearest)
+        {
+            nearest = d;
+            type = SilenceTopHandle;
+            index = i;
+        }
+
+        d = qAbs(yAt(current.windows[i].bottom) - y);
+        if (d < nearest)
+        {
+            nearest = d;
+            type = SilenceBottomHandle;
+            index = i;
+        }
+    }
+
+    return type != NoHandle;
+}
+
+void AltitudePlot::mousePressEvent(
+        QMouseEvent *event)
+{
+    if (event->button() != Qt::LeftButton || time.isEmpty()) return;
+
+    findHandle(event->y(), dragType, dragIndex);
+}
+
+void AltitudePlot::mouseMoveEvent(
+        QMouseEvent *event)
+{
+    if (dragType == NoHandle)
+    {
+        // Show which bands can be grabbed
+        HandleType type;
+        int index;
+        if (findHandle(event->y(), type, index)) setCursor(Qt::SizeVerCursor);
+        else unsetCursor();
+        return;
+    }
+
+    // Snap to whole display units, as the forms show them
+    const double value = qRound(current.valueToDistanceUnits(qRound(elevationAt(event->y()))));
+    int elevation = current.valueFromDistanceUnits(value);
+
+    // Keep silence windows the right way up
+    if (dragType == SilenceTopHandle)
+    {
+        elevation = qMax(elevation, current.windows[dragIndex].bottom);
+    }
+    else if (dragType == SilenceBottomHandle)
+    {
+        elevation = qMin(elevation, current.windows[dragIndex].top);
+    }
+
+    int &target = handleValue(dragType, dragIndex);
+    if (target == elevation) return;
+
+    target = elevation;
+
+    // Repaints are coalesced to the display rate, and only redraw bands
+    update();
+}
+
+void AltitudePlot::mouseReleaseEvent(
+        QMouseEvent *event)
+{
+    if (event->button() != Qt::LeftButton || dragType == NoHandle) return;
+
+    dragType = NoHandle;
+    dragIndex = -1;
+
+    emit configurationDragged(current);
+}
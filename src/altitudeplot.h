@@ -0,0 +1,98 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+#ifndef ALTITUDEPLOT_H
+#define ALTITUDEPLOT_H
+
+#include <QPixmap>
+#include <QWidget>
+
+#include "configuration.h"
+#include "trackcolumn.h"
+#include "trackpyramid.h"
+
+// Plots altitude against time with the alarm elevations, alarm windows
+// and silence windows of a configuration drawn over it as bands. The
+// track is drawn once into a pixmap, so editing or dragging a band only
+// repaints the bands.
+class AltitudePlot : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit AltitudePlot(QWidget *parent = 0);
+
+    void setTrack(const TrackColumn< double > &time, const TrackColumn< float > &hMSL);
+
+    const Configuration &configuration() const { return current; }
+
+public slots:
+    void setConfiguration(const Configuration &configuration);
+
+signals:
+    // Sent when a band is dropped
+    void configurationDragged(const Configuration &configuration);
+
+protected:
+    void paintEvent(QPaintEvent *event);
+    void resizeEvent(QResizeEvent *event);
+    void mousePressEvent(QMouseEvent *event);
+    void mouseMoveEvent(QMouseEvent *event);
+    void mouseReleaseEvent(QMouseEvent *event);
+
+private:
+    typedef enum {
+        NoHandle = 0,
+        AlarmHandle,
+        SilenceTopHandle,
+        SilenceBottomHandle
+    } HandleType;
+
+    TrackColumn< double > time;
+    TrackColumn< float > hMSL;
+    TrackPyramid pyramid;
+
+    float minimum;      // hMSL range shown (m)
+    float maximum;
+
+    Configuration current;
+
+    QPixmap trackLayer;
+    bool trackLayerValid;
+
+    HandleType dragType;
+    int dragIndex;
+
+    QRect plotRect() const;
+    double yAt(double elevation) const;
+    double elevationAt(double y) const;
+
+    void drawTrack();
+    void drawBand(QPainter &painter, int bottom, int top, const QColor &color) const;
+    void drawLine(QPainter &painter, int elevation, const QColor &color,
+                  const QString &label) const;
+
+    int &handleValue(HandleType type, int index);
+    bool findHandle(int y, HandleType &type, int &index);
+};
+
+#endif // ALTITUDEPLOT_H
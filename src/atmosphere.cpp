@@ -0,0 +1,207 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "atmosphere.h"
+
+#include <QtGlobal>
+
+#include <cmath>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// Standard atmosphere
+#define ISA_T0          288.15      // Sea level temperature (K)
+#define ISA_LAPSE_RATE  0.0065      // Troposphere lapse rate (K/m)
+#define ISA_TROPOPAUSE  11000.      // Top of the troposphere (m)
+#define ISA_T11         216.65      // Stratosphere temperature (K)
+
+// Exponents for sqrt(rho / rho0), from g M / (R L) - 1 in the
+// troposphere and g M / (R T11) in the stratosphere
+#define ISA_TROPOSPHERE_EXPONENT    (4.25588 / 2)
+#define ISA_STRATOSPHERE_RATE       (1.57688e-4 / 2)
+
+#define ATMOSPHERE_SIZE \
+    ((ATMOSPHERE_MAX_ALTITUDE - ATMOSPHERE_MIN_ALTITUDE) / ATMOSPHERE_STEP + 1)
+
+namespace {
+
+// Series which converge over the range of the table. std::log and
+// std::exp are not constexpr.
+constexpr double lnTerms(double z2, double term, int n)
+{
+    return n > 41 ? 0 : term / n + lnTerms(z2, term * z2, n + 2);
+}
+
+constexpr double seriesLn(double x)
+{
+    return 2 * lnTerms(((x - 1) / (x + 1)) * ((x - 1) / (x + 1)), (x - 1) / (x + 1), 1);
+}
+
+constexpr double expTerms(double x, double term, int n)
+{
+    return n > 30 ? term : term + expTerms(x, term * x / n, n + 1);
+}
+
+constexpr double seriesExp(double x)
+{
+    return expTerms(x, 1, 1);
+}
+
+constexpr double factor(double h)
+{
+    return (h < ISA_TROPOPAUSE)
+            ? seriesExp(ISA_TROPOSPHERE_EXPONENT * seriesLn(1 - ISA_LAPSE_RATE * h / ISA_T0))
+            : seriesExp(ISA_TROPOSPHERE_EXPONENT * seriesLn(ISA_T11 / ISA_T0)
+                  - ISA_STRATOSPHERE_RATE * (h - ISA_TROPOPAUSE));
+}
+
+constexpr double tableAltitude(int i)
+{
+    return ATMOSPHERE_MIN_ALTITUDE + (double) i * ATMOSPHERE_STEP;
+}
+
+// Each entry holds the factor and the change to the next entry
+struct Entry
+{
+    float value;
+    float slope;
+};
+
+struct Table
+{
+    Entry entries[ATMOSPHERE_SIZE];
+};
+
+template< int... I > struct Indices {};
+template< int N, int... I > struct MakeIndices : MakeIndices< N - 1, N - 1, I... > {};
+template< int... I > struct MakeIndices< 0, I... > { typedef Indices< I... > Type; };
+
+constexpr Entry makeEntry(int i)
+{
+    return Entry {
+        (float) factor(tableAltitude(i)),
+        (i + 1 < ATMOSPHERE_SIZE)
+                ? (float) (factor(tableAltitude(i + 1)) - factor(tableAltitude(i)))
+                : 0.f
+    };
+}
+
+template< int... I >
+constexpr Table makeTable(Indices< I... >)
+{
+    return Table { { makeEntry(I)... } };
+}
+
+constexpr Table table = makeTable(MakeIndices< ATMOSPHERE_SIZE >::Type());
+
+static_assert(table.entries[(0 - ATMOSPHERE_MIN_ALTITUDE) / ATMOSPHERE_STEP].value == 1.f,
+              "Sea level factor must be exactly one");
+static_assert(table.entries[(11000 - ATMOSPHERE_MIN_ALTITUDE) / ATMOSPHERE_STEP].value > 0.544f
+              && table.entries[(11000 - ATMOSPHERE_MIN_ALTITUDE) / ATMOSPHERE_STEP].value < 0.546f,
+              "Tropopause density ratio should be about 0.297");
+
+} // namespace
+
+float Atmosphere::airspeedFactor(
+        float hMSL)
+{
+    // Speeds are left as they are without an altitude
+    if (hMSL != hMSL) return 1.f;
+
+    const float x = qBound(0.f,
+                           (hMSL - ATMOSPHERE_MIN_ALTITUDE) * (1.f / ATMOSPHERE_STEP),
+                           (float) (ATMOSPHERE_SIZE - 1));
+    const int i = (int) x;
+
+    const Entry &entry = table.entries[i];
+    return entry.value + (x - i) * entry.slope;
+}
+
+void Atmosphere::airspeedFactors(
+        const float *hMSL,
+        float *factors,
+        int count)
+{
+    int i = 0;
+
+#ifdef __SSE2__
+    const __m128 origin = _mm_set1_ps(ATMOSPHERE_MIN_ALTITUDE);
+    const __m128 scale = _mm_set1_ps(1.f / ATMOSPHERE_STEP);
+    const __m128 lower = _mm_setzero_ps();
+    const __m128 upper = _mm_set1_ps(ATMOSPHERE_SIZE - 1);
+    const __m128 one = _mm_set1_ps(1.f);
+
+    // Four samples at a time, with scalar table reads
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128 h = _mm_loadu_ps(hMSL + i);
+        const __m128 missing = _mm_cmpunord_ps(h, h);
+
+        // Clamping puts NaN at the bottom of the table, so the index is
+        // valid; its factor is replaced below
+        __m128 x = _mm_mul_ps(_mm_sub_ps(h, origin), scale);
+        x = _mm_min_ps(_mm_max_ps(x, lower), upper);
+
+        const __m128i index = _mm_cvttps_epi32(x);
+        const __m128 fraction = _mm_sub_ps(x, _mm_cvtepi32_ps(index));
+
+        int j[4];
+        _mm_storeu_si128((__m128i *) j, index);
+
+        const Entry &e0 = table.entries[j[0]];
+        const Entry &e1 = table.entries[j[1]];
+        const Entry &e2 = table.entries[j[2]];
+        const Entry &e3 = table.entries[j[3]];
+
+        const __m128 value = _mm_setr_ps(e0.value, e1.value, e2.value, e3.value);
+        const __m128 slope = _mm_setr_ps(e0.slope, e1.slope, e2.slope, e3.slope);
+
+        const __m128 factor = _mm_add_ps(value, _mm_mul_ps(fraction, slope));
+
+        // Same as the scalar path without an altitude
+        _mm_storeu_ps(factors + i, _mm_or_ps(_mm_and_ps(missing, one),
+                                             _mm_andnot_ps(missing, factor)));
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        factors[i] = airspeedFactor(hMSL[i]);
+    }
+}
+
+double Atmosphere::airspeedFactorDirect(
+        double hMSL)
+{
+    if (hMSL < ISA_TROPOPAUSE)
+    {
+        return pow(1 - ISA_LAPSE_RATE * hMSL / ISA_T0, ISA_TROPOSPHERE_EXPONENT);
+    }
+    else
+    {
+        return pow(ISA_T11 / ISA_T0, ISA_TROPOSPHERE_EXPONENT)
+                * std::exp(-ISA_STRATOSPHERE_RATE * (hMSL - ISA_TROPOPAUSE));
+    }
+}
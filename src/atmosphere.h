@@ -0,0 +1,47 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef ATMOSPHERE_H
+#define ATMOSPHERE_H
+
+// Altitudes covered by the lookup table, in m above MSL
+#define ATMOSPHERE_MIN_ALTITUDE -1000
+#define ATMOSPHERE_MAX_ALTITUDE 20000
+#define ATMOSPHERE_STEP         100
+
+// International Standard Atmosphere, used for the skydiver's airspeed
+// (Use_SAS) correction. Speeds are scaled by sqrt(rho / rho0), giving
+// the speed which would produce the same drag at sea level.
+class Atmosphere
+{
+public:
+    // Interpolated from a table built at compile time. A NaN altitude
+    // gives a factor of one.
+    static float airspeedFactor(float hMSL);
+    static void airspeedFactors(const float *hMSL, float *factors, int count);
+
+    // Evaluates the model directly, for reference
+    static double airspeedFactorDirect(double hMSL);
+};
+
+#endif // ATMOSPHERE_H
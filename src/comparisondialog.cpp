@@ -0,0 +1,329 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "comparisondialog.h"
+#include "ui_comparisondialog.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QMap>
+#include <QPair>
+#include <QTreeWidgetItem>
+
+#include <algorithm>
+#include <cmath>
+
+#include "configurationfile.h"
+#include "track.h"
+#include "trackcache.h"
+
+typedef struct {
+    double time;
+    AlarmEvaluator::EventType type;
+    int index;
+    const AlarmEvaluator::Event *a;
+    const AlarmEvaluator::Event *b;
+} EventRow;
+
+static bool rowLessThan(
+        const EventRow &first,
+        const EventRow &second)
+{
+    return first.time < second.time;
+}
+
+// Values of another simulation at each time, held from the sample at or
+// before it, as the tone would be when the rates differ
+static QVector< float > alignValues(
+        const TrackColumn< double > &time,
+        const TrackColumn< double > &otherTime,
+        const QVector< float > &values,
+        float scale)
+{
+    QVector< float > aligned(time.size());
+
+    int j = 0;
+    for (int i = 0; i < time.size(); ++i)
+    {
+        while (j + 1 < otherTime.size() && otherTime[j + 1] <= time[i]) ++j;
+
+        aligned[i] = (j < otherTime.size() && otherTime[j] <= time[i])
+                ? values[j] * scale : 0;
+    }
+
+    return aligned;
+}
+
+ComparisonDialog::ComparisonDialog(
+        const Configuration &configuration,
+        const QString &trackFileName,
+        const QStringList &fileNames,
+        QWidget *parent) :
+    QDialog(parent),
+    ui(new Ui::ComparisonDialog)
+{
+    ui->setupUi(this);
+
+    setWindowTitle(tr("Compare Configurations - %1").arg(QFileInfo(trackFileName).fileName()));
+
+    configurations.append(configuration);
+
+    QStringList failed;
+    foreach (const QString &fileName, fileNames)
+    {
+        Configuration other(configuration.displayUnits);
+        if (!ConfigurationFile::load(fileName, other))
+        {
+            failed.append(QDir::toNativeSeparators(fileName));
+            continue;
+        }
+
+        configurations.append(other);
+        ui->otherComboBox->addItem(QFileInfo(fileName).fileName());
+        ui->otherComboBox->setItemData(ui->otherComboBox->count() - 1,
+                                       QDir::toNativeSeparators(fileName), Qt::ToolTipRole);
+    }
+
+    if (!failed.isEmpty())
+    {
+        errors = tr("Couldn't read %1.").arg(failed.join(", "));
+    }
+
+    Track track;
+    TrackCache cache;
+    if (!cache.load(trackFileName, track))
+    {
+        ui->statusLabel->setText(cache.errorString());
+        return;
+    }
+
+    comparison.setTrack(track);
+    simulate();
+}
+
+ComparisonDialog::~ComparisonDialog()
+{
+    delete ui;
+}
+
+void ComparisonDialog::setConfiguration(
+        const Configuration &configuration)
+{
+    configurations[0] = configuration;
+
+    // Configurations from files show distances in the same units
+    for (int i = 1; i < configurations.size(); ++i)
+    {
+        configurations[i].displayUnits = configuration.displayUnits;
+    }
+
+    simulate();
+}
+
+void ComparisonDialog::on_otherComboBox_activated(
+        int index)
+{
+    Q_UNUSED(index);
+
+    plot();
+    listEvents();
+}
+
+void ComparisonDialog::on_eventTree_itemClicked(
+        QTreeWidgetItem *item)
+{
+    // Centre the plot on the event, keeping the zoom
+    const double time = item->data(0, Qt::UserRole).toDouble();
+    const double span = ui->plot->endTime() - ui->plot->startTime();
+    ui->plot->setTimeRange(time - span / 2, time + span / 2);
+}
+
+void ComparisonDialog::simulate()
+{
+    if (configurations.size() < 2)
+    {
+        ui->statusLabel->setText(errors.isEmpty() ? tr("No configurations to compare with.") : errors);
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    comparison.run(configurations);
+
+    const qint64 nsecs = timer.nsecsElapsed();
+
+    plot();
+    listEvents();
+
+    QString status = tr("Ran %1 of %2 stages for %3 configurations, %4 cached, in %5 ms.")
+            .arg(comparison.stageRuns())
+            .arg(comparison.separateRuns())
+            .arg(configurations.size())
+            .arg(comparison.cacheHits())
+            .arg(nsecs / 1e6, 0, 'f', 1);
+    if (!errors.isEmpty()) status += " " + errors;
+
+    ui->statusLabel->setText(status);
+}
+
+void ComparisonDialog::plot()
+{
+    const int other = ui->otherComboBox->currentIndex() + 1;
+    if (other < 1 || other >= comparison.size()) return;
+
+    // Both are shown on the time axis of A
+    const Track &track = comparison.track(0);
+    const Simulation &a = comparison.simulation(0);
+    const Simulation &b = comparison.simulation(other);
+    const TrackColumn< double > &otherTime = comparison.track(other).time;
+
+    const QVector< float > pitchA = alignValues(track.time, track.time, a.pitch, 100);
+    const QVector< float > pitchB = alignValues(track.time, otherTime, b.pitch, 100);
+    const QVector< float > rateB = alignValues(track.time, otherTime, b.rate, 1);
+
+    QVector< float > difference(pitchA.size());
+    for (int i = 0; i < difference.size(); ++i)
+    {
+        difference[i] = pitchB[i] - pitchA[i];
+    }
+
+    // Keep the time range the user is looking at
+    const bool hadTime = ui->plot->endTime() > ui->plot->startTime();
+    const double start = ui->plot->startTime();
+    const double end = ui->plot->endTime();
+
+    ui->plot->clearSeries();
+    ui->plot->setTime(track.time);
+
+    ui->plot->addSeries(tr("Tone A (%)"), TrackColumn< float >(pitchA), Qt::blue, 0);
+    ui->plot->addSeries(tr("Tone B (%)"), TrackColumn< float >(pitchB), Qt::red, 0);
+    ui->plot->addSeries(tr("Rate A (Hz)"), TrackColumn< float >(a.rate), Qt::blue, 1);
+    ui->plot->addSeries(tr("Rate B (Hz)"), TrackColumn< float >(rateB), Qt::red, 1);
+    ui->plot->addSeries(tr("Tone B - A (%)"), TrackColumn< float >(difference), Qt::darkGreen, 2);
+
+    if (hadTime) ui->plot->setTimeRange(start, end);
+}
+
+void ComparisonDialog::listEvents()
+{
+    ui->eventTree->clear();
+
+    const int other = ui->otherComboBox->currentIndex() + 1;
+    if (other < 1 || other >= comparison.size()) return;
+
+    // Pair the nth crossing of each alarm or window in A with the nth in B
+    typedef QPair< int, int > Key;
+    QMap< Key, QVector< const AlarmEvaluator::Event * > > eventsA, eventsB;
+
+    const AlarmEvaluator::Events &alarmsA = comparison.simulation(0).alarms;
+    for (int i = 0; i < alarmsA.size(); ++i)
+    {
+        eventsA[qMakePair((int) alarmsA[i].type, alarmsA[i].index)].append(&alarmsA[i]);
+    }
+
+    const AlarmEvaluator::Events &alarmsB = comparison.simulation(other).alarms;
+    for (int i = 0; i < alarmsB.size(); ++i)
+    {
+        eventsB[qMakePair((int) alarmsB[i].type, alarmsB[i].index)].append(&alarmsB[i]);
+    }
+
+    QList< Key > keys = eventsA.keys() + eventsB.keys();
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+    QVector< EventRow > rows;
+    foreach (const Key &key, keys)
+    {
+        const QVector< const AlarmEvaluator::Event * > a = eventsA.value(key);
+        const QVector< const AlarmEvaluator::Event * > b = eventsB.value(key);
+
+        for (int i = 0; i < qMax(a.size(), b.size()); ++i)
+        {
+            EventRow row;
+            row.type = (AlarmEvaluator::EventType) key.first;
+            row.index = key.second;
+            row.a = (i < a.size()) ? a[i] : 0;
+            row.b = (i < b.size()) ? b[i] : 0;
+            row.time = row.a ? row.a->time : row.b->time;
+            rows.append(row);
+        }
+    }
+
+    std::sort(rows.begin(), rows.end(), rowLessThan);
+
+    const Configuration &configuration = configurations[0];
+    const QString units = configuration.distanceUnits();
+
+    int changed = 0;
+    foreach (const EventRow &row, rows)
+    {
+        QTreeWidgetItem *item = new QTreeWidgetItem(ui->eventTree);
+        item->setData(0, Qt::UserRole, row.time);
+
+        const QDateTime time = QDateTime::fromMSecsSinceEpoch(
+                    qRound64(row.time * 1000), Qt::UTC);
+        item->setText(0, time.toString("hh:mm:ss.zzz"));
+        item->setText(1, QString("%1 %2")
+                      .arg(AlarmEvaluator::eventName(row.type))
+                      .arg(row.index + 1));
+
+        if (row.a)
+        {
+            item->setText(2, QString("%1 %2")
+                          .arg(configuration.valueToDistanceUnits(qRound(row.a->altitude)))
+                          .arg(units));
+        }
+        if (row.b)
+        {
+            item->setText(3, QString("%1 %2")
+                          .arg(configuration.valueToDistanceUnits(qRound(row.b->altitude)))
+                          .arg(units));
+        }
+
+        if (!row.b)
+        {
+            item->setText(4, tr("Only in A"));
+            ++changed;
+        }
+        else if (!row.a)
+        {
+            item->setText(4, tr("Only in B"));
+            ++changed;
+        }
+        else if (row.a->sample != row.b->sample || row.a->time != row.b->time)
+        {
+            item->setText(4, tr("Moved %1 s").arg(row.b->time - row.a->time, 0, 'f', 2));
+            ++changed;
+        }
+    }
+
+    ui->eventTree->setHeaderLabels(QStringList()
+                                   << tr("Time")
+                                   << tr("Event")
+                                   << tr("A")
+                                   << tr("B")
+                                   << tr("%n change(s)", 0, changed));
+}
@@ -0,0 +1,74 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef COMPARISONDIALOG_H
+#define COMPARISONDIALOG_H
+
+#include <QDialog>
+#include <QStringList>
+#include <QVector>
+
+#include "configuration.h"
+#include "simulationcomparison.h"
+
+class QTreeWidgetItem;
+
+namespace Ui {
+class ComparisonDialog;
+}
+
+// Tone, rate and alarms of the configuration being edited (A) against
+// configurations read from files (B), on one track and one time axis
+class ComparisonDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit ComparisonDialog(const Configuration &configuration,
+                              const QString &trackFileName,
+                              const QStringList &fileNames,
+                              QWidget *parent = 0);
+    ~ComparisonDialog();
+
+public slots:
+    void setConfiguration(const Configuration &configuration);
+
+private slots:
+    void on_otherComboBox_activated(int index);
+    void on_eventTree_itemClicked(QTreeWidgetItem *item);
+
+private:
+    Ui::ComparisonDialog *ui;
+
+    // Configuration being edited first, then those read from files
+    QVector< Configuration > configurations;
+    SimulationComparison comparison;
+
+    QString errors;
+
+    void simulate();
+    void plot();
+    void listEvents();
+};
+
+#endif // COMPARISONDIALOG_H
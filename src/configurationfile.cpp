@@ -0,0 +1,301 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+#include "configurationfile.h"
+
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QObject>
+#include <QSaveFile>
+#include <QTextStream>
+
+#include "trackreader.h"
+
+#define MAX_ALARMS   10
+#define MAX_WINDOWS  2
+#define MAX_SPEECHES 3
+
+bool ConfigurationFile::load(
+        const QString &fileName,
+        Configuration &configuration)
+{
+    Settings settings;
+    if (!readSettings(fileName, settings)) return false;
+
+    // Reset configuration but keep units
+    configuration = Configuration(configuration.displayUnits);
+
+    foreach (const Setting &setting, settings)
+    {
+        applySetting(setting.first, setting.second, configuration);
+    }
+
+    return true;
+}
+
+bool ConfigurationFile::readSettings(
+        const QString &fileName,
+        Settings &settings)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) return false;
+
+    settings.clear();
+
+    QTextStream in(&file);
+    while (!in.atEnd())
+    {
+        QString line = in.readLine();
+
+        // Remove comments
+        line = line.left(line.indexOf(';'));
+
+        // Split into key/value
+        const int colon = line.indexOf(':');
+        if (colon < 0) continue;
+
+        const QString name = line.left(colon).trimmed();
+        QString value = line.mid(colon + 1);
+
+        // A profile's parent may be an absolute path with a drive letter,
+        // so only other values end at the next colon
+        if (name != "Parent") value = value.section(':', 0, 0);
+
+        settings.append(qMakePair(name, value.trimmed()));
+    }
+
+    return true;
+}
+
+void ConfigurationFile::applySetting(
+        const QString &name,
+        const QString &result,
+        Configuration &configuration)
+{
+    const int val = result.toInt();
+
+#define HANDLE_VALUE(s,w,t)\
+if (!name.compare(s)) { (w) = (t) (val); }
+
+    HANDLE_VALUE("Model", configuration.model, Configuration::Model);
+    HANDLE_VALUE("Rate", configuration.rate, int);
+
+    HANDLE_VALUE("Mode", configuration.toneMode, Configuration::Mode);
+    HANDLE_VALUE("Min", configuration.minTone, int);
+    HANDLE_VALUE("Max", configuration.maxTone, int);
+    HANDLE_VALUE("Limits", configuration.limits, Configuration::Limits);
+    HANDLE_VALUE("Volume", configuration.toneVolume, int);
+
+    HANDLE_VALUE("Mode_2", configuration.rateMode, Configuration::Mode);
+    HANDLE_VALUE("Min_Val_2", configuration.minRateValue, int);
+    HANDLE_VALUE("Max_Val_2", configuration.maxRateValue, int);
+    HANDLE_VALUE("Min_Rate", configuration.minRate, int);
+    HANDLE_VALUE("Max_Rate", configuration.maxRate, int);
+    HANDLE_VALUE("Flatline", configuration.flatline, bool);
+
+    HANDLE_VALUE("Sp_Rate", configuration.speechRate, int);
+    HANDLE_VALUE("Sp_Volume", configuration.speechVolume, int);
+
+    HANDLE_VALUE("V_Thresh", configuration.vThreshold, int);
+    HANDLE_VALUE("H_Thresh", configuration.hThreshold, int);
+
+    HANDLE_VALUE("Use_SAS", configuration.adjustSpeed, bool);
+    HANDLE_VALUE("TZ_Offset", configuration.timeZoneOffset, int);
+
+    HANDLE_VALUE("Init_Mode", configuration.initMode, Configuration::InitMode);
+
+    HANDLE_VALUE("Alt_Units", configuration.altitudeUnits, Configuration::AltitudeUnits);
+    HANDLE_VALUE("Alt_Step", configuration.altitudeStep, int);
+
+    HANDLE_VALUE("Window", configuration.alarmWindowAbove, int);
+    HANDLE_VALUE("Window", configuration.alarmWindowBelow, int);
+    HANDLE_VALUE("Win_Above", configuration.alarmWindowAbove, int);
+    HANDLE_VALUE("Win_Below", configuration.alarmWindowBelow, int);
+    HANDLE_VALUE("DZ_Elev", configuration.groundElevation, int);
+
+#undef HANDLE_VALUE
+
+    if (!name.compare("Config_Name"))
+    {
+        configuration.configName = result;
+    }
+    if (!name.compare("Config_Description"))
+    {
+        configuration.configDescription = result;
+    }
+    if (!name.compare("Config_Kind"))
+    {
+        configuration.configKind = result;
+    }
+
+    if (!name.compare("Init_File"))
+    {
+        configuration.initFile = result;
+    }
+
+    if (!name.compare("Alarm_Elev") && configuration.alarms.length() < MAX_ALARMS)
+    {
+        Configuration::Alarm alarm;
+        alarm.elevation = val;
+        alarm.mode = Configuration::NoAlarm;
+        alarm.file = QString();
+        configuration.alarms.push_back(alarm);
+    }
+    if (!name.compare("Alarm_Type") && !configuration.alarms.isEmpty())
+    {
+        configuration.alarms.back().mode = (Configuration::AlarmMode) val;
+    }
+    if (!name.compare("Alarm_File") && !configuration.alarms.isEmpty())
+    {
+        configuration.alarms.back().file = result;
+    }
+
+    if (!name.compare("Win_Top") && configuration.windows.length() < MAX_WINDOWS)
+    {
+        Configuration::Window window;
+        window.top = val;
+        window.bottom = val;
+        configuration.windows.push_back(window);
+    }
+    if (!name.compare("Win_Bottom") && !configuration.windows.isEmpty())
+    {
+        configuration.windows.back().bottom = val;
+    }
+
+    if (!name.compare("Sp_Mode") && configuration.speeches.length() < MAX_SPEECHES)
+    {
+        Configuration::Speech speech;
+        speech.mode = (Configuration::Mode) val;
+        speech.units = Configuration::Miles;
+        speech.decimals = 1;
+        configuration.speeches.push_back(speech);
+    }
+    if (!name.compare("Sp_Units") && !configuration.speeches.isEmpty())
+    {
+        configuration.speeches.back().units = (Configuration::Units) val;
+    }
+    if (!name.compare("Sp_Dec") && !configuration.speeches.isEmpty())
+    {
+        configuration.speeches.back().decimals = (int) val;
+    }
+}
+
+QStringList ConfigurationFile::find(
+        const QString &folder)
+{
+    QStringList fileNames;
+
+    QDirIterator it(folder, QStringList() << "*.txt",
+                    QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext())
+    {
+        fileNames.append(it.next());
+    }
+
+    fileNames.sort();
+    return fileNames;
+}
+
+QString ConfigurationFile::latestTrack(
+        const QString &fileName)
+{
+    // Logs are named by date and time, so the last is the latest
+    const QStringList tracks = TrackReader::findTracks(
+                QFileInfo(fileName).absolutePath());
+    return tracks.isEmpty() ? QString() : tracks.last();
+}
+
+bool ConfigurationFile::setValue(
+        const QString &fileName,
+        const QString &name,
+        int value,
+        QString &error)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        error = file.errorString();
+        return false;
+    }
+
+    QStringList lines;
+    QTextStream in(&file);
+    while (!in.atEnd())
+    {
+        lines.append(in.readLine());
+    }
+    file.close();
+
+    const QString number = QString::number(value);
+    bool found = false;
+
+    for (int i = 0; i < lines.size(); ++i)
+    {
+        const QString &line = lines[i];
+
+        // Same parsing as readSettings
+        const int end = line.indexOf(';') < 0 ? line.length() : line.indexOf(';');
+        const int colon = line.indexOf(':');
+        if (colon < 0 || colon >= end) continue;
+        if (line.left(colon).trimmed() != name) continue;
+
+        // Keep the value right-aligned in the space it had, so the
+        // comment stays where it was
+        int last = end;
+        while (last > colon + 1 && line[last - 1].isSpace()) --last;
+
+        QString replacement = number.rightJustified(last - colon - 1);
+        if (replacement.length() == number.length()) replacement = " " + number;
+
+        lines[i] = line.left(colon + 1) + replacement + line.mid(last);
+        found = true;
+    }
+
+    if (!found)
+    {
+        error = QObject::tr("No %1 setting").arg(name);
+        return false;
+    }
+
+    QSaveFile out(fileName);
+    if (!out.open(QIODevice::WriteOnly | QIODevice::Text))
+    {
+        error = out.errorString();
+        return false;
+    }
+
+    QTextStream stream(&out);
+    foreach (const QString &line, lines)
+    {
+        stream << line << endl;
+    }
+    stream.flush();
+
+    if (!out.commit())
+    {
+        error = out.errorString();
+        return false;
+    }
+
+    return true;
+}
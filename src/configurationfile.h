@@ -0,0 +1,69 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+#ifndef CONFIGURATIONFILE_H
+#define CONFIGURATIONFILE_H
+
+#include <QPair>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "configuration.h"
+
+// Reading of configuration files, and edits on disk which leave
+// everything but the edited setting as the user wrote it
+class ConfigurationFile
+{
+public:
+    // Setting name and value, as written in the file
+    typedef QPair< QString, QString > Setting;
+    typedef QVector< Setting > Settings;
+
+    // Reads the settings in a file. The configuration is reset first,
+    // keeping only its display units.
+    static bool load(const QString &fileName, Configuration &configuration);
+
+    // Settings in file order, without comments
+    static bool readSettings(const QString &fileName, Settings &settings);
+
+    // Applies one setting. Alarm, window and speech details apply to the
+    // last one added; unknown names are ignored.
+    static void applySetting(const QString &name, const QString &value,
+                             Configuration &configuration);
+
+    // Configuration files anywhere below the folder
+    static QStringList find(const QString &folder);
+
+    // Latest track in the folder tree of a configuration, which on a
+    // FlySight card is the last one logged with it
+    static QString latestTrack(const QString &fileName);
+
+    // Replaces the value of a setting, keeping its comment and alignment.
+    // Files without the setting are left alone, so other text files in a
+    // library aren't touched. The file is replaced only once the new
+    // contents are safely written.
+    static bool setValue(const QString &fileName, const QString &name,
+                         int value, QString &error);
+};
+
+#endif // CONFIGURATIONFILE_H
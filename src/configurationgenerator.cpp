@@ -0,0 +1,268 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "configurationgenerator.h"
+
+#include <QDir>
+#include <QFile>
+#include <QHash>
+#include <QObject>
+#include <QPair>
+#include <QTextStream>
+#include <QtConcurrent>
+
+#include "configurationprofiles.h"
+#include "configurationwriter.h"
+
+#define GENERATOR_CHUNK 64          // Variants written per task
+
+typedef QPair< int, int > Chunk;
+
+class GenerateChunk
+{
+public:
+    typedef ConfigurationGenerator::Result result_type;
+
+    GenerateChunk(const ConfigurationGenerator::Variants &variants,
+                  const Configuration &base, const QString &folder) :
+        variants(variants), base(base), folder(folder) {}
+
+    ConfigurationGenerator::Result operator()(const Chunk &chunk) const
+    {
+        return ConfigurationGenerator::generate(variants, chunk.first, chunk.second,
+                                                base, folder);
+    }
+
+private:
+    ConfigurationGenerator::Variants variants;
+    Configuration base;
+    QString folder;
+};
+
+// Splits a CSV row, allowing quoted cells with commas and doubled quotes
+static QStringList splitRow(
+        const QString &line)
+{
+    QStringList cells;
+    QString cell;
+    bool quoted = false;
+
+    for (int i = 0; i < line.length(); ++i)
+    {
+        const QChar c = line[i];
+        if (quoted)
+        {
+            if (c != '"')
+            {
+                cell += c;
+            }
+            else if (i + 1 < line.length() && line[i + 1] == '"')
+            {
+                cell += c;
+                ++i;
+            }
+            else
+            {
+                quoted = false;
+            }
+        }
+        else if (c == '"')
+        {
+            quoted = true;
+        }
+        else if (c == ',')
+        {
+            cells.append(cell.trimmed());
+            cell.clear();
+        }
+        else
+        {
+            cell += c;
+        }
+    }
+    cells.append(cell.trimmed());
+
+    return cells;
+}
+
+bool ConfigurationGenerator::readTable(
+        const QString &fileName,
+        Variants &variants,
+        QString &error)
+{
+    variants.clear();
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        error = file.errorString();
+        return false;
+    }
+
+    QTextStream in(&file);
+
+    QStringList names;
+    while (!in.atEnd() && names.isEmpty())
+    {
+        const QString line = in.readLine();
+        if (!line.trimmed().isEmpty()) names = splitRow(line);
+    }
+
+    if (names.isEmpty())
+    {
+        error = QObject::tr("The table has no header row.");
+        return false;
+    }
+
+    const int folderColumn = names.indexOf("Folder");
+
+    // File line of each variant, for errors
+    QVector< int > lines;
+    int lineNumber = 1;
+
+    while (!in.atEnd())
+    {
+        const QString line = in.readLine();
+        ++lineNumber;
+        if (line.trimmed().isEmpty()) continue;
+
+        const QStringList cells = splitRow(line);
+
+        Variant variant;
+        for (int i = 0; i < cells.size() && i < names.size(); ++i)
+        {
+            if (i == folderColumn)
+            {
+                variant.folder = cells[i];
+            }
+            else if (!cells[i].isEmpty() && !names[i].isEmpty())
+            {
+                variant.overrides.append(qMakePair(names[i], cells[i]));
+            }
+        }
+        variants.append(variant);
+        lines.append(lineNumber);
+    }
+
+    // Rows without a folder are numbered, padded so they sort in order
+    const int digits = QString::number(variants.size()).length();
+
+    // Folders compare without case, as on Windows and macOS file systems
+    QHash< QString, int > folders;
+    QStringList errors;
+
+    for (int i = 0; i < variants.size(); ++i)
+    {
+        QString &folder = variants[i].folder;
+        if (folder.isEmpty())
+        {
+            folder = QString("%1").arg(i + 1, digits, 10, QChar('0'));
+        }
+
+        // Each file must stay inside the output folder
+        folder = QDir::cleanPath(QDir::fromNativeSeparators(folder));
+        if (QDir::isAbsolutePath(folder) || folder.startsWith('/')
+                || folder.contains(':') || folder == "."
+                || folder == ".." || folder.startsWith("../"))
+        {
+            errors.append(QObject::tr("Line %1: Folder %2 is not inside the output folder.")
+                          .arg(lines[i]).arg(folder));
+            continue;
+        }
+
+        const QString key = folder.toLower();
+        if (folders.contains(key))
+        {
+            errors.append(QObject::tr("Line %1: Folder %2 is also used on line %3.")
+                          .arg(lines[i]).arg(folder).arg(lines[folders.value(key)]));
+            continue;
+        }
+        folders.insert(key, i);
+    }
+
+    if (!errors.isEmpty())
+    {
+        error = errors.join("\n");
+        variants.clear();
+        return false;
+    }
+
+    return true;
+}
+
+QFuture< ConfigurationGenerator::Result > ConfigurationGenerator::generate(
+        const Variants &variants,
+        const Configuration &base,
+        const QString &folder)
+{
+    QVector< Chunk > chunks;
+    for (int first = 0; first < variants.size(); first += GENERATOR_CHUNK)
+    {
+        chunks.append(Chunk(first, qMin(first + GENERATOR_CHUNK, variants.size())));
+    }
+
+    return QtConcurrent::mapped(chunks, GenerateChunk(variants, base, folder));
+}
+
+ConfigurationGenerator::Result ConfigurationGenerator::generate(
+        const Variants &variants,
+        int first,
+        int last,
+        const Configuration &base,
+        const QString &folder)
+{
+    Result result;
+    result.written = 0;
+
+    const QDir dir(folder);
+    ConfigurationWriter writer;
+
+    for (int i = first; i < last; ++i)
+    {
+        const Variant &variant = variants[i];
+
+        Configuration configuration = base;
+        ConfigurationProfiles::apply(variant.overrides, configuration);
+
+        const QString path = dir.filePath(variant.folder);
+        if (!dir.mkpath(variant.folder))
+        {
+            result.errors.append(QObject::tr("%1: Couldn't create folder")
+                                 .arg(QDir::toNativeSeparators(path)));
+            continue;
+        }
+
+        const QString fileName = QDir(path).filePath("config.txt");
+        if (writer.save(fileName, configuration))
+        {
+            ++result.written;
+        }
+        else
+        {
+            result.errors.append(QObject::tr("%1: Couldn't write file")
+                                 .arg(QDir::toNativeSeparators(fileName)));
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,70 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef CONFIGURATIONGENERATOR_H
+#define CONFIGURATIONGENERATOR_H
+
+#include <QFuture>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "configuration.h"
+#include "configurationfile.h"
+
+// Writes variants of a base configuration, one config.txt per row of a
+// table of overrides. Rows are split into chunks which are written on
+// the global thread pool, each chunk reusing one writer's buffer.
+class ConfigurationGenerator
+{
+public:
+    typedef struct {
+        QString folder;             // Relative to the output folder
+        ConfigurationFile::Settings overrides;
+    } Variant;
+
+    typedef QVector< Variant > Variants;
+
+    typedef struct {
+        int written;
+        QStringList errors;
+    } Result;
+
+    // Reads a CSV table whose first row names the settings. A name may
+    // be repeated, so a row can give several alarms, windows or speech,
+    // and empty cells leave the base value. A Folder column names the
+    // folder each variant is written to; without one, rows are numbered.
+    // Folders outside the output folder, or used twice, are errors.
+    static bool readTable(const QString &fileName, Variants &variants,
+                          QString &error);
+
+    // Progress is reported in chunks. Variants must name distinct folders
+    // inside the output folder, as readTable ensures.
+    static QFuture< Result > generate(const Variants &variants,
+                                      const Configuration &base,
+                                      const QString &folder);
+    static Result generate(const Variants &variants, int first, int last,
+                           const Configuration &base, const QString &folder);
+};
+
+#endif // CONFIGURATIONGENERATOR_H
@@ -49,6 +49,9 @@ public:
 signals:
     void selectionChanged();
 
+    // Values set by the page itself, as opposed to typed by the user
+    void valuesEdited();
+
 public slots:
 };
 
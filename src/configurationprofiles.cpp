@@ -0,0 +1,215 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "configurationprofiles.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QObject>
+#include <QStringList>
+
+// Setting which names a profile's parent
+#define PROFILE_PARENT "Parent"
+
+ConfigurationProfiles::ConfigurationProfiles(
+        Configuration::DisplayUnits units) :
+    displayUnits(units),
+    revisionCount(0),
+    resolveCount(0)
+{
+
+}
+
+int ConfigurationProfiles::add(
+        const QString &name,
+        int parent,
+        const ConfigurationFile::Settings &overrides)
+{
+    Profile profile;
+    profile.name = name;
+    profile.parent = parent;
+    profile.overrides = overrides;
+    profile.revision = ++revisionCount;
+    profile.resolvedRevision = 0;
+
+    profiles.append(profile);
+    names.insert(name, profiles.size() - 1);
+
+    return profiles.size() - 1;
+}
+
+void ConfigurationProfiles::setOverrides(
+        int id,
+        const ConfigurationFile::Settings &overrides)
+{
+    profiles[id].overrides = overrides;
+    profiles[id].revision = ++revisionCount;
+}
+
+bool ConfigurationProfiles::setParent(
+        int id,
+        int parent)
+{
+    for (int ancestor = parent; ancestor >= 0; ancestor = profiles[ancestor].parent)
+    {
+        if (ancestor == id) return false;
+    }
+
+    profiles[id].parent = parent;
+    profiles[id].revision = ++revisionCount;
+    return true;
+}
+
+const Configuration &ConfigurationProfiles::resolve(
+        int id)
+{
+    Profile &profile = profiles[id];
+
+    // Revisions only grow, so the newest along the chain changes
+    // whenever the profile or an ancestor does
+    quint64 revision = profile.revision;
+    if (profile.parent >= 0)
+    {
+        resolve(profile.parent);
+        revision = qMax(revision, profiles[profile.parent].resolvedRevision);
+    }
+
+    if (profile.resolvedRevision == revision) return profile.resolved;
+
+    profile.resolved = (profile.parent >= 0)
+            ? profiles[profile.parent].resolved
+            : Configuration(displayUnits);
+    apply(profile.overrides, profile.resolved);
+
+    profile.resolvedRevision = revision;
+    ++resolveCount;
+
+    return profile.resolved;
+}
+
+void ConfigurationProfiles::apply(
+        const ConfigurationFile::Settings &overrides,
+        Configuration &configuration)
+{
+    bool alarms = false, windows = false, speeches = false;
+
+    foreach (const ConfigurationFile::Setting &setting, overrides)
+    {
+        // The first item of a list replaces the inherited list
+        if (!alarms && setting.first == "Alarm_Elev")
+        {
+            configuration.alarms.clear();
+            alarms = true;
+        }
+        if (!windows && setting.first == "Win_Top")
+        {
+            configuration.windows.clear();
+            windows = true;
+        }
+        if (!speeches && setting.first == "Sp_Mode")
+        {
+            configuration.speeches.clear();
+            speeches = true;
+        }
+
+        ConfigurationFile::applySetting(setting.first, setting.second, configuration);
+    }
+}
+
+int ConfigurationProfiles::load(
+        const QString &fileName,
+        QString &error)
+{
+    QStringList chain;
+    return loadFile(QFileInfo(fileName).absoluteFilePath(), chain, error);
+}
+
+int ConfigurationProfiles::loadFile(
+        const QString &path,
+        QStringList &chain,
+        QString &error)
+{
+    if (chain.contains(path))
+    {
+        error = QObject::tr("%1 inherits from itself.").arg(QDir::toNativeSeparators(path));
+        return -1;
+    }
+
+    const QFileInfo info(path);
+    if (!info.isFile())
+    {
+        error = QObject::tr("Couldn't find %1.").arg(QDir::toNativeSeparators(path));
+        return -1;
+    }
+
+    chain.append(path);
+
+    int id = find(path);
+    if (id < 0 || profiles[id].modified != info.lastModified())
+    {
+        ConfigurationFile::Settings settings;
+        if (!ConfigurationFile::readSettings(path, settings))
+        {
+            error = QObject::tr("Couldn't read %1.").arg(QDir::toNativeSeparators(path));
+            return -1;
+        }
+
+        QString parentName;
+        ConfigurationFile::Settings overrides;
+        foreach (const ConfigurationFile::Setting &setting, settings)
+        {
+            if (setting.first == PROFILE_PARENT) parentName = setting.second;
+            else overrides.append(setting);
+        }
+
+        int parent = -1;
+        if (!parentName.isEmpty())
+        {
+            // Relative to the file, unless absolute
+            parent = loadFile(QDir::cleanPath(info.absoluteDir().absoluteFilePath(
+                                                  QDir::fromNativeSeparators(parentName))),
+                              chain, error);
+            if (parent < 0) return -1;
+        }
+
+        if (id < 0)
+        {
+            id = add(path, parent, overrides);
+        }
+        else
+        {
+            profiles[id].parent = parent;
+            setOverrides(id, overrides);
+        }
+
+        profiles[id].modified = info.lastModified();
+    }
+    else if (profiles[id].parent >= 0)
+    {
+        // Unchanged, but an ancestor may have been edited
+        if (loadFile(profiles[profiles[id].parent].name, chain, error) < 0) return -1;
+    }
+
+    chain.removeLast();
+    return id;
+}
@@ -0,0 +1,106 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef CONFIGURATIONPROFILES_H
+#define CONFIGURATIONPROFILES_H
+
+#include <QDateTime>
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+#include "configuration.h"
+#include "configurationfile.h"
+
+// Layered configurations. Each profile holds only the settings it
+// overrides, in configuration file form, on top of its parent's
+// configuration; a profile without a parent overrides the defaults.
+// Resolved configurations are kept until the profile or one of its
+// ancestors changes, so an edit to a base profile reaches every
+// descendant the next time it is resolved.
+//
+// Alarms, windows and speech are lists, so a profile which adds any
+// alarm, window or speech replaces that whole list.
+class ConfigurationProfiles
+{
+public:
+    explicit ConfigurationProfiles(Configuration::DisplayUnits units = Configuration::Metric);
+
+    // Adds a profile below the parent, or at the top if it is -1
+    int add(const QString &name, int parent,
+            const ConfigurationFile::Settings &overrides);
+
+    void setOverrides(int id, const ConfigurationFile::Settings &overrides);
+
+    // Fails if the parent is the profile or one of its descendants
+    bool setParent(int id, int parent);
+
+    int count() const { return profiles.size(); }
+    int find(const QString &name) const { return names.value(name, -1); }
+
+    QString name(int id) const { return profiles[id].name; }
+    int parent(int id) const { return profiles[id].parent; }
+    const ConfigurationFile::Settings &overrides(int id) const { return profiles[id].overrides; }
+
+    // Effective configuration, valid until a profile is added
+    const Configuration &resolve(int id);
+
+    // Loads a profile file and its ancestors, each named by a Parent
+    // setting relative to the file. Files already loaded are read again
+    // only if they changed on disk. Returns the profile, or -1.
+    int load(const QString &fileName, QString &error);
+
+    // Configurations built so far, as opposed to taken from the cache
+    int resolutions() const { return resolveCount; }
+
+    // Applies settings on top of a configuration, replacing each list
+    // the settings add to
+    static void apply(const ConfigurationFile::Settings &overrides,
+                      Configuration &configuration);
+
+private:
+    typedef struct {
+        QString name;
+        int parent;
+        ConfigurationFile::Settings overrides;
+        quint64 revision;
+
+        // Newest revision along the chain when last resolved
+        quint64 resolvedRevision;
+        Configuration resolved;
+
+        QDateTime modified;
+    } Profile;
+
+    Configuration::DisplayUnits displayUnits;
+
+    QVector< Profile > profiles;
+    QHash< QString, int > names;
+
+    quint64 revisionCount;
+    int resolveCount;
+
+    int loadFile(const QString &path, QStringList &chain, QString &error);
+};
+
+#endif // CONFIGURATIONPROFILES_H
@@ -0,0 +1,386 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "configurationwriter.h"
+
+#include <QFile>
+
+#define WRITER_CAPACITY 16384   // Bytes reserved for file contents
+#define WRITER_WIDTH        5   // Width of setting values
+
+ConfigurationWriter::ConfigurationWriter()
+{
+    // Reserved capacity is kept when the buffer is emptied
+    buffer.reserve(WRITER_CAPACITY);
+}
+
+const QByteArray &ConfigurationWriter::write(
+        const Configuration &configuration)
+{
+    buffer.resize(0);
+
+    line("; For information on configuring FlySight, please go to");
+    line(";     http://flysight.ca/wiki");
+    line();
+
+    line("; GPS settings");
+    line();
+
+    value("Config_Name:  ", configuration.configName, " ; Configuration name");
+    value("Config_Description:  ", configuration.configDescription, " ; Configuration Description");
+    value("Config_Kind:  ", configuration.configKind, " ; Configuration kind. Allows to group configuration files together");
+    line();
+
+    value("Model:      ", configuration.model, " ; Dynamic model");
+    line("                  ;   0 = Portable");
+    line("                  ;   2 = Stationary");
+    line("                  ;   3 = Pedestrian");
+    line("                  ;   4 = Automotive");
+    line("                  ;   5 = Sea");
+    line("                  ;   6 = Airborne with < 1 G acceleration");
+    line("                  ;   7 = Airborne with < 2 G acceleration");
+    line("                  ;   8 = Airborne with < 4 G acceleration");
+    value("Rate:       ", configuration.rate, " ; Measurement rate (ms)");
+    line();
+
+    line("; Tone settings");
+    line();
+
+    value("Mode:       ", configuration.toneMode, " ; Measurement mode");
+    line("                  ;   0 = Horizontal speed");
+    line("                  ;   1 = Vertical speed");
+    line("                  ;   2 = Glide ratio");
+    line("                  ;   3 = Inverse glide ratio");
+    line("                  ;   4 = Total speed");
+    line("                  ;   11 = Dive angle");
+    value("Min:        ", configuration.minTone, " ; Lowest pitch value");
+    line("                  ;   cm/s        in Mode 0, 1, or 4");
+    line("                  ;   ratio * 100 in Mode 2 or 3");
+    line("                  ;   degrees     in Mode 11");
+    value("Max:        ", configuration.maxTone, " ; Highest pitch value");
+    line("                  ;   cm/s        in Mode 0, 1, or 4");
+    line("                  ;   ratio * 100 in Mode 2 or 3");
+    line("                  ;   degrees     in Mode 11");
+    value("Limits:     ", configuration.limits, " ; Behaviour when outside bounds");
+    line("                  ;   0 = No tone");
+    line("                  ;   1 = Min/max tone");
+    line("                  ;   2 = Chirp up/down");
+    line("                  ;   3 = Chirp down/up");
+    value("Volume:     ", configuration.toneVolume, " ; 0 (min) to 8 (max)");
+    line();
+
+    line("; Rate settings");
+    line();
+
+    value("Mode_2:     ", configuration.rateMode, " ; Determines tone rate");
+    line("                  ;   0 = Horizontal speed");
+    line("                  ;   1 = Vertical speed");
+    line("                  ;   2 = Glide ratio");
+    line("                  ;   3 = Inverse glide ratio");
+    line("                  ;   4 = Total speed");
+    line("                  ;   8 = Magnitude of Value 1");
+    line("                  ;   9 = Change in Value 1");
+    line("                  ;   11 = Dive angle");
+    value("Min_Val_2:  ", configuration.minRateValue, " ; Lowest rate value");
+    line("                  ;   cm/s          when Mode 2 = 0, 1, or 4");
+    line("                  ;   ratio * 100   when Mode 2 = 2 or 3");
+    line("                  ;   percent * 100 when Mode 2 = 9");
+    line("                  ;   degrees       when Mode 2 = 11");
+    value("Max_Val_2:  ", configuration.maxRateValue, " ; Highest rate value");
+    line("                  ;   cm/s          when Mode 2 = 0, 1, or 4");
+    line("                  ;   ratio * 100   when Mode 2 = 2 or 3");
+    line("                  ;   percent * 100 when Mode 2 = 9");
+    line("                  ;   degrees       when Mode 2 = 11");
+    value("Min_Rate:   ", configuration.minRate, " ; Minimum rate (Hz * 100)");
+    value("Max_Rate:   ", configuration.maxRate, " ; Maximum rate (Hz * 100)");
+    value("Flatline:   ", configuration.flatline, " ; Flatline at minimum rate");
+    line("                  ;   0 = No");
+    line("                  ;   1 = Yes");
+    line();
+
+    line("; Speech settings");
+    line();
+
+    value("Sp_Rate:    ", configuration.speechRate, " ; Speech rate (s)");
+    line("                  ;   0 = No speech");
+    value("Sp_Volume:  ", configuration.speechVolume, " ; 0 (min) to 8 (max)");
+    line();
+
+    if (configuration.speeches.empty())
+    {
+        Configuration::Speech speech;
+        speech.mode = Configuration::GlideRatio;
+        speech.units = Configuration::Miles;
+        speech.decimals = 1;
+        writeSpeech(speech, true);
+    }
+    else
+    {
+        bool firstSpeech = true;
+        foreach (Configuration::Speech speech, configuration.speeches)
+        {
+            writeSpeech(speech, firstSpeech);
+            firstSpeech = false;
+        }
+    }
+
+    line("; Thresholds");
+    line();
+
+    value("V_Thresh:   ", configuration.vThreshold, " ; Minimum vertical speed for tone (cm/s)");
+    value("H_Thresh:   ", configuration.hThreshold, " ; Minimum horizontal speed for tone (cm/s)");
+    line();
+
+    line("; Miscellaneous");
+    line();
+
+    value("Use_SAS:    ", configuration.adjustSpeed, " ; Use skydiver's airspeed");
+    line("                  ;   0 = No");
+    line("                  ;   1 = Yes");
+    value("TZ_Offset:  ", configuration.timeZoneOffset, " ; Timezone offset of output files in seconds");
+    line("                  ;   -14400 = UTC-4 (EDT)");
+    line("                  ;   -18000 = UTC-5 (EST, CDT)");
+    line("                  ;   -21600 = UTC-6 (CST, MDT)");
+    line("                  ;   -25200 = UTC-7 (MST, PDT)");
+    line("                  ;   -28800 = UTC-8 (PST)");
+    line();
+
+    line("; Initialization");
+    line();
+
+    value("Init_Mode:  ", configuration.initMode, " ; When the FlySight is powered on");
+    line("                  ;   0 = Do nothing");
+    line("                  ;   1 = Test speech mode");
+    line("                  ;   2 = Play file");
+    value("Init_File:  ", configuration.initFile, " ; File to be played");
+    line();
+
+    line("; Alarm settings");
+    line();
+
+    line("; WARNING: GPS measurements depend on very weak signals");
+    line(";          received from orbiting satellites. As such, they");
+    line(";          are prone to interference, and should NEVER be");
+    line(";          relied upon for life saving purposes.");
+    line();
+
+    line(";          UNDER NO CIRCUMSTANCES SHOULD THESE ALARMS BE");
+    line(";          USED TO INDICATE DEPLOYMENT OR BREAKOFF ALTITUDE.");
+    line();
+
+    line("; NOTE:    Alarm elevations are given in meters above ground");
+    line(";          elevation, which is specified in DZ_Elev.");
+    line();
+
+    value("Window:     ", configuration.alarmWindowAbove, " ; Alarm window (m)");
+    value("Win_Above:  ", configuration.alarmWindowAbove, " ; Alarm window (m)");
+    value("Win_Below:  ", configuration.alarmWindowBelow, " ; Alarm window (m)");
+    value("DZ_Elev:    ", configuration.groundElevation, " ; Ground elevation (m above sea level)");
+    line();
+
+    if (configuration.alarms.empty())
+    {
+        Configuration::Alarm alarm;
+        alarm.elevation = 0;
+        alarm.mode = Configuration::NoAlarm;
+        alarm.file = "0";
+        writeAlarm(alarm, true);
+    }
+    else
+    {
+        bool firstAlarm = true;
+        foreach (Configuration::Alarm alarm, configuration.alarms)
+        {
+            writeAlarm(alarm, firstAlarm);
+            firstAlarm = false;
+        }
+    }
+
+    line("; Altitude mode settings");
+    line();
+
+    line("; WARNING: GPS measurements depend on very weak signals");
+    line(";          received from orbiting satellites. As such, they");
+    line(";          are prone to interference, and should NEVER be");
+    line(";          relied upon for life saving purposes.");
+    line();
+
+    line(";          UNDER NO CIRCUMSTANCES SHOULD ALTITUDE MODE BE");
+    line(";          USED TO INDICATE DEPLOYMENT OR BREAKOFF ALTITUDE.");
+    line();
+
+    line("; NOTE:    Altitude is given relative to ground elevation,");
+    line(";          which is specified in DZ_Elev. Altitude mode will");
+    line(";          not function below 1500 m above ground.");
+    line();
+
+    value("Alt_Units:  ", configuration.altitudeUnits, " ; Altitude units");
+    line("                  ;   0 = m");
+    line("                  ;   1 = ft");
+    value("Alt_Step:   ", configuration.altitudeStep, " ; Altitude between announcements");
+    line("                  ;   0 = No altitude");
+    line();
+
+    line("; Silence windows");
+    line();
+
+    line("; NOTE:    Silence windows are given in meters above ground");
+    line(";          elevation, which is specified in DZ_Elev. Tones");
+    line(";          will be silenced during these windows and only");
+    line(";          alarms will be audible.");
+    line();
+
+    if (configuration.windows.empty())
+    {
+        Configuration::Window window;
+        window.top = 0;
+        window.bottom = 0;
+        writeWindow(window);
+    }
+    else
+    {
+        foreach (Configuration::Window window, configuration.windows)
+        {
+            writeWindow(window);
+        }
+    }
+
+    return buffer;
+}
+
+bool ConfigurationWriter::save(
+        const QString &fileName,
+        const Configuration &configuration)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) return false;
+
+    const QByteArray &text = write(configuration);
+    return file.write(text) == text.size();
+}
+
+void ConfigurationWriter::line(
+        const char *text)
+{
+    buffer.append(text);
+    buffer.append('\n');
+}
+
+void ConfigurationWriter::value(
+        const char *name,
+        int value,
+        const char *comment)
+{
+    // Digits are written backwards from the end
+    char digits[12];
+    char *const end = digits + sizeof(digits);
+    char *p = end;
+
+    unsigned int magnitude = value < 0 ? 0u - (unsigned int) value : (unsigned int) value;
+    do
+    {
+        *--p = '0' + magnitude % 10;
+        magnitude /= 10;
+    } while (magnitude);
+    if (value < 0) *--p = '-';
+
+    buffer.append(name);
+    for (int i = end - p; i < WRITER_WIDTH; ++i)
+    {
+        buffer.append(' ');
+    }
+    buffer.append(p, end - p);
+    buffer.append(comment);
+    buffer.append('\n');
+}
+
+void ConfigurationWriter::value(
+        const char *name,
+        const QString &value,
+        const char *comment)
+{
+    buffer.append(name);
+    for (int i = value.length(); i < WRITER_WIDTH; ++i)
+    {
+        buffer.append(' ');
+    }
+    buffer.append(value.toLocal8Bit());
+    buffer.append(comment);
+    buffer.append('\n');
+}
+
+void ConfigurationWriter::writeSpeech(
+        const Configuration::Speech &speech,
+        bool firstSpeech)
+{
+    value("Sp_Mode:    ", speech.mode, " ; Speech mode");
+    if (firstSpeech)
+    {
+        line("                  ;   0 = Horizontal speed");
+        line("                  ;   1 = Vertical speed");
+        line("                  ;   2 = Glide ratio");
+        line("                  ;   3 = Inverse glide ratio");
+        line("                  ;   4 = Total speed");
+        line("                  ;   5 = Altitude above DZ_Elev");
+        line("                  ;   11 = Dive angle");
+    }
+    value("Sp_Units:   ", speech.units, " ; Speech units");
+    if (firstSpeech)
+    {
+        line("                  ;   0 = km/h or m");
+        line("                  ;   1 = mph or feet");
+    }
+    value("Sp_Dec:     ", speech.decimals, " ; Speech precision");
+    if (firstSpeech)
+    {
+        line("                  ;   Altitude step in Mode 5");
+        line("                  ;   Decimal places in all other Modes");
+    }
+    line();
+}
+
+void ConfigurationWriter::writeAlarm(
+        const Configuration::Alarm &alarm,
+        bool firstAlarm)
+{
+    value("Alarm_Elev: ", alarm.elevation, " ; Alarm elevation (m above ground level)");
+    value("Alarm_Type: ", alarm.mode, " ; Alarm type");
+    if (firstAlarm)
+    {
+        line("                  ;   0 = No alarm");
+        line("                  ;   1 = Beep");
+        line("                  ;   2 = Chirp up");
+        line("                  ;   3 = Chirp down");
+        line("                  ;   4 = Play file");
+    }
+    value("Alarm_File: ", alarm.file, " ; File to be played");
+    line();
+}
+
+void ConfigurationWriter::writeWindow(
+        const Configuration::Window &window)
+{
+    value("Win_Top:    ", window.top, " ; Silence window top (m)");
+    value("Win_Bottom: ", window.bottom, " ; Silence window bottom (m)");
+    line();
+}
@@ -0,0 +1,58 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef CONFIGURATIONWRITER_H
+#define CONFIGURATIONWRITER_H
+
+#include <QByteArray>
+#include <QString>
+
+#include "configuration.h"
+
+// Writes configuration files. The text is built in a buffer which keeps
+// its memory from one file to the next, so a writer can be reused to
+// save many configurations without allocating or setting up a stream
+// for each. A writer must only be used by one thread at a time.
+class ConfigurationWriter
+{
+public:
+    ConfigurationWriter();
+
+    // File contents, valid until the next configuration is written
+    const QByteArray &write(const Configuration &configuration);
+
+    bool save(const QString &fileName, const Configuration &configuration);
+
+private:
+    QByteArray buffer;
+
+    void line(const char *text = "");
+    void value(const char *name, int value, const char *comment);
+    void value(const char *name, const QString &value, const char *comment);
+
+    void writeSpeech(const Configuration::Speech &speech, bool firstSpeech);
+    void writeAlarm(const Configuration::Alarm &alarm, bool firstAlarm);
+    void writeWindow(const Configuration::Window &window);
+};
+
+#endif // CONFIGURATIONWRITER_H
@@ -0,0 +1,83 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef COUNTERRNG_H
+#define COUNTERRNG_H
+
+#include <QtGlobal>
+#include <QtMath>
+
+#include <cmath>
+
+#define COUNTER_RNG_GAMMA Q_UINT64_C(0x9e3779b97f4a7c15)
+
+// Counter-based random numbers. Each value is a hash of the stream key and
+// a counter, so it does not depend on which thread draws it or in what order.
+class CounterRng
+{
+public:
+    CounterRng(quint64 seed, quint64 stream) :
+        key(mix(mix(seed) + stream * COUNTER_RNG_GAMMA))
+    {
+
+    }
+
+    // Uniformly distributed 64-bit value
+    quint64 bits(quint64 counter) const
+    {
+        return mix(key + (counter + 1) * COUNTER_RNG_GAMMA);
+    }
+
+    // Uniformly distributed in [0, 1)
+    double uniform(quint64 counter) const
+    {
+        return (bits(counter) >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    // Standard normal, using counters 2 * counter and 2 * counter + 1
+    double normal(quint64 counter) const
+    {
+        const double u = 1 - uniform(2 * counter);
+        const double v = uniform(2 * counter + 1);
+        return std::sqrt(-2 * std::log(u)) * std::cos(2 * M_PI * v);
+    }
+
+    // Exponentially distributed with the given mean
+    double exponential(quint64 counter, double mean) const
+    {
+        return -mean * std::log(1 - uniform(counter));
+    }
+
+private:
+    quint64 key;
+
+    // SplitMix64 finalizer
+    static quint64 mix(quint64 z)
+    {
+        z = (z ^ (z >> 30)) * Q_UINT64_C(0xbf58476d1ce4e5b9);
+        z = (z ^ (z >> 27)) * Q_UINT64_C(0x94d049bb133111eb);
+        return z ^ (z >> 31);
+    }
+};
+
+#endif // COUNTERRNG_H
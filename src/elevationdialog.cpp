@@ -0,0 +1,158 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+#include "elevationdialog.h"
+#include "ui_elevationdialog.h"
+
+#include <QDir>
+#include <QFileDialog>
+#include <QPushButton>
+#include <QSettings>
+
+#include <cmath>
+
+#include "elevationfiller.h"
+#include "track.h"
+#include "trackcache.h"
+
+ElevationDialog::ElevationDialog(
+        QWidget *parent) :
+    QDialog(parent),
+    ui(new Ui::ElevationDialog),
+    groundElevation(0)
+{
+    ui->setupUi(this);
+
+    // Initialize settings object
+    QSettings settings("FlySight", "Configurator");
+
+    const QString folder = settings.value("elevationFolder").toString();
+    ui->folderEdit->setText(QDir::toNativeSeparators(folder));
+    model.setFolder(folder);
+
+    ui->latitudeSpinBox->setValue(settings.value("elevationLatitude").toDouble());
+    ui->longitudeSpinBox->setValue(settings.value("elevationLongitude").toDouble());
+
+    connect(ui->latitudeSpinBox, SIGNAL(valueChanged(double)),
+            this, SLOT(lookUp()));
+    connect(ui->longitudeSpinBox, SIGNAL(valueChanged(double)),
+            this, SLOT(lookUp()));
+
+    lookUp();
+}
+
+ElevationDialog::~ElevationDialog()
+{
+    delete ui;
+}
+
+void ElevationDialog::on_browseButton_clicked()
+{
+    QString folder = QFileDialog::getExistingDirectory(
+                this,
+                tr("Elevation Tile Folder"),
+                QDir::fromNativeSeparators(ui->folderEdit->text()));
+
+    // Return now if user canceled
+    if (folder.isEmpty()) return;
+
+    ui->folderEdit->setText(QDir::toNativeSeparators(folder));
+    on_folderEdit_editingFinished();
+}
+
+void ElevationDialog::on_folderEdit_editingFinished()
+{
+    const QString folder = QDir::fromNativeSeparators(ui->folderEdit->text());
+
+    // Remember folder for next time
+    QSettings settings("FlySight", "Configurator");
+    settings.setValue("elevationFolder", folder);
+
+    model.setFolder(folder);
+    lookUp();
+}
+
+void ElevationDialog::on_trackButton_clicked()
+{
+    // Initialize settings object
+    QSettings settings("FlySight", "Configurator");
+
+    QString fileName = QFileDialog::getOpenFileName(
+                this,
+                tr("Landing Point from Track"),
+                settings.value("logbookFolder").toString(),
+                tr("FlySight tracks (*.csv)"));
+
+    // Return now if user canceled
+    if (fileName.isEmpty()) return;
+
+    Track track;
+    TrackCache cache;
+    if (!cache.load(fileName, track))
+    {
+        ui->statusLabel->setText(cache.errorString());
+        return;
+    }
+
+    double lat, lon;
+    if (!ElevationFiller::landingPoint(track, lat, lon))
+    {
+        ui->statusLabel->setText(tr("No landing point in %1.")
+                                 .arg(QDir::toNativeSeparators(fileName)));
+        return;
+    }
+
+    // Look up once both are set
+    ui->latitudeSpinBox->blockSignals(true);
+    ui->latitudeSpinBox->setValue(lat);
+    ui->latitudeSpinBox->blockSignals(false);
+    ui->longitudeSpinBox->setValue(lon);
+}
+
+void ElevationDialog::lookUp()
+{
+    const double lat = ui->latitudeSpinBox->value();
+    const double lon = ui->longitudeSpinBox->value();
+
+    QPushButton *okButton = ui->buttonBox->button(QDialogButtonBox::Ok);
+
+    double meters;
+    if (!model.elevation(lat, lon, meters))
+    {
+        ui->statusLabel->setText(
+                    tr("No elevation data. Tile %1.hgt is missing from the folder.")
+                    .arg(ElevationModel::tileName((int) floor(lat), (int) floor(lon))));
+        okButton->setEnabled(false);
+        return;
+    }
+
+    groundElevation = (int) floor(meters + 0.5);
+
+    ui->statusLabel->setText(tr("Ground elevation: %1 m above sea level")
+                             .arg(groundElevation));
+    okButton->setEnabled(true);
+
+    // Remember position for next time
+    QSettings settings("FlySight", "Configurator");
+    settings.setValue("elevationLatitude", lat);
+    settings.setValue("elevationLongitude", lon);
+}
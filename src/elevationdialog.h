@@ -0,0 +1,59 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+#ifndef ELEVATIONDIALOG_H
+#define ELEVATIONDIALOG_H
+
+#include <QDialog>
+
+#include "elevationmodel.h"
+
+namespace Ui {
+class ElevationDialog;
+}
+
+class ElevationDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit ElevationDialog(QWidget *parent = 0);
+    ~ElevationDialog();
+
+    // m above sea level, rounded as DZ_Elev is stored
+    int elevation() const { return groundElevation; }
+
+private:
+    Ui::ElevationDialog *ui;
+
+    ElevationModel model;
+    int groundElevation;
+
+private slots:
+    void on_browseButton_clicked();
+    void on_trackButton_clicked();
+    void on_folderEdit_editingFinished();
+
+    void lookUp();
+};
+
+#endif // ELEVATIONDIALOG_H
@@ -0,0 +1,124 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+#include "elevationfiller.h"
+
+#include <QObject>
+#include <QtConcurrent>
+
+#include <cmath>
+
+#include "configurationfile.h"
+#include "elevationmodel.h"
+#include "jumpsegmenter.h"
+#include "track.h"
+#include "trackcache.h"
+
+class FillFile
+{
+public:
+    typedef ElevationFiller::Result result_type;
+
+    FillFile(ElevationModel *model) : model(model) {}
+
+    ElevationFiller::Result operator()(const QString &fileName) const
+    {
+        return ElevationFiller::fillFile(fileName, model);
+    }
+
+private:
+    ElevationModel *model;
+};
+
+QFuture< ElevationFiller::Result > ElevationFiller::fillFiles(
+        const QStringList &fileNames,
+        ElevationModel *model)
+{
+    return QtConcurrent::mapped(fileNames, FillFile(model));
+}
+
+ElevationFiller::Result ElevationFiller::fillFile(
+        const QString &fileName,
+        ElevationModel *model)
+{
+    Result result;
+    result.fileName = fileName;
+    result.lat = 0;
+    result.lon = 0;
+    result.elevation = 0;
+
+    result.trackName = ConfigurationFile::latestTrack(fileName);
+    if (result.trackName.isEmpty())
+    {
+        result.error = QObject::tr("No tracks beside configuration");
+        return result;
+    }
+
+    Track track;
+    TrackCache cache;
+    if (!cache.load(result.trackName, track))
+    {
+        result.error = cache.errorString();
+        return result;
+    }
+
+    if (!landingPoint(track, result.lat, result.lon))
+    {
+        result.error = QObject::tr("No landing point in track");
+        return result;
+    }
+
+    double meters;
+    if (!model->elevation(result.lat, result.lon, meters))
+    {
+        result.error = QObject::tr("No elevation data for %1")
+                .arg(ElevationModel::tileName((int) floor(result.lat),
+                                              (int) floor(result.lon)));
+        return result;
+    }
+
+    result.elevation = (int) floor(meters + 0.5);
+
+    QString error;
+    if (!ConfigurationFile::setValue(fileName, "DZ_Elev", result.elevation, error))
+    {
+        result.error = error;
+    }
+
+    return result;
+}
+
+bool ElevationFiller::landingPoint(
+        const Track &track,
+        double &lat,
+        double &lon)
+{
+    JumpSegmenter segmenter;
+    TrackCache().segment(track, segmenter);
+
+    const int i = segmenter.landingSample(track);
+    if (i < 0) return false;
+
+    lat = track.lat[i];
+    lon = track.lon[i];
+    return true;
+}
@@ -0,0 +1,54 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+#ifndef ELEVATIONFILLER_H
+#define ELEVATIONFILLER_H
+
+#include <QFuture>
+#include <QString>
+#include <QStringList>
+
+class ElevationModel;
+class Track;
+
+// Sets DZ_Elev in each configuration of a library from the landing point
+// of the latest track stored beside it
+class ElevationFiller
+{
+public:
+    typedef struct {
+        QString fileName;
+        QString trackName;
+        double lat;
+        double lon;
+        int elevation;      // m
+        QString error;      // Empty on success
+    } Result;
+
+    // The model must outlive the future
+    static QFuture< Result > fillFiles(const QStringList &fileNames, ElevationModel *model);
+    static Result fillFile(const QString &fileName, ElevationModel *model);
+
+    static bool landingPoint(const Track &track, double &lat, double &lon);
+};
+
+#endif // ELEVATIONFILLER_H
@@ -0,0 +1,238 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+#include "elevationmodel.h"
+
+#include <QDir>
+#include <QFile>
+#include <QMutexLocker>
+
+#include <cmath>
+
+// Marks a post with no data
+#define HGT_VOID -32768
+
+ElevationModel::ElevationModel() :
+    maxSize(ELEVATION_CACHE_SIZE),
+    mappedSize(0),
+    clock(0)
+{
+
+}
+
+ElevationModel::~ElevationModel()
+{
+    QHash< qint32, Tile >::iterator it;
+    for (it = tiles.begin(); it != tiles.end(); ++it)
+    {
+        unmap(it.value());
+    }
+}
+
+void ElevationModel::setFolder(
+        const QString &folder)
+{
+    QMutexLocker locker(&mutex);
+
+    if (folder == tileFolder) return;
+
+    // Tiles from the old folder no longer apply
+    QHash< qint32, Tile >::iterator it;
+    for (it = tiles.begin(); it != tiles.end(); ++it)
+    {
+        unmap(it.value());
+    }
+    tiles.clear();
+
+    tileFolder = folder;
+}
+
+void ElevationModel::setMaximumSize(
+        qint64 bytes)
+{
+    QMutexLocker locker(&mutex);
+
+    maxSize = bytes;
+    trim(0);
+}
+
+QString ElevationModel::tileName(
+        int lat,
+        int lon)
+{
+    return QString("%1%2%3%4")
+            .arg(lat < 0 ? 'S' : 'N')
+            .arg(qAbs(lat), 2, 10, QChar('0'))
+            .arg(lon < 0 ? 'W' : 'E')
+            .arg(qAbs(lon), 3, 10, QChar('0'));
+}
+
+bool ElevationModel::elevation(
+        double lat,
+        double lon,
+        double &meters)
+{
+    if (lat < -90 || lat >= 90 || lon < -180 || lon > 180) return false;
+    if (lon == 180) lon = -180;
+
+    const int lat0 = (int) floor(lat);
+    const int lon0 = (int) floor(lon);
+
+    // Held for the whole lookup so the tile can't be unmapped under us
+    QMutexLocker locker(&mutex);
+
+    const Tile &t = tile(lat0, lon0);
+    if (!t.data) return false;
+
+    // Rows run north to south and columns west to east, with the posts
+    // on each edge shared with the neighbouring tile
+    const int last = t.samples - 1;
+    const double y = (lat0 + 1 - lat) * last;
+    const double x = (lon - lon0) * last;
+
+    const int row = qMin((int) y, last - 1);
+    const int col = qMin((int) x, last - 1);
+
+    const double fy = y - row;
+    const double fx = x - col;
+
+    const double weights[4] = {
+        (1 - fy) * (1 - fx), (1 - fy) * fx,
+        fy * (1 - fx),       fy * fx
+    };
+    const int offsets[4] = {
+        row * t.samples + col,       row * t.samples + col + 1,
+        (row + 1) * t.samples + col, (row + 1) * t.samples + col + 1
+    };
+
+    // Voids are left out and the remaining posts weighted up to match
+    double sum = 0, weight = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+        const uchar *p = t.data + 2 * offsets[i];
+        const qint16 value = (qint16) ((p[0] << 8) | p[1]);
+        if (value == HGT_VOID) continue;
+
+        sum += weights[i] * value;
+        weight += weights[i];
+    }
+
+    if (weight <= 0) return false;
+
+    meters = sum / weight;
+    return true;
+}
+
+const ElevationModel::Tile &ElevationModel::tile(
+        int lat,
+        int lon)
+{
+    const qint32 key = (lat + 90) * 360 + (lon + 180);
+
+    QHash< qint32, Tile >::iterator it = tiles.find(key);
+    if (it != tiles.end())
+    {
+        it->lastUsed = ++clock;
+        return it.value();
+    }
+
+    Tile t;
+    t.file = 0;
+    t.data = 0;
+    t.samples = 0;
+    t.bytes = 0;
+    t.lastUsed = ++clock;
+
+    // Tiles are often unpacked with lower case names
+    const QString name = tileName(lat, lon);
+    QDir dir(tileFolder);
+    QString path = dir.filePath(name + ".hgt");
+    if (!QFile::exists(path)) path = dir.filePath(name.toLower() + ".hgt");
+
+    QFile *file = new QFile(path);
+    if (!tileFolder.isEmpty() && file->open(QIODevice::ReadOnly))
+    {
+        // Square grid of 16-bit posts: 1201 for 3" and 3601 for 1" data
+        const qint64 size = file->size();
+        const int samples = (int) floor(sqrt(size / 2.0) + 0.5);
+
+        if (samples > 1 && (qint64) samples * samples * 2 == size)
+        {
+            trim(size);
+
+            t.data = file->map(0, size);
+            if (t.data)
+            {
+                t.file = file;
+                t.samples = samples;
+                t.bytes = size;
+                mappedSize += size;
+            }
+        }
+    }
+
+    if (!t.file) delete file;
+
+    // Missing tiles are remembered too, so the folder is only searched once
+    return tiles.insert(key, t).value();
+}
+
+void ElevationModel::unmap(
+        Tile &tile)
+{
+    if (!tile.file) return;
+
+    tile.file->unmap((uchar *) tile.data);
+    delete tile.file;
+
+    mappedSize -= tile.bytes;
+
+    tile.file = 0;
+    tile.data = 0;
+}
+
+void ElevationModel::trim(
+        qint64 needed)
+{
+    if (maxSize <= 0) return;
+
+    while (mappedSize > 0 && mappedSize + needed > maxSize)
+    {
+        // Only a handful of tiles fit in any budget, so a scan is cheap
+        QHash< qint32, Tile >::iterator oldest = tiles.end();
+        QHash< qint32, Tile >::iterator it;
+        for (it = tiles.begin(); it != tiles.end(); ++it)
+        {
+            if (!it->file) continue;
+            if (oldest == tiles.end() || it->lastUsed < oldest->lastUsed)
+            {
+                oldest = it;
+            }
+        }
+
+        if (oldest == tiles.end()) break;
+
+        // Drop the entry so the tile is mapped again when it's next used
+        unmap(oldest.value());
+        tiles.erase(oldest);
+    }
+}
@@ -0,0 +1,82 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+#ifndef ELEVATIONMODEL_H
+#define ELEVATIONMODEL_H
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+
+class QFile;
+
+// Default budget for mapped tiles (bytes)
+#define ELEVATION_CACHE_SIZE (256 * 1024 * 1024)
+
+// Ground elevation from a folder of SRTM height tiles (N37W122.hgt etc.).
+// Tiles are memory-mapped as they are needed and kept until the mapped
+// size goes over budget, when the least recently used are unmapped.
+// Lookups may be made from several threads at once.
+class ElevationModel
+{
+public:
+    ElevationModel();
+    ~ElevationModel();
+
+    QString folder() const { return tileFolder; }
+    void setFolder(const QString &folder);
+
+    qint64 maximumSize() const { return maxSize; }
+    void setMaximumSize(qint64 bytes);
+
+    // Bilinear interpolation between posts, in m above sea level. Returns
+    // false where there is no tile or all four posts are voids.
+    bool elevation(double lat, double lon, double &meters);
+
+    static QString tileName(int lat, int lon);
+
+private:
+    typedef struct {
+        QFile *file;        // Null if there is no tile
+        const uchar *data;
+        int samples;        // Posts along each side
+        qint64 bytes;
+        quint64 lastUsed;
+    } Tile;
+
+    QString tileFolder;
+    qint64  maxSize;
+
+    QMutex mutex;
+    QHash< qint32, Tile > tiles;
+    qint64  mappedSize;
+    quint64 clock;
+
+    const Tile &tile(int lat, int lon);
+    void unmap(Tile &tile);
+    void trim(qint64 needed);
+
+    ElevationModel(const ElevationModel &);
+    ElevationModel &operator=(const ElevationModel &);
+};
+
+#endif // ELEVATIONMODEL_H
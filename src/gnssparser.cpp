@@ -0,0 +1,693 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "gnssparser.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#define UBX_SYNC1       0xb5
+#define UBX_SYNC2       0x62
+#define UBX_NAV         0x01
+#define UBX_NAV_PVT     0x07
+#define UBX_NAV_PVT_LEN 92
+
+// Most fields read from an NMEA sentence
+#define NMEA_MAX_FIELDS 24
+
+#define KNOTS_TO_MPS    0.514444
+#define RAD_TO_DEG      57.29577951308232
+#define DEG_TO_RAD      0.017453292519943295
+
+// GPS epoch (1980-01-06) in seconds since the Unix epoch
+#define GPS_EPOCH       315964800
+
+static inline quint16 readU2(
+        const uchar *p)
+{
+    return p[0] | (p[1] << 8);
+}
+
+static inline quint32 readU4(
+        const uchar *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((quint32) p[3] << 24);
+}
+
+static inline void writeU2(
+        uchar *p,
+        quint16 value)
+{
+    p[0] = value;
+    p[1] = value >> 8;
+}
+
+static inline void writeU4(
+        uchar *p,
+        quint32 value)
+{
+    p[0] = value;
+    p[1] = value >> 8;
+    p[2] = value >> 16;
+    p[3] = value >> 24;
+}
+
+static inline bool isDigit(
+        char c)
+{
+    return (unsigned) (c - '0') < 10;
+}
+
+// Days since epoch of a civil date
+static qint64 daysFromCivil(
+        int y,
+        int m,
+        int d)
+{
+    y -= m <= 2;
+    const qint64 era = (y >= 0 ? y : y - 399) / 400;
+    const int yoe = y - era * 400;
+    const int doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+static void civilFromDays(
+        qint64 z,
+        int &y,
+        int &m,
+        int &d)
+{
+    z += 719468;
+    const qint64 era = (z >= 0 ? z : z - 146096) / 146097;
+    const int doe = z - era * 146097;
+    const int yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const int doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const int mp = (5 * doy + 2) / 153;
+    d = doy - (153 * mp + 2) / 5 + 1;
+    m = mp + (mp < 10 ? 3 : -9);
+    y = yoe + era * 400 + (m <= 2);
+}
+
+// Plain decimal which must fill the field. Parsed here rather than with
+// strtod, which follows the locale.
+static bool parseNumber(
+        const char *p,
+        const char *end,
+        double &value)
+{
+    const bool negative = (p < end && *p == '-');
+    if (negative) ++p;
+
+    double result = 0;
+    bool digits = false;
+
+    while (p < end && isDigit(*p))
+    {
+        result = result * 10 + (*p++ - '0');
+        digits = true;
+    }
+
+    if (p < end && *p == '.')
+    {
+        double scale = 0.1;
+        for (++p; p < end && isDigit(*p); ++p)
+        {
+            result += (*p - '0') * scale;
+            scale *= 0.1;
+            digits = true;
+        }
+    }
+
+    if (!digits || p != end) return false;
+
+    value = negative ? -result : result;
+    return true;
+}
+
+// Seconds since midnight from hhmmss.ss
+static bool parseTimeOfDay(
+        const char *p,
+        const char *end,
+        double &value)
+{
+    if (end - p < 6) return false;
+    for (int i = 0; i < 4; ++i)
+    {
+        if (!isDigit(p[i])) return false;
+    }
+
+    double seconds;
+    if (!parseNumber(p + 4, end, seconds)) return false;
+
+    value = ((p[0] - '0') * 10 + (p[1] - '0')) * 3600
+            + ((p[2] - '0') * 10 + (p[3] - '0')) * 60
+            + seconds;
+    return true;
+}
+
+// Degrees from ddmm.mmmm and a hemisphere
+static bool parseCoordinate(
+        const char *p,
+        const char *end,
+        char hemisphere,
+        double &value)
+{
+    double v;
+    if (!parseNumber(p, end, v)) return false;
+
+    const double degrees = floor(v / 100);
+    value = degrees + (v - degrees * 100) / 60;
+    if (hemisphere == 'S' || hemisphere == 'W') value = -value;
+    return true;
+}
+
+static int hexDigit(
+        char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+GnssParser::GnssParser()
+{
+    reset();
+}
+
+void GnssParser::reset()
+{
+    partialSize = 0;
+
+    haveGga = false;
+    haveRmc = false;
+    ggaTime = 0;
+    rmcTime = 0;
+    memset(&nmea, 0, sizeof(nmea));
+
+    havePrevious = false;
+    prevTime = 0;
+    prevAltitude = 0;
+
+    messageCount = 0;
+    errorCount = 0;
+    droppedCount = 0;
+}
+
+int GnssParser::messageLength(
+        const char *data,
+        int size)
+{
+    if (data[0] == '$')
+    {
+        const char *newline = (const char *) memchr(data, '\n', qMin(size, GNSS_MAX_NMEA));
+        if (newline) return newline - data + 1;
+        return (size < GNSS_MAX_NMEA) ? 0 : -1;
+    }
+
+    if ((uchar) data[0] == UBX_SYNC1)
+    {
+        if (size < 2) return 0;
+        if ((uchar) data[1] != UBX_SYNC2) return -1;
+        if (size < 6) return 0;
+
+        const int length = readU2((const uchar *) data + 4);
+        if (length > GNSS_MAX_UBX_PAYLOAD) return -1;
+        return (size < 8 + length) ? 0 : 8 + length;
+    }
+
+    return -1;
+}
+
+int GnssParser::missing(
+        const char *data,
+        int size)
+{
+    // UBX header first, then the rest of the message it describes
+    if (size < 6) return 6 - size;
+    return 8 + readU2((const uchar *) data + 4) - size;
+}
+
+int GnssParser::parse(
+        const char *data,
+        int size,
+        qint64 received,
+        GnssQueue &queue)
+{
+    const char *p = data;
+    const char *const end = data + size;
+    int pushed = 0;
+
+    // Complete a message left over from the last read, copying no more
+    // than it needs
+    while (partialSize > 0 && p < end)
+    {
+        int count;
+        if (partial[0] == '$')
+        {
+            const char *newline = (const char *) memchr(p, '\n', end - p);
+            count = (newline ? newline + 1 : end) - p;
+            if (partialSize + count > GNSS_MAX_NMEA)
+            {
+                partialSize = 0;
+                break;
+            }
+        }
+        else
+        {
+            count = qMin(missing(partial, partialSize), (int) (end - p));
+        }
+
+        memcpy(partial + partialSize, p, count);
+        partialSize += count;
+        p += count;
+
+        const int length = messageLength(partial, partialSize);
+        if (length < 0)
+        {
+            partialSize = 0;
+        }
+        else if (length > 0)
+        {
+            if (handle(partial, length, received, queue)) ++pushed;
+            partialSize = 0;
+        }
+    }
+
+    // Everything else is parsed in place
+    while (p < end)
+    {
+        if (*p != '$' && (uchar) *p != UBX_SYNC1)
+        {
+            ++p;
+            continue;
+        }
+
+        const int length = messageLength(p, end - p);
+        if (length > 0)
+        {
+            if (handle(p, length, received, queue)) ++pushed;
+            p += length;
+        }
+        else if (length == 0)
+        {
+            partialSize = end - p;
+            memcpy(partial, p, partialSize);
+            break;
+        }
+        else
+        {
+            ++p;
+        }
+    }
+
+    return pushed;
+}
+
+bool GnssParser::handle(
+        const char *message,
+        int size,
+        qint64 received,
+        GnssQueue &queue)
+{
+    if (message[0] == '$')
+    {
+        return handleNmea(message, size, received, queue);
+    }
+    else
+    {
+        return handleUbx(message, size, received, queue);
+    }
+}
+
+bool GnssParser::handleUbx(
+        const char *message,
+        int size,
+        qint64 received,
+        GnssQueue &queue)
+{
+    const uchar *m = (const uchar *) message;
+    const int length = size - 8;
+
+    // Fletcher checksum over class, ID, length and payload
+    uchar a = 0, b = 0;
+    for (int i = 2; i < 6 + length; ++i)
+    {
+        a += m[i];
+        b += a;
+    }
+
+    if (a != m[6 + length] || b != m[7 + length])
+    {
+        ++errorCount;
+        return false;
+    }
+
+    ++messageCount;
+
+    if (m[2] != UBX_NAV || m[3] != UBX_NAV_PVT || length < UBX_NAV_PVT_LEN)
+    {
+        return false;
+    }
+
+    const uchar *p = m + 6;
+
+    // Valid date and time, and a 3D fix
+    const uchar valid = p[11];
+    const uchar fixType = p[20];
+    const uchar flags = p[21];
+    if ((valid & 0x03) != 0x03) return false;
+    if (fixType != 3 && fixType != 4) return false;
+    if (!(flags & 0x01)) return false;
+
+    GnssFix fix;
+    fix.time = daysFromCivil(readU2(p + 4), p[6], p[7]) * 86400.
+            + p[8] * 3600 + p[9] * 60 + p[10]
+            + (qint32) readU4(p + 16) * 1e-9;
+    fix.lon = (qint32) readU4(p + 24) * 1e-7;
+    fix.lat = (qint32) readU4(p + 28) * 1e-7;
+    fix.hMSL = (qint32) readU4(p + 36) * 1e-3;
+    fix.hAcc = readU4(p + 40) * 1e-3;
+    fix.vAcc = readU4(p + 44) * 1e-3;
+    fix.velN = (qint32) readU4(p + 48) * 1e-3;
+    fix.velE = (qint32) readU4(p + 52) * 1e-3;
+    fix.velD = (qint32) readU4(p + 56) * 1e-3;
+    fix.sAcc = readU4(p + 68) * 1e-3;
+    fix.numSV = p[23];
+    fix.received = received;
+
+    return push(fix, queue);
+}
+
+bool GnssParser::handleNmea(
+        const char *message,
+        int size,
+        qint64 received,
+        GnssQueue &queue)
+{
+    // Checksum is the XOR of everything between '$' and '*'
+    const char *const end = message + size;
+    const char *star = 0;
+    uchar sum = 0;
+
+    for (const char *c = message + 1; c < end; ++c)
+    {
+        if (*c == '*')
+        {
+            star = c;
+            break;
+        }
+        sum ^= *c;
+    }
+
+    if (!star || end - star < 3
+            || hexDigit(star[1]) < 0 || hexDigit(star[2]) < 0
+            || sum != hexDigit(star[1]) * 16 + hexDigit(star[2]))
+    {
+        ++errorCount;
+        return false;
+    }
+
+    ++messageCount;
+
+    // Field i runs from starts[i] to starts[i + 1] - 1
+    const char *starts[NMEA_MAX_FIELDS + 1];
+    int count = 0;
+
+    starts[count++] = message + 1;
+    for (const char *c = message + 1; c < star && count < NMEA_MAX_FIELDS; ++c)
+    {
+        if (*c == ',') starts[count++] = c + 1;
+    }
+    starts[count] = star + 1;
+
+    // Talker ID, then sentence type
+    if (starts[1] - 1 - starts[0] != 5) return false;
+    const char *type = starts[0] + 2;
+
+#define FIELD(i) starts[i], starts[(i) + 1] - 1
+#define FIELD_CHAR(i) (starts[(i) + 1] - 1 > starts[i] ? *starts[i] : 0)
+
+    if (!memcmp(type, "GGA", 3))
+    {
+        if (count < 10) return false;
+
+        double timeOfDay, lat, lon, quality, numSV, hMSL;
+        if (!parseTimeOfDay(FIELD(1), timeOfDay)
+                || !parseCoordinate(FIELD(2), FIELD_CHAR(3), lat)
+                || !parseCoordinate(FIELD(4), FIELD_CHAR(5), lon)
+                || !parseNumber(FIELD(6), quality) || quality == 0
+                || !parseNumber(FIELD(7), numSV)
+                || !parseNumber(FIELD(9), hMSL))
+        {
+            haveGga = false;
+            return false;
+        }
+
+        nmea.lat = lat;
+        nmea.lon = lon;
+        nmea.hMSL = hMSL;
+        nmea.numSV = numSV;
+
+        haveGga = true;
+        ggaTime = timeOfDay;
+    }
+    else if (!memcmp(type, "RMC", 3))
+    {
+        if (count < 10) return false;
+
+        double timeOfDay, speed, course = 0, date;
+        if (FIELD_CHAR(2) != 'A'
+                || !parseTimeOfDay(FIELD(1), timeOfDay)
+                || !parseNumber(FIELD(7), speed)
+                || !parseNumber(FIELD(9), date))
+        {
+            haveRmc = false;
+            return false;
+        }
+
+        // Course is left empty by some receivers when stationary
+        parseNumber(FIELD(8), course);
+
+        const int ddmmyy = date;
+        nmea.day = daysFromCivil(2000 + ddmmyy % 100, ddmmyy / 100 % 100, ddmmyy / 10000) * 86400.;
+        nmea.velN = speed * KNOTS_TO_MPS * cos(course * DEG_TO_RAD);
+        nmea.velE = speed * KNOTS_TO_MPS * sin(course * DEG_TO_RAD);
+
+        haveRmc = true;
+        rmcTime = timeOfDay;
+    }
+    else
+    {
+        return false;
+    }
+
+#undef FIELD
+#undef FIELD_CHAR
+
+    if (!haveGga || !haveRmc || ggaTime != rmcTime) return false;
+
+    return pushNmea(received, queue);
+}
+
+bool GnssParser::pushNmea(
+        qint64 received,
+        GnssQueue &queue)
+{
+    GnssFix fix;
+    fix.time = nmea.day + ggaTime;
+    fix.lat = nmea.lat;
+    fix.lon = nmea.lon;
+    fix.hMSL = nmea.hMSL;
+    fix.velN = nmea.velN;
+    fix.velE = nmea.velE;
+    fix.hAcc = 0;
+    fix.vAcc = 0;
+    fix.sAcc = 0;
+    fix.numSV = nmea.numSV;
+    fix.received = received;
+
+    // NMEA has no vertical speed, so it comes from the altitude of
+    // consecutive fixes
+    const double dt = fix.time - prevTime;
+    fix.velD = (havePrevious && dt > 0 && dt < 2)
+            ? -(nmea.hMSL - prevAltitude) / dt
+            : 0;
+
+    havePrevious = true;
+    prevTime = fix.time;
+    prevAltitude = nmea.hMSL;
+
+    haveGga = false;
+    haveRmc = false;
+
+    return push(fix, queue);
+}
+
+bool GnssParser::push(
+        const GnssFix &fix,
+        GnssQueue &queue)
+{
+    if (!queue.push(fix))
+    {
+        ++droppedCount;
+        return false;
+    }
+
+    return true;
+}
+
+int GnssParser::encodeUbx(
+        const GnssFix &fix,
+        char *out)
+{
+    uchar *m = (uchar *) out;
+    memset(m, 0, 8 + UBX_NAV_PVT_LEN);
+
+    m[0] = UBX_SYNC1;
+    m[1] = UBX_SYNC2;
+    m[2] = UBX_NAV;
+    m[3] = UBX_NAV_PVT;
+    writeU2(m + 4, UBX_NAV_PVT_LEN);
+
+    uchar *p = m + 6;
+
+    const qint64 ms = llround(fix.time * 1000);
+    qint64 seconds = (ms >= 0 ? ms : ms - 999) / 1000;
+    const int nano = (ms - seconds * 1000) * 1000000;
+    const qint64 days = (seconds >= 0 ? seconds : seconds - 86399) / 86400;
+    const int secondOfDay = seconds - days * 86400;
+
+    int year, month, day;
+    civilFromDays(days, year, month, day);
+
+    // Time of week ignores leap seconds, which nothing here reads
+    const qint64 weekMs = 604800000;
+    writeU4(p + 0, ((ms - GPS_EPOCH * Q_INT64_C(1000)) % weekMs + weekMs) % weekMs);
+    writeU2(p + 4, year);
+    p[6] = month;
+    p[7] = day;
+    p[8] = secondOfDay / 3600;
+    p[9] = secondOfDay / 60 % 60;
+    p[10] = secondOfDay % 60;
+    p[11] = 0x07;
+    writeU4(p + 16, nano);
+    p[20] = 3;
+    p[21] = 0x01;
+    p[23] = fix.numSV;
+    writeU4(p + 24, (qint32) lround(fix.lon * 1e7));
+    writeU4(p + 28, (qint32) lround(fix.lat * 1e7));
+    writeU4(p + 32, (qint32) lround(fix.hMSL * 1e3));
+    writeU4(p + 36, (qint32) lround(fix.hMSL * 1e3));
+    writeU4(p + 40, lround(fix.hAcc * 1e3));
+    writeU4(p + 44, lround(fix.vAcc * 1e3));
+    writeU4(p + 48, (qint32) lround(fix.velN * 1e3));
+    writeU4(p + 52, (qint32) lround(fix.velE * 1e3));
+    writeU4(p + 56, (qint32) lround(fix.velD * 1e3));
+    writeU4(p + 60, lround(sqrt(fix.velN * fix.velN + fix.velE * fix.velE) * 1e3));
+
+    double heading = atan2(fix.velE, fix.velN) * RAD_TO_DEG;
+    if (heading < 0) heading += 360;
+    writeU4(p + 64, (qint32) lround(heading * 1e5));
+    writeU4(p + 68, lround(fix.sAcc * 1e3));
+
+    uchar a = 0, b = 0;
+    for (int i = 2; i < 6 + UBX_NAV_PVT_LEN; ++i)
+    {
+        a += m[i];
+        b += a;
+    }
+    m[6 + UBX_NAV_PVT_LEN] = a;
+    m[7 + UBX_NAV_PVT_LEN] = b;
+
+    return 8 + UBX_NAV_PVT_LEN;
+}
+
+// Wraps the body of a sentence with '$' and its checksum
+static int nmeaSentence(
+        char *out,
+        const char *body)
+{
+    uchar sum = 0;
+    for (const char *c = body; *c; ++c) sum ^= *c;
+    return sprintf(out, "$%s*%02X\r\n", body, sum);
+}
+
+// ddmm.mmmmm,H using integers only, as printf follows the locale
+static void formatCoordinate(
+        char *out,
+        double value,
+        int degreeDigits,
+        char positive,
+        char negative)
+{
+    const qint64 units = llround(fabs(value) * 60 * 100000);
+    const int degrees = units / 6000000;
+    const int minutes = units % 6000000;
+    sprintf(out, "%0*d%02d.%05d,%c", degreeDigits, degrees,
+            minutes / 100000, minutes % 100000,
+            value < 0 ? negative : positive);
+}
+
+int GnssParser::encodeNmea(
+        const GnssFix &fix,
+        char *out)
+{
+    const qint64 centiseconds = llround(fix.time * 100);
+    const qint64 days = (centiseconds >= 0 ? centiseconds : centiseconds - 8639999) / 8640000;
+    const int t = centiseconds - days * 8640000;
+
+    int year, month, day;
+    civilFromDays(days, year, month, day);
+
+    char lat[16], lon[16];
+    formatCoordinate(lat, fix.lat, 2, 'N', 'S');
+    formatCoordinate(lon, fix.lon, 3, 'E', 'W');
+
+    const int altitude = lround(fix.hMSL * 10);
+    const int knots = lround(sqrt(fix.velN * fix.velN + fix.velE * fix.velE)
+                             / KNOTS_TO_MPS * 100);
+
+    int course = lround(atan2(fix.velE, fix.velN) * RAD_TO_DEG * 10);
+    if (course < 0) course += 3600;
+
+    char body[GNSS_MAX_NMEA];
+    int size = 0;
+
+    sprintf(body, "GPGGA,%02d%02d%02d.%02d,%s,%s,1,%02d,1.0,%s%d.%d,M,0.0,M,,",
+            t / 360000, t / 6000 % 60, t / 100 % 60, t % 100,
+            lat, lon, fix.numSV,
+            altitude < 0 ? "-" : "", abs(altitude) / 10, abs(altitude) % 10);
+    size += nmeaSentence(out + size, body);
+
+    sprintf(body, "GPRMC,%02d%02d%02d.%02d,A,%s,%s,%d.%02d,%d.%d,%02d%02d%02d,,,A",
+            t / 360000, t / 6000 % 60, t / 100 % 60, t % 100,
+            lat, lon, knots / 100, knots % 100, course / 10, course % 10,
+            day, month, year % 100);
+    size += nmeaSentence(out + size, body);
+
+    return size;
+}
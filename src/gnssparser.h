@@ -0,0 +1,125 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef GNSSPARSER_H
+#define GNSSPARSER_H
+
+#include <QtGlobal>
+
+#include "spscqueue.h"
+
+// Longest NMEA sentence accepted, including "\r\n"
+#define GNSS_MAX_NMEA 96
+
+// Largest UBX payload accepted. Longer messages are skipped.
+#define GNSS_MAX_UBX_PAYLOAD 1024
+
+// Longest encoded fix (one NAV-PVT, or GGA and RMC sentences)
+#define GNSS_MAX_ENCODED (2 * GNSS_MAX_NMEA)
+
+class GnssFix
+{
+public:
+    double time;        // Seconds since epoch (UTC)
+    double lat;         // Degrees
+    double lon;         // Degrees
+    float hMSL;         // m
+    float velN;         // m/s
+    float velE;         // m/s
+    float velD;         // m/s
+    float hAcc;         // m, 0 if not reported
+    float vAcc;         // m, 0 if not reported
+    float sAcc;         // m/s, 0 if not reported
+    int numSV;
+    qint64 received;    // Arrival of the last byte (ns, receiver clock)
+};
+
+typedef SpscQueue< GnssFix > GnssQueue;
+
+// Incremental parser for NMEA (GGA and RMC) and UBX NAV-PVT. Messages
+// are parsed where they lie in each read. Only a message which is split
+// between two reads is copied, into a buffer of fixed size.
+class GnssParser
+{
+public:
+    GnssParser();
+
+    void reset();
+
+    // Parses bytes as they arrive, which may end part way through a
+    // message. Fixes are pushed to the queue stamped with the time the
+    // bytes arrived. Returns the number of fixes pushed.
+    int parse(const char *data, int size, qint64 received, GnssQueue &queue);
+
+    qint64 messages() const { return messageCount; }
+    qint64 errors() const { return errorCount; }    // Bad checksums
+    qint64 dropped() const { return droppedCount; } // Queue was full
+
+    // Write a fix as the receiver would, returning the number of bytes
+    static int encodeUbx(const GnssFix &fix, char *out);
+    static int encodeNmea(const GnssFix &fix, char *out);
+
+private:
+    typedef struct {
+        double timeOfDay;   // Seconds since midnight (UTC)
+        double day;         // Seconds since epoch of midnight
+        double lat;
+        double lon;
+        double hMSL;
+        double velN;
+        double velE;
+        int numSV;
+    } NmeaState;
+
+    // Start of a message split between reads
+    char partial[8 + GNSS_MAX_UBX_PAYLOAD];
+    int partialSize;
+
+    // Sentences are matched on time of day, as GGA carries position
+    // and RMC carries date and ground velocity
+    NmeaState nmea;
+    bool haveGga;
+    bool haveRmc;
+    double ggaTime;
+    double rmcTime;
+
+    // Previous GGA, for vertical speed
+    bool havePrevious;
+    double prevTime;
+    double prevAltitude;
+
+    qint64 messageCount;
+    qint64 errorCount;
+    qint64 droppedCount;
+
+    static int messageLength(const char *data, int size);
+    static int missing(const char *data, int size);
+
+    bool handle(const char *message, int size, qint64 received, GnssQueue &queue);
+    bool handleUbx(const char *message, int size, qint64 received, GnssQueue &queue);
+    bool handleNmea(const char *message, int size, qint64 received, GnssQueue &queue);
+    bool pushNmea(qint64 received, GnssQueue &queue);
+    bool push(const GnssFix &fix, GnssQueue &queue);
+};
+
+#endif // GNSSPARSER_H
@@ -0,0 +1,161 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "gnssreceiver.h"
+
+#include <QFile>
+
+#ifdef Q_OS_UNIX
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+GnssReceiver::GnssReceiver(
+        const QString &deviceName,
+        QObject *parent) :
+    QThread(parent),
+    device(deviceName),
+    fixes(GNSS_QUEUE_SIZE),
+    stopping(0),
+    notified(0),
+    messageCount(0),
+    errorCount(0),
+    droppedCount(0)
+{
+    timer.start();
+}
+
+GnssReceiver::~GnssReceiver()
+{
+    stop();
+    wait();
+}
+
+void GnssReceiver::stop()
+{
+    stopping.storeRelease(1);
+}
+
+void GnssReceiver::process(
+        const char *data,
+        int size,
+        qint64 received)
+{
+    const int pushed = parser.parse(data, size, received, fixes);
+
+    messageCount.storeRelease(parser.messages());
+    errorCount.storeRelease(parser.errors());
+    droppedCount.storeRelease(parser.dropped());
+
+    // One signal until the consumer catches up, however many reads
+    // arrive in the meantime
+    if (pushed > 0 && notified.testAndSetOrdered(0, 1))
+    {
+        emit fixesAvailable();
+    }
+}
+
+void GnssReceiver::run()
+{
+    char buffer[GNSS_READ_SIZE];
+
+#ifdef Q_OS_UNIX
+    const int fd = ::open(QFile::encodeName(device).constData(),
+                          O_RDONLY | O_NOCTTY | O_NONBLOCK);
+    if (fd < 0)
+    {
+        emit failed(tr("Couldn't open %1: %2")
+                    .arg(device).arg(QString::fromLocal8Bit(strerror(errno))));
+        return;
+    }
+
+    // Raw mode, so UBX passes through the line discipline untouched. USB
+    // receivers ignore the baud rate, and UART adapters keep their own.
+    if (isatty(fd))
+    {
+        struct termios options;
+        if (tcgetattr(fd, &options) == 0)
+        {
+            cfmakeraw(&options);
+            tcsetattr(fd, TCSANOW, &options);
+        }
+    }
+
+    while (!stopping.loadAcquire())
+    {
+        struct pollfd pending = { fd, POLLIN, 0 };
+        if (::poll(&pending, 1, GNSS_POLL_INTERVAL) <= 0) continue;
+
+        const ssize_t size = ::read(fd, buffer, sizeof(buffer));
+        const qint64 received = timer.nsecsElapsed();
+
+        if (size < 0)
+        {
+            if (errno == EAGAIN || errno == EINTR) continue;
+
+            emit failed(tr("Couldn't read %1: %2")
+                        .arg(device).arg(QString::fromLocal8Bit(strerror(errno))));
+            break;
+        }
+
+        // End of a recorded file
+        if (size == 0) break;
+
+        process(buffer, size, received);
+    }
+
+    ::close(fd);
+#else
+    // Reads block here, so stopping waits for the next bytes
+    QFile file(device);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Unbuffered))
+    {
+        emit failed(tr("Couldn't open %1: %2").arg(device).arg(file.errorString()));
+        return;
+    }
+
+    while (!stopping.loadAcquire())
+    {
+        const qint64 size = file.read(buffer, sizeof(buffer));
+        const qint64 received = timer.nsecsElapsed();
+
+        if (size < 0)
+        {
+            emit failed(tr("Couldn't read %1: %2").arg(device).arg(file.errorString()));
+            break;
+        }
+
+        if (size == 0)
+        {
+            if (file.atEnd()) break;
+            continue;
+        }
+
+        process(buffer, size, received);
+    }
+#endif
+}
@@ -0,0 +1,96 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef GNSSRECEIVER_H
+#define GNSSRECEIVER_H
+
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QString>
+#include <QThread>
+
+#include "gnssparser.h"
+
+// Fixes held for the consumer before they are dropped
+#define GNSS_QUEUE_SIZE 256
+
+// Bytes taken from the device per read
+#define GNSS_READ_SIZE 4096
+
+// How often the reader checks whether it should stop (ms)
+#define GNSS_POLL_INTERVAL 100
+
+// Reads a GNSS receiver on its own thread. Fixes are parsed as bytes
+// arrive and handed over through a lock-free queue, stamped with the
+// time of the read which completed them.
+class GnssReceiver : public QThread
+{
+    Q_OBJECT
+
+public:
+    explicit GnssReceiver(const QString &deviceName, QObject *parent = 0);
+    ~GnssReceiver();
+
+    QString deviceName() const { return device; }
+
+    // Read by the consumer thread only
+    GnssQueue &queue() { return fixes; }
+
+    // Clock used to stamp fixes (ns)
+    qint64 elapsed() const { return timer.nsecsElapsed(); }
+
+    // Called by the consumer before it empties the queue, so the next
+    // fix is announced again
+    void acknowledge() { notified.storeRelease(0); }
+
+    void stop();
+
+    int messages() const { return messageCount.loadAcquire(); }
+    int errors() const { return errorCount.loadAcquire(); }
+    int dropped() const { return droppedCount.loadAcquire(); }
+
+signals:
+    // Sent once per batch of fixes, until acknowledged
+    void fixesAvailable();
+    void failed(const QString &error);
+
+protected:
+    void run();
+
+private:
+    QString device;
+    GnssQueue fixes;
+    GnssParser parser;
+    QElapsedTimer timer;
+
+    QAtomicInt stopping;
+    QAtomicInt notified;
+
+    QAtomicInt messageCount;
+    QAtomicInt errorCount;
+    QAtomicInt droppedCount;
+
+    void process(const char *data, int size, qint64 received);
+};
+
+#endif // GNSSRECEIVER_H
@@ -0,0 +1,160 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "gnssreplay.h"
+
+#include <QElapsedTimer>
+
+#ifdef Q_OS_UNIX
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+#include "gnssparser.h"
+
+// Longest sleep between checks for stop (us)
+#define GNSS_REPLAY_SLEEP 10000
+
+GnssReplay::GnssReplay(
+        const Track &track,
+        Format format,
+        QObject *parent) :
+    QThread(parent),
+    track(track),
+    format(format),
+    master(-1),
+    slave(-1),
+    stopping(0)
+{
+
+}
+
+GnssReplay::~GnssReplay()
+{
+    stop();
+    wait();
+
+#ifdef Q_OS_UNIX
+    if (slave >= 0) ::close(slave);
+    if (master >= 0) ::close(master);
+#endif
+}
+
+bool GnssReplay::open()
+{
+#ifdef Q_OS_UNIX
+    master = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0)
+    {
+        error = tr("Couldn't create a pseudo-terminal: %1")
+                .arg(QString::fromLocal8Bit(strerror(errno)));
+        return false;
+    }
+
+    device = QString::fromLocal8Bit(ptsname(master));
+
+    // Held open so the terminal stays raw between readers, and writes
+    // don't fail while no one is reading
+    slave = ::open(ptsname(master), O_RDWR | O_NOCTTY);
+    if (slave < 0)
+    {
+        error = tr("Couldn't open %1: %2")
+                .arg(device).arg(QString::fromLocal8Bit(strerror(errno)));
+        return false;
+    }
+
+    struct termios options;
+    if (tcgetattr(slave, &options) == 0)
+    {
+        cfmakeraw(&options);
+        tcsetattr(slave, TCSANOW, &options);
+    }
+
+    return true;
+#else
+    error = tr("Replay needs pseudo-terminals, which this system doesn't have.");
+    return false;
+#endif
+}
+
+void GnssReplay::stop()
+{
+    stopping.storeRelease(1);
+}
+
+void GnssReplay::run()
+{
+#ifdef Q_OS_UNIX
+    if (master < 0 || track.isEmpty()) return;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    const double start = track.time[0];
+
+    for (int i = 0; i < track.size() && !stopping.loadAcquire(); ++i)
+    {
+        // Wait until the sample is due
+        const qint64 due = (track.time[i] - start) * 1e9;
+        qint64 remaining;
+        while ((remaining = due - timer.nsecsElapsed()) > 0 && !stopping.loadAcquire())
+        {
+            QThread::usleep(qMin(remaining / 1000, (qint64) GNSS_REPLAY_SLEEP));
+        }
+
+        GnssFix fix;
+        fix.time = track.time[i];
+        fix.lat = track.lat[i];
+        fix.lon = track.lon[i];
+        fix.hMSL = track.hMSL[i];
+        fix.velN = track.velN[i];
+        fix.velE = track.velE[i];
+        fix.velD = track.velD[i];
+        fix.hAcc = track.hAcc[i];
+        fix.vAcc = track.vAcc[i];
+        fix.sAcc = track.sAcc[i];
+        fix.numSV = track.numSV[i];
+        fix.received = 0;
+
+        char message[GNSS_MAX_ENCODED];
+        const int size = (format == Ubx)
+                ? GnssParser::encodeUbx(fix, message)
+                : GnssParser::encodeNmea(fix, message);
+
+        // Sent in pieces so the reader sees messages split across reads.
+        // If the terminal is full, no one is reading and the rest of the
+        // message is dropped.
+        for (int offset = 0; offset < size; offset += GNSS_REPLAY_CHUNK)
+        {
+            if (::write(master, message + offset, qMin(GNSS_REPLAY_CHUNK, size - offset)) < 0)
+            {
+                break;
+            }
+        }
+    }
+#endif
+}
@@ -0,0 +1,76 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef GNSSREPLAY_H
+#define GNSSREPLAY_H
+
+#include <QAtomicInt>
+#include <QString>
+#include <QThread>
+
+#include "track.h"
+
+// Bytes written at a time, like the FIFO of a serial adapter
+#define GNSS_REPLAY_CHUNK 32
+
+// Plays a track back in real time through a pseudo-terminal, encoded as
+// a receiver would send it, so live preview can be tried without one.
+class GnssReplay : public QThread
+{
+    Q_OBJECT
+
+public:
+    typedef enum {
+        Ubx = 0,
+        Nmea
+    } Format;
+
+    GnssReplay(const Track &track, Format format, QObject *parent = 0);
+    ~GnssReplay();
+
+    // Creates the pseudo-terminal. Returns false if it couldn't.
+    bool open();
+
+    // Device to read the replay from
+    QString deviceName() const { return device; }
+    QString errorString() const { return error; }
+
+    void stop();
+
+protected:
+    void run();
+
+private:
+    Track track;
+    Format format;
+
+    QString device;
+    QString error;
+
+    int master;
+    int slave;
+
+    QAtomicInt stopping;
+};
+
+#endif // GNSSREPLAY_H
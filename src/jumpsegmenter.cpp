@@ -0,0 +1,266 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "jumpsegmenter.h"
+
+#include <QObject>
+#include <QtConcurrentMap>
+
+#include <cmath>
+
+#include "track.h"
+#include "trackcache.h"
+
+// Speeds in m/s, with velD positive down
+#define CLIMB_SPEED         2.0     // Climbing faster than this
+#define EXIT_SPEED          10.0    // Falling faster than this
+#define DEPLOY_SPEED        20.0    // Total speed under canopy
+#define LANDED_SPEED        2.0     // Horizontal and vertical at rest
+
+// Time each phase must hold before it is accepted (s)
+#define CLIMB_HOLD          10.0
+#define FREEFALL_HOLD       2.0
+#define CANOPY_HOLD         3.0
+#define GROUND_HOLD         10.0
+
+// Furthest an exit is moved back to where the fall began (s)
+#define EXIT_BACKTRACK      5.0
+
+class SegmentFile
+{
+public:
+    typedef JumpSegmenter::Result result_type;
+
+    JumpSegmenter::Result operator()(const QString &fileName) const
+    {
+        return JumpSegmenter::segmentFile(fileName);
+    }
+};
+
+JumpSegmenter::JumpSegmenter()
+{
+
+}
+
+void JumpSegmenter::segment(
+        const Track &track)
+{
+    segmentList.clear();
+    jumpList.clear();
+
+    const int size = track.size();
+    if (size == 0) return;
+
+    const double *time = track.time.constData();
+    const float *velN = track.velN.constData();
+    const float *velE = track.velE.constData();
+    const float *velD = track.velD.constData();
+
+    Phase phase = Ground;
+    int begin = 0;
+
+    Phase pending = Ground;
+    int candidate = -1;
+
+    for (int i = 0; i < size; ++i)
+    {
+        const double h = sqrt(velN[i] * velN[i] + velE[i] * velE[i]);
+        const double v = velD[i];
+        const double total = sqrt(h * h + v * v);
+        const bool landed = h < LANDED_SPEED && fabs(v) < LANDED_SPEED;
+
+        // Phase suggested by this sample
+        Phase next = phase;
+        double hold = 0;
+
+        switch (phase)
+        {
+        case Ground:
+            if (v > EXIT_SPEED)         { next = Freefall; hold = FREEFALL_HOLD; }
+            else if (v < -CLIMB_SPEED)  { next = Climb; hold = CLIMB_HOLD; }
+            break;
+        case Climb:
+            if (v > EXIT_SPEED)         { next = Freefall; hold = FREEFALL_HOLD; }
+            else if (landed)            { next = Ground; hold = GROUND_HOLD; }
+            break;
+        case Freefall:
+            if (total < DEPLOY_SPEED)   { next = Canopy; hold = CANOPY_HOLD; }
+            break;
+        case Canopy:
+            if (landed)                 { next = Ground; hold = GROUND_HOLD; }
+            break;
+        }
+
+        if (next == phase)
+        {
+            candidate = -1;
+            continue;
+        }
+
+        if (candidate < 0 || pending != next)
+        {
+            candidate = i;
+            pending = next;
+        }
+
+        if (time[i] - time[candidate] < hold) continue;
+
+        int boundary = candidate;
+
+        // Exit is where the fall began to speed up
+        if (next == Freefall)
+        {
+            while (boundary > begin + 1
+                   && velD[boundary - 1] < velD[boundary]
+                   && time[candidate] - time[boundary - 1] <= EXIT_BACKTRACK)
+            {
+                --boundary;
+            }
+        }
+
+        addSegment(phase, begin, boundary);
+
+        phase = next;
+        begin = boundary;
+        candidate = -1;
+    }
+
+    addSegment(phase, begin, size);
+    updateJumps();
+}
+
+void JumpSegmenter::setSegments(
+        const Segments &segments)
+{
+    segmentList = segments;
+    updateJumps();
+}
+
+void JumpSegmenter::updateJumps()
+{
+    jumpList.clear();
+
+    // Each freefall starts a jump, which canopy and then ground end
+    Phase previous = Ground;
+    foreach (const Segment &segment, segmentList)
+    {
+        if (segment.phase == Freefall)
+        {
+            Jump jump;
+            jump.exit = segment.begin;
+            jump.deployment = -1;
+            jump.landing = -1;
+            jumpList.append(jump);
+        }
+        else if (!jumpList.isEmpty() && segment.phase == Canopy && previous == Freefall)
+        {
+            jumpList.last().deployment = segment.begin;
+        }
+        else if (!jumpList.isEmpty() && segment.phase == Ground && previous == Canopy)
+        {
+            jumpList.last().landing = segment.begin;
+        }
+
+        previous = segment.phase;
+    }
+}
+
+void JumpSegmenter::addSegment(
+        Phase phase,
+        int begin,
+        int end)
+{
+    if (end <= begin) return;
+
+    Segment segment;
+    segment.phase = phase;
+    segment.begin = begin;
+    segment.end = end;
+    segmentList.append(segment);
+}
+
+QFuture< JumpSegmenter::Result > JumpSegmenter::segmentFiles(
+        const QStringList &fileNames)
+{
+    // Each file is segmented on the global thread pool
+    return QtConcurrent::mapped(fileNames, SegmentFile());
+}
+
+JumpSegmenter::Result JumpSegmenter::segmentFile(
+        const QString &fileName)
+{
+    Result result;
+    result.fileName = fileName;
+
+    Track track;
+    TrackCache cache;
+    if (!cache.load(fileName, track))
+    {
+        result.error = cache.errorString();
+        return result;
+    }
+
+    JumpSegmenter segmenter;
+    cache.segment(track, segmenter);
+    result.jumps = segmenter.jumps();
+
+    return result;
+}
+
+int JumpSegmenter::jumpEnd(
+        const Jump &jump,
+        const Track &track)
+{
+    return (jump.landing >= 0) ? jump.landing : track.size();
+}
+
+int JumpSegmenter::freefallEnd(
+        const Jump &jump,
+        const Track &track)
+{
+    return (jump.deployment >= 0) ? jump.deployment : jumpEnd(jump, track);
+}
+
+int JumpSegmenter::landingSample(
+        const Track &track) const
+{
+    for (int i = jumpList.size() - 1; i >= 0; --i)
+    {
+        if (jumpList[i].landing >= 0) return jumpList[i].landing;
+    }
+
+    return track.size() - 1;
+}
+
+QString JumpSegmenter::phaseName(
+        Phase phase)
+{
+    switch (phase)
+    {
+    case Ground:   return QObject::tr("Ground");
+    case Climb:    return QObject::tr("Climb");
+    case Freefall: return QObject::tr("Freefall");
+    case Canopy:   return QObject::tr("Canopy");
+    default:       return QString();
+    }
+}
@@ -0,0 +1,109 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef JUMPSEGMENTER_H
+#define JUMPSEGMENTER_H
+
+#include <QFuture>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class Track;
+
+// Changed whenever segments change for the same track, so results cached
+// from them are rebuilt
+#define JUMP_SEGMENTER_VERSION 1
+
+// Splits a log into ground, climb, freefall and canopy phases in one pass
+// over the velocities. Each change of phase must hold for a few seconds
+// before it is accepted, and is then placed at the first sample which
+// showed it.
+class JumpSegmenter
+{
+public:
+    typedef enum {
+        Ground = 0,
+        Climb,
+        Freefall,
+        Canopy
+    } Phase;
+
+    typedef struct {
+        Phase phase;
+        int begin;
+        int end;            // One past the last sample
+    } Segment;
+
+    typedef QVector< Segment > Segments;
+
+    typedef struct {
+        int exit;
+        int deployment;     // -1 if not seen
+        int landing;        // -1 if not seen
+    } Jump;
+
+    typedef QVector< Jump > Jumps;
+
+    typedef struct {
+        QString fileName;
+        QString error;
+        Jumps jumps;
+    } Result;
+
+    JumpSegmenter();
+
+    void segment(const Track &track);
+
+    // Segments found earlier for the same track, from which jumps are
+    // rebuilt
+    void setSegments(const Segments &segments);
+
+    const Segments &segments() const { return segmentList; }
+    const Jumps &jumps() const { return jumpList; }
+
+    // Samples from exit to landing, or to the end of the track
+    static int jumpEnd(const Jump &jump, const Track &track);
+
+    // Samples from exit to deployment, or to the end of the jump
+    static int freefallEnd(const Jump &jump, const Track &track);
+
+    // Last landing seen, or the last sample if there was none
+    int landingSample(const Track &track) const;
+
+    static QString phaseName(Phase phase);
+
+    // Segments each track through the track cache, so its segments are
+    // stored for later use
+    static QFuture< Result > segmentFiles(const QStringList &fileNames);
+    static Result segmentFile(const QString &fileName);
+
+private:
+    Segments segmentList;
+    Jumps jumpList;
+
+    void addSegment(Phase phase, int begin, int end);
+    void updateJumps();
+};
+
+#endif // JUMPSEGMENTER_H
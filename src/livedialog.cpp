@@ -0,0 +1,294 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "livedialog.h"
+#include "ui_livedialog.h"
+
+#include <QDateTime>
+#include <QFileDialog>
+#include <QMessageBox>
+#include <QSettings>
+
+#include "gnssreceiver.h"
+#include "gnssreplay.h"
+#include "livesimulator.h"
+#include "track.h"
+#include "trackcache.h"
+
+// Alarms and speech kept in the event list
+#define LIVE_MAX_EVENTS 200
+
+LiveDialog::LiveDialog(
+        const Configuration &configuration,
+        QWidget *parent) :
+    QDialog(parent),
+    ui(new Ui::LiveDialog),
+    configuration(configuration),
+    simulator(new LiveSimulator(configuration)),
+    receiver(0),
+    replay(0)
+{
+    ui->setupUi(this);
+
+    ui->formatComboBox->addItem(tr("UBX NAV-PVT"));
+    ui->formatComboBox->addItem(tr("NMEA"));
+
+#ifndef Q_OS_UNIX
+    ui->formatComboBox->setEnabled(false);
+    ui->replayButton->setEnabled(false);
+#endif
+
+    // Initialize settings object
+    QSettings settings("FlySight", "Configurator");
+    ui->deviceEdit->setText(settings.value("gnssDevice").toString());
+
+    updateStatus();
+}
+
+LiveDialog::~LiveDialog()
+{
+    disconnectDevice();
+
+    delete simulator;
+    delete ui;
+}
+
+void LiveDialog::setConfiguration(
+        const Configuration &newConfiguration)
+{
+    configuration = newConfiguration;
+
+    // Alarm and tone state starts again from the next fix
+    delete simulator;
+    simulator = new LiveSimulator(configuration);
+}
+
+void LiveDialog::on_connectButton_clicked()
+{
+    if (receiver)
+    {
+        disconnectDevice();
+        return;
+    }
+
+    const QString deviceName = ui->deviceEdit->text().trimmed();
+    if (deviceName.isEmpty()) return;
+
+    // Remember the device for next time
+    QSettings settings("FlySight", "Configurator");
+    settings.setValue("gnssDevice", deviceName);
+
+    connectDevice(deviceName);
+}
+
+void LiveDialog::on_replayButton_clicked()
+{
+    // Initialize settings object
+    QSettings settings("FlySight", "Configurator");
+
+    const QString fileName = QFileDialog::getOpenFileName(
+                this,
+                tr("Replay Track"),
+                settings.value("logbookFolder").toString(),
+                tr("FlySight tracks (*.csv)"));
+
+    // Return now if user canceled
+    if (fileName.isEmpty()) return;
+
+    Track track;
+    TrackCache cache;
+    if (!cache.load(fileName, track))
+    {
+        QMessageBox::warning(this, tr("Replay Track"), cache.errorString());
+        return;
+    }
+
+    disconnectDevice();
+
+    replay = new GnssReplay(track, (GnssReplay::Format) ui->formatComboBox->currentIndex(), this);
+    if (!replay->open())
+    {
+        QMessageBox::warning(this, tr("Replay Track"), replay->errorString());
+        delete replay;
+        replay = 0;
+        return;
+    }
+
+    ui->deviceEdit->setText(replay->deviceName());
+    connectDevice(replay->deviceName());
+
+    replay->start();
+}
+
+void LiveDialog::connectDevice(
+        const QString &deviceName)
+{
+    receiver = new GnssReceiver(deviceName, this);
+
+    connect(receiver, SIGNAL(fixesAvailable()),
+            this, SLOT(readFixes()));
+    connect(receiver, SIGNAL(failed(QString)),
+            this, SLOT(receiverFailed(QString)));
+
+    latency.clear();
+    ui->eventList->clear();
+
+    receiver->start();
+
+    ui->connectButton->setText(tr("Disconnect"));
+    ui->deviceEdit->setEnabled(false);
+
+    updateStatus();
+}
+
+void LiveDialog::disconnectDevice()
+{
+    // Receiver first, so it isn't left reading a closed terminal
+    delete receiver;
+    receiver = 0;
+
+    delete replay;
+    replay = 0;
+
+    ui->connectButton->setText(tr("Connect"));
+    ui->deviceEdit->setEnabled(true);
+}
+
+void LiveDialog::receiverFailed(
+        const QString &error)
+{
+    disconnectDevice();
+    ui->statusLabel->setText(error);
+}
+
+void LiveDialog::readFixes()
+{
+    if (!receiver) return;
+
+    // Before the queue is emptied, so later fixes send another signal
+    receiver->acknowledge();
+
+    GnssFix fix;
+    bool updated = false;
+
+    while (receiver->queue().pop(fix))
+    {
+        simulator->process(fix);
+        latency.add((receiver->elapsed() - fix.received) / 1e6);
+        updated = true;
+    }
+
+    if (!updated) return;
+
+    showFix();
+    updateStatus();
+}
+
+void LiveDialog::showFix()
+{
+    const SimulationSample &sample = simulator->sample();
+    const Simulation &simulation = simulator->simulation();
+
+    switch (simulation.state[0])
+    {
+    case Simulation::Tone:
+        ui->toneLabel->setText(tr("%1% of range").arg(simulation.pitch[0] * 100, 0, 'f', 0));
+        ui->rateLabel->setText(simulation.rate[0] > 0
+                               ? tr("%1 beeps/s").arg(simulation.rate[0], 0, 'f', 2)
+                               : tr("Continuous"));
+        break;
+    case Simulation::ChirpUp:
+        ui->toneLabel->setText(tr("Chirp up"));
+        ui->rateLabel->clear();
+        break;
+    case Simulation::ChirpDown:
+        ui->toneLabel->setText(tr("Chirp down"));
+        ui->rateLabel->clear();
+        break;
+    default:
+        ui->toneLabel->setText(sample.silenced ? tr("Silenced") : tr("Silent"));
+        ui->rateLabel->clear();
+        break;
+    }
+
+    ui->altitudeLabel->setText(QString("%1 %2")
+                               .arg(configuration.valueToDistanceUnits(qRound(sample.altitude)))
+                               .arg(configuration.distanceUnits()));
+    ui->speedLabel->setText(tr("%1 %3 horizontal, %2 %3 vertical")
+                            .arg(configuration.valueToSpeedUnits(qRound(sample.horizontalSpeed)), 0, 'f', 1)
+                            .arg(configuration.valueToSpeedUnits(qRound(sample.verticalSpeed)), 0, 'f', 1)
+                            .arg(configuration.speedUnits()));
+
+    foreach (const AlarmEvaluator::Event &event, simulation.alarms)
+    {
+        const QDateTime time = QDateTime::fromMSecsSinceEpoch(
+                    qRound64(event.time * 1000), Qt::UTC);
+        ui->eventList->addItem(QString("%1  %2 %3")
+                               .arg(time.toString("hh:mm:ss.zzz"))
+                               .arg(AlarmEvaluator::eventName(event.type))
+                               .arg(event.index + 1));
+    }
+
+    foreach (const Simulation::Speech &speech, simulation.speech)
+    {
+        const QDateTime time = QDateTime::fromMSecsSinceEpoch(
+                    qRound64(speech.time * 1000), Qt::UTC);
+        ui->eventList->addItem(tr("%1  Speech \"%2\"")
+                               .arg(time.toString("hh:mm:ss.zzz"))
+                               .arg(Simulation::speechText(speech)));
+    }
+
+    if (!simulation.alarms.isEmpty() || !simulation.speech.isEmpty())
+    {
+        while (ui->eventList->count() > LIVE_MAX_EVENTS)
+        {
+            delete ui->eventList->takeItem(0);
+        }
+        ui->eventList->scrollToBottom();
+    }
+
+    simulator->clearEvents();
+}
+
+void LiveDialog::updateStatus()
+{
+    if (latency.isEmpty())
+    {
+        ui->latencyLabel->setText(tr("No fixes yet"));
+    }
+    else
+    {
+        ui->latencyLabel->setText(tr("%1 ms median, %2 ms 99th percentile over %3 fixes")
+                                  .arg(latency.quantile(0.5), 0, 'f', 2)
+                                  .arg(latency.quantile(0.99), 0, 'f', 2)
+                                  .arg(latency.count()));
+    }
+
+    if (receiver)
+    {
+        ui->statusLabel->setText(tr("%1 messages, %2 checksum errors, %3 fixes dropped")
+                                 .arg(receiver->messages())
+                                 .arg(receiver->errors())
+                                 .arg(receiver->dropped()));
+    }
+}
@@ -0,0 +1,79 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef LIVEDIALOG_H
+#define LIVEDIALOG_H
+
+#include <QDialog>
+
+#include "configuration.h"
+#include "quantilesketch.h"
+
+class GnssReceiver;
+class GnssReplay;
+class LiveSimulator;
+
+namespace Ui {
+class LiveDialog;
+}
+
+// Plays the tone for fixes from a GNSS receiver as they arrive, or from
+// a track replayed through a pseudo-terminal
+class LiveDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit LiveDialog(const Configuration &configuration,
+                        QWidget *parent = 0);
+    ~LiveDialog();
+
+public slots:
+    void setConfiguration(const Configuration &configuration);
+
+private slots:
+    void on_connectButton_clicked();
+    void on_replayButton_clicked();
+
+    void readFixes();
+    void receiverFailed(const QString &error);
+    void disconnectDevice();
+
+private:
+    Ui::LiveDialog *ui;
+
+    Configuration configuration;
+    LiveSimulator *simulator;
+
+    GnssReceiver *receiver;
+    GnssReplay *replay;
+
+    // Byte arrival to tone update (ms)
+    QuantileSketch latency;
+
+    void connectDevice(const QString &deviceName);
+    void showFix();
+    void updateStatus();
+};
+
+#endif // LIVEDIALOG_H
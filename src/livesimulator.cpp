@@ -0,0 +1,94 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "livesimulator.h"
+
+#include <QtAlgorithms>
+
+#include "alarmstage.h"
+#include "gnssparser.h"
+#include "sasstage.h"
+#include "speechstage.h"
+#include "tonestage.h"
+
+LiveSimulator::LiveSimulator(
+        const Configuration &configuration) :
+    configuration(configuration),
+    sas(0)
+{
+    track.resize(1);
+
+    // Same stages as SimulationGraph
+    if (configuration.adjustSpeed)
+    {
+        sas = new SasStage;
+        stages.append(sas);
+    }
+
+    stages.append(new AlarmStage(configuration));
+    stages.append(new ToneStage(configuration));
+    stages.append(new SpeechStage(configuration));
+
+    foreach (SimulationStage *stage, stages)
+    {
+        stage->start(result, track);
+    }
+}
+
+LiveSimulator::~LiveSimulator()
+{
+    qDeleteAll(stages);
+}
+
+void LiveSimulator::process(
+        const GnssFix &fix)
+{
+    track.time.data()[0] = fix.time;
+    track.lat.data()[0] = fix.lat;
+    track.lon.data()[0] = fix.lon;
+    track.hMSL.data()[0] = fix.hMSL;
+    track.velN.data()[0] = fix.velN;
+    track.velE.data()[0] = fix.velE;
+    track.velD.data()[0] = fix.velD;
+    track.hAcc.data()[0] = fix.hAcc;
+    track.vAcc.data()[0] = fix.vAcc;
+    track.sAcc.data()[0] = fix.sAcc;
+    track.numSV.data()[0] = fix.numSV;
+
+    // Use_SAS factors depend only on altitude, so starting the stage
+    // again just computes the factor for this fix
+    if (sas) sas->start(result, track);
+
+    current.extract(track, 0, configuration.groundElevation);
+
+    foreach (SimulationStage *stage, stages)
+    {
+        stage->process(current);
+    }
+}
+
+void LiveSimulator::clearEvents()
+{
+    result.alarms.clear();
+    result.speech.clear();
+}
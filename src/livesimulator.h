@@ -0,0 +1,68 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef LIVESIMULATOR_H
+#define LIVESIMULATOR_H
+
+#include <QVector>
+
+#include "configuration.h"
+#include "simulator.h"
+#include "track.h"
+
+class GnssFix;
+
+// Runs fixes through the simulator stages one at a time, as they arrive
+// from a receiver. Each fix is treated as sample 0 of a one-sample track.
+// Unlike SimulationGraph, velocities are not smoothed, since the
+// smoother needs samples from the future.
+class LiveSimulator
+{
+public:
+    explicit LiveSimulator(const Configuration &configuration);
+    ~LiveSimulator();
+
+    void process(const GnssFix &fix);
+
+    // Metrics of the last fix, after Use_SAS and alarms
+    const SimulationSample &sample() const { return current; }
+
+    // Tone of the last fix in pitch[0], rate[0] and state[0]. Alarms and
+    // speech accumulate until cleared.
+    const Simulation &simulation() const { return result; }
+    void clearEvents();
+
+private:
+    Configuration configuration;
+
+    Track track;
+    Simulation result;
+    SimulationSample current;
+
+    SimulationStage *sas;
+    QVector< SimulationStage * > stages;
+
+    Q_DISABLE_COPY(LiveSimulator)
+};
+
+#endif // LIVESIMULATOR_H
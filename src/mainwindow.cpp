@@ -24,31 +24,54 @@
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
 
+#include <QApplication>
+#include <QCheckBox>
 #include <QCloseEvent>
+#include <QComboBox>
 #include <QDebug>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QFileDialog>
+#include <QFutureWatcher>
 #include <QHBoxLayout>
+#include <QLineEdit>
 #include <QListWidget>
 #include <QMessageBox>
+#include <QProgressDialog>
 #include <QSettings>
+#include <QSpinBox>
 #include <QStackedWidget>
-#include <QTextStream>
+#include <QTableWidget>
 
 #include "alarmform.h"
+#include "alarmreportdialog.h"
+#include "altitudedialog.h"
 #include "altitudeform.h"
+#include "comparisondialog.h"
+#include "configurationfile.h"
+#include "configurationgenerator.h"
 #include "configurationpage.h"
+#include "configurationwriter.h"
+#include "elevationfiller.h"
+#include "elevationmodel.h"
 #include "generalform.h"
 #include "initializationform.h"
+#include "jumpsegmenter.h"
+#include "livedialog.h"
 #include "miscellaneousform.h"
 #include "rateform.h"
+#include "regressiondialog.h"
+#include "robustnessdialog.h"
 #include "silenceform.h"
 #include "speechform.h"
+#include "suggestdialog.h"
 #include "thresholdsform.h"
+#include "timezonefiller.h"
+#include "timezoneresolver.h"
 #include "toneform.h"
-
-#define MAX_ALARMS  10
-#define MAX_WINDOWS 2
+#include "trackbrowserdialog.h"
+#include "trackdialog.h"
+#include "trackreader.h"
 
 MainWindow::MainWindow(QWidget *parent) :
     QMainWindow(parent),
@@ -77,6 +100,35 @@ MainWindow::MainWindow(QWidget *parent) :
 
         connect(page, SIGNAL(selectionChanged()),
                 this, SLOT(updateConfigurationOptions()));
+        connect(page, SIGNAL(valuesEdited()),
+                this, SLOT(editConfiguration()));
+
+        // Watch for edits so open tracks can be simulated again
+        foreach(QLineEdit *edit, page->findChildren< QLineEdit* >())
+        {
+            connect(edit, SIGNAL(textEdited(QString)),
+                    this, SLOT(editConfiguration()));
+        }
+        foreach(QComboBox *combo, page->findChildren< QComboBox* >())
+        {
+            connect(combo, SIGNAL(activated(int)),
+                    this, SLOT(editConfiguration()));
+        }
+        foreach(QCheckBox *check, page->findChildren< QCheckBox* >())
+        {
+            connect(check, SIGNAL(clicked(bool)),
+                    this, SLOT(editConfiguration()));
+        }
+        foreach(QSpinBox *spin, page->findChildren< QSpinBox* >())
+        {
+            connect(spin, SIGNAL(valueChanged(int)),
+                    this, SLOT(editConfiguration()));
+        }
+        foreach(QTableWidget *table, page->findChildren< QTableWidget* >())
+        {
+            connect(table, SIGNAL(cellChanged(int,int)),
+                    this, SLOT(editConfiguration()));
+        }
     }
 
     ui->listWidget->setCurrentRow(0);
@@ -139,8 +191,7 @@ bool MainWindow::saveAs()
 bool MainWindow::loadFile(
         const QString &fileName)
 {
-    QFile file(fileName);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) return false;
+    if (!ConfigurationFile::load(fileName, configuration)) return false;
 
     // Initialize settings object
     QSettings settings("FlySight", "Configurator");
@@ -148,151 +199,234 @@ bool MainWindow::loadFile(
     // Remember last file read
     settings.setValue("folder", QFileInfo(fileName).absoluteFilePath());
 
-    // Reset configuration but keep units
-    configuration = Configuration(configuration.displayUnits);
+    // Update configuration
+    updatePages();
 
-    QTextStream in(&file);
-    while (!in.atEnd())
+    // Update file name
+    setCurrentFile(fileName);
+
+    return true;
+}
+
+bool MainWindow::saveFile(
+        const QString &fileName)
+{
+    // Update configuration
+    foreach(ConfigurationPage *page, pages)
     {
-        QString line = in.readLine();
+        page->updateConfiguration(configuration, ConfigurationPage::Values);
+    }
+
+    ConfigurationWriter writer;
+    if (!writer.save(fileName, configuration)) return false;
+
+    // Initialize settings object
+    QSettings settings("FlySight", "Configurator");
 
-        // Remove comments
-        line = line.left(line.indexOf(';'));
+    // Remember last file read
+    settings.setValue("folder", QFileInfo(fileName).absoluteFilePath());
 
-        // Split into key/value
-        QStringList cols = line.split(":");
-        if (cols.length() < 2) continue;
+    // Update file name
+    setCurrentFile(fileName);
 
-        QString name = cols[0].trimmed();
-        QString result = cols[1].trimmed();
-        int val = result.toInt();
+    return true;
+}
 
-#define HANDLE_VALUE(s,w,t)\
-if (!name.compare(s)) { (w) = (t) (val); }
+void MainWindow::setUnits(
+        int units)
+{
+    if (configuration.displayUnits == (Configuration::DisplayUnits) units)
+        return;
 
-        HANDLE_VALUE("Model", configuration.model, Configuration::Model);
-        HANDLE_VALUE("Rate", configuration.rate, int);
+    // Update configuration from pages
+    foreach(ConfigurationPage *page, pages)
+    {
+        page->updateConfiguration(configuration, ConfigurationPage::Values);
+    }
+
+    // Update display units
+    configuration.displayUnits = (Configuration::DisplayUnits) units;
+    ui->unitsComboBox->setCurrentIndex(units);
 
-        HANDLE_VALUE("Mode", configuration.toneMode, Configuration::Mode);
-        HANDLE_VALUE("Min", configuration.minTone, int);
-        HANDLE_VALUE("Max", configuration.maxTone, int);
-        HANDLE_VALUE("Limits", configuration.limits, Configuration::Limits);
-        HANDLE_VALUE("Volume", configuration.toneVolume, int);
+    // Update pages from configuration
+    updatePages();
+}
 
-        HANDLE_VALUE("Mode_2", configuration.rateMode, Configuration::Mode);
-        HANDLE_VALUE("Min_Val_2", configuration.minRateValue, int);
-        HANDLE_VALUE("Max_Val_2", configuration.maxRateValue, int);
-        HANDLE_VALUE("Min_Rate", configuration.minRate, int);
-        HANDLE_VALUE("Max_Rate", configuration.maxRate, int);
-        HANDLE_VALUE("Flatline", configuration.flatline, bool);
+void MainWindow::updateConfigurationOptions()
+{
+    if (updating) return;
 
-        HANDLE_VALUE("Sp_Rate", configuration.speechRate, int);
-        HANDLE_VALUE("Sp_Volume", configuration.speechVolume, int);
+    // Update configuration from pages
+    foreach(ConfigurationPage *page, pages)
+    {
+        page->updateConfiguration(configuration, ConfigurationPage::Values);
+    }
+    foreach(ConfigurationPage *page, pages)
+    {
+        page->updateConfiguration(configuration, ConfigurationPage::Options);
+    }
 
-        HANDLE_VALUE("V_Thresh", configuration.vThreshold, int);
-        HANDLE_VALUE("H_Thresh", configuration.hThreshold, int);
+    // Now update the configuration pages
+    updatePages();
+}
 
-        HANDLE_VALUE("Use_SAS", configuration.adjustSpeed, bool);
-        HANDLE_VALUE("TZ_Offset", configuration.timeZoneOffset, int);
+void MainWindow::updatePages()
+{
+    updating = true;
 
-        HANDLE_VALUE("Init_Mode", configuration.initMode, Configuration::InitMode);
+    // Update pages from configuration
+    foreach(ConfigurationPage *page, pages)
+    {
+        page->setConfiguration(configuration);
+    }
 
-        HANDLE_VALUE("Alt_Units", configuration.altitudeUnits, Configuration::AltitudeUnits);
-        HANDLE_VALUE("Alt_Step", configuration.altitudeStep, int);
+    updating = false;
 
-        HANDLE_VALUE("Window", configuration.alarmWindowAbove, int);
-        HANDLE_VALUE("Window", configuration.alarmWindowBelow, int);
-        HANDLE_VALUE("Win_Above", configuration.alarmWindowAbove, int);
-        HANDLE_VALUE("Win_Below", configuration.alarmWindowBelow, int);
-        HANDLE_VALUE("DZ_Elev", configuration.groundElevation, int);
+    emit configurationEdited(configuration);
+}
 
-#undef HANDLE_VALUE
+void MainWindow::editConfiguration()
+{
+    if (updating) return;
 
-        if (!name.compare("Config_Name"))
-        {
-            configuration.configName = result;
-        }
-        if (!name.compare("Config_Description"))
-        {
-            configuration.configDescription = result;
-        }
-        if (!name.compare("Config_Kind"))
-        {
-            configuration.configKind = result;
-        }
+    // Apply edits to a copy, leaving the pages as they are
+    Configuration edited = configuration;
+    foreach(ConfigurationPage *page, pages)
+    {
+        page->updateConfiguration(edited, ConfigurationPage::Values);
+    }
+    foreach(ConfigurationPage *page, pages)
+    {
+        page->updateConfiguration(edited, ConfigurationPage::Options);
+    }
 
-        if (!name.compare("Init_File"))
-        {
-            configuration.initFile = result;
-        }
+    emit configurationEdited(edited);
+}
 
-        if (!name.compare("Alarm_Elev") && configuration.alarms.length() < MAX_ALARMS)
-        {
-            Configuration::Alarm alarm;
-            alarm.elevation = val;
-            alarm.mode = Configuration::NoAlarm;
-            alarm.file = QString();
-            configuration.alarms.push_back(alarm);
-        }
-        if (!name.compare("Alarm_Type"))
-        {
-            configuration.alarms.back().mode = (Configuration::AlarmMode) val;
-        }
-        if (!name.compare("Alarm_File"))
-        {
-            configuration.alarms.back().file = result;
-        }
+void MainWindow::applyConfiguration(
+        const Configuration &newConfiguration)
+{
+    configuration = newConfiguration;
 
-        if (!name.compare("Win_Top") && configuration.windows.length() < MAX_WINDOWS)
-        {
-            Configuration::Window window;
-            window.top = val;
-            window.bottom = val;
-            configuration.windows.push_back(window);
-        }
-        if (!name.compare("Win_Bottom"))
-        {
-            configuration.windows.back().bottom = val;
-        }
+    // Update configuration
+    updatePages();
+}
 
-        if (!name.compare("Sp_Mode") && configuration.alarms.length() < MAX_ALARMS)
-        {
-            Configuration::Speech speech;
-            speech.mode = (Configuration::Mode) val;
-            speech.units = Configuration::Miles;
-            speech.decimals = 1;
-            configuration.speeches.push_back(speech);
-        }
-        if (!name.compare("Sp_Units"))
-        {
-            configuration.speeches.back().units = (Configuration::Units) val;
-        }
-        if (!name.compare("Sp_Dec"))
+void MainWindow::closeEvent(
+        QCloseEvent *event)
+{
+    if (maybeSave())
+    {
+        event->accept();
+    }
+    else
+    {
+        event->ignore();
+    }
+}
+
+void MainWindow::on_actionNew_triggered()
+{
+    if (maybeSave())
+    {
+        // Reset configuration but keep units
+        configuration = Configuration(configuration.displayUnits);
+
+        // Update configuration
+        updatePages();
+
+        // Initialize file name
+        setCurrentFile(QString());
+    }
+}
+
+void MainWindow::on_actionOpen_triggered()
+{
+    if (maybeSave())
+    {
+        // Initialize settings object
+        QSettings settings("FlySight", "Configurator");
+
+        QString fileName = QFileDialog::getOpenFileName(
+                    this,
+                    tr("Open"),
+                    settings.value("folder").toString(),
+                    tr("Configuration files (*.txt)"));
+
+        // Return now if user canceled
+        if (!fileName.isEmpty())
         {
-            configuration.speeches.back().decimals = (int) val;
+            // Open the configuration
+            loadFile(fileName);
         }
     }
+}
+
+void MainWindow::on_actionOpenProfile_triggered()
+{
+    if (!maybeSave()) return;
+
+    // Initialize settings object
+    QSettings settings("FlySight", "Configurator");
+
+    QString fileName = QFileDialog::getOpenFileName(
+                this,
+                tr("Open Profile"),
+                settings.value("folder").toString(),
+                tr("Configuration files (*.txt)"));
+
+    // Return now if user canceled
+    if (fileName.isEmpty()) return;
+
+    QString error;
+    const int id = profiles.load(fileName, error);
+    if (id < 0)
+    {
+        QMessageBox::warning(this, tr("Open Profile"), error);
+        return;
+    }
+
+    // Remember last file read
+    settings.setValue("folder", QFileInfo(fileName).absoluteFilePath());
+
+    const Configuration::DisplayUnits units = configuration.displayUnits;
+    configuration = profiles.resolve(id);
+    configuration.displayUnits = units;
 
     // Update configuration
     updatePages();
 
-    // Update file name
-    setCurrentFile(fileName);
+    // The profile holds only its overrides, so the resolved configuration
+    // is saved as a new file, and counts as modified until it is
+    setCurrentFile(QString());
+    savedConfiguration = Configuration(units);
+}
 
-    return true;
+void MainWindow::on_actionSave_triggered()
+{
+    save();
 }
 
-bool MainWindow::saveFile(
-        const QString &fileName)
+void MainWindow::on_actionSaveAs_triggered()
 {
-    QFile file(fileName);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) return false;
+    saveAs();
+}
 
+void MainWindow::on_actionCheckAlarms_triggered()
+{
     // Initialize settings object
     QSettings settings("FlySight", "Configurator");
 
-    // Remember last file read
-    settings.setValue("folder", QFileInfo(fileName).absoluteFilePath());
+    QString folder = QFileDialog::getExistingDirectory(
+                this,
+                tr("Logbook Folder"),
+                settings.value("logbookFolder").toString());
+
+    // Return now if user canceled
+    if (folder.isEmpty()) return;
+
+    // Remember last folder checked
+    settings.setValue("logbookFolder", folder);
 
     // Update configuration
     foreach(ConfigurationPage *page, pages)
@@ -300,378 +434,627 @@ bool MainWindow::saveFile(
         page->updateConfiguration(configuration, ConfigurationPage::Values);
     }
 
-    QTextStream out(&file);
-
-    out << "; For information on configuring FlySight, please go to" << endl;
-    out << ";     http://flysight.ca/wiki" << endl << endl;
-
-    out << "; GPS settings" << endl << endl;
-
-    out << "Config_Name:  " << configuration.configName.rightJustified(5) << " ; Configuration name" << endl;
-    out << "Config_Description:  " << configuration.configDescription.rightJustified(5) << " ; Configuration Description" << endl;
-    out << "Config_Kind:  " << configuration.configKind.rightJustified(5) << " ; Configuration kind. Allows to group configuration files together" << endl << endl;
-
-    out << "Model:      " << QString("%1").arg(configuration.model, 5) << " ; Dynamic model" << endl;
-    out << "                  ;   0 = Portable" << endl;
-    out << "                  ;   2 = Stationary" << endl;
-    out << "                  ;   3 = Pedestrian" << endl;
-    out << "                  ;   4 = Automotive" << endl;
-    out << "                  ;   5 = Sea" << endl;
-    out << "                  ;   6 = Airborne with < 1 G acceleration" << endl;
-    out << "                  ;   7 = Airborne with < 2 G acceleration" << endl;
-    out << "                  ;   8 = Airborne with < 4 G acceleration" << endl;
-    out << "Rate:       " << QString("%1").arg(configuration.rate, 5) << " ; Measurement rate (ms)" << endl << endl;
-
-    out << "; Tone settings" << endl << endl;
-
-    out << "Mode:       " << QString("%1").arg(configuration.toneMode, 5) << " ; Measurement mode" << endl;
-    out << "                  ;   0 = Horizontal speed" << endl;
-    out << "                  ;   1 = Vertical speed" << endl;
-    out << "                  ;   2 = Glide ratio" << endl;
-    out << "                  ;   3 = Inverse glide ratio" << endl;
-    out << "                  ;   4 = Total speed" << endl;
-    out << "                  ;   11 = Dive angle" << endl;
-    out << "Min:        " << QString("%1").arg(configuration.minTone, 5) << " ; Lowest pitch value" << endl;
-    out << "                  ;   cm/s        in Mode 0, 1, or 4" << endl;
-    out << "                  ;   ratio * 100 in Mode 2 or 3" << endl;
-    out << "                  ;   degrees     in Mode 11" << endl;
-    out << "Max:        " << QString("%1").arg(configuration.maxTone, 5) << " ; Highest pitch value" << endl;
-    out << "                  ;   cm/s        in Mode 0, 1, or 4" << endl;
-    out << "                  ;   ratio * 100 in Mode 2 or 3" << endl;
-    out << "                  ;   degrees     in Mode 11" << endl;
-    out << "Limits:     " << QString("%1").arg(configuration.limits, 5) << " ; Behaviour when outside bounds" << endl;
-    out << "                  ;   0 = No tone" << endl;
-    out << "                  ;   1 = Min/max tone" << endl;
-    out << "                  ;   2 = Chirp up/down" << endl;
-    out << "                  ;   3 = Chirp down/up" << endl;
-    out << "Volume:     " << QString("%1").arg(configuration.toneVolume, 5) << " ; 0 (min) to 8 (max)" << endl << endl;
-
-    out << "; Rate settings" << endl << endl;
-
-    out << "Mode_2:     " << QString("%1").arg(configuration.rateMode, 5) << " ; Determines tone rate" << endl;
-    out << "                  ;   0 = Horizontal speed" << endl;
-    out << "                  ;   1 = Vertical speed" << endl;
-    out << "                  ;   2 = Glide ratio" << endl;
-    out << "                  ;   3 = Inverse glide ratio" << endl;
-    out << "                  ;   4 = Total speed" << endl;
-    out << "                  ;   8 = Magnitude of Value 1" << endl;
-    out << "                  ;   9 = Change in Value 1" << endl;
-    out << "                  ;   11 = Dive angle" << endl;
-    out << "Min_Val_2:  " << QString("%1").arg(configuration.minRateValue, 5) << " ; Lowest rate value" << endl;
-    out << "                  ;   cm/s          when Mode 2 = 0, 1, or 4" << endl;
-    out << "                  ;   ratio * 100   when Mode 2 = 2 or 3" << endl;
-    out << "                  ;   percent * 100 when Mode 2 = 9" << endl;
-    out << "                  ;   degrees       when Mode 2 = 11" << endl;
-    out << "Max_Val_2:  " << QString("%1").arg(configuration.maxRateValue, 5) << " ; Highest rate value" << endl;
-    out << "                  ;   cm/s          when Mode 2 = 0, 1, or 4" << endl;
-    out << "                  ;   ratio * 100   when Mode 2 = 2 or 3" << endl;
-    out << "                  ;   percent * 100 when Mode 2 = 9" << endl;
-    out << "                  ;   degrees       when Mode 2 = 11" << endl;
-    out << "Min_Rate:   " << QString("%1").arg(configuration.minRate, 5) << " ; Minimum rate (Hz * 100)" << endl;
-    out << "Max_Rate:   " << QString("%1").arg(configuration.maxRate, 5) << " ; Maximum rate (Hz * 100)" << endl;
-    out << "Flatline:   " << QString("%1").arg(configuration.flatline, 5) << " ; Flatline at minimum rate" << endl;
-    out << "                  ;   0 = No" << endl;
-    out << "                  ;   1 = Yes" << endl << endl;
-
-    out << "; Speech settings" << endl << endl;
-
-    out << "Sp_Rate:    " << QString("%1").arg(configuration.speechRate, 5) << " ; Speech rate (s)" << endl;
-    out << "                  ;   0 = No speech" << endl;
-    out << "Sp_Volume:  " << QString("%1").arg(configuration.speechVolume, 5) << " ; 0 (min) to 8 (max)" << endl << endl;
-
-    if (configuration.speeches.empty())
-    {
-        Configuration::Speech speech;
-        speech.mode = Configuration::GlideRatio;
-        speech.units = Configuration::Miles;
-        speech.decimals = 1;
-        saveSpeech(out, speech, true);
-    }
-    else
-    {
-        bool firstSpeech = true;
-        foreach (Configuration::Speech speech, configuration.speeches)
-        {
-            saveSpeech(out, speech, firstSpeech);
-            firstSpeech = false;
-        }
-    }
+    AlarmReportDialog *dialog = new AlarmReportDialog(configuration, folder, this);
+    dialog->setAttribute(Qt::WA_DeleteOnClose);
+    dialog->show();
+}
 
-    out << "; Thresholds" << endl << endl;
+void MainWindow::on_actionSimulateTrack_triggered()
+{
+    // Initialize settings object
+    QSettings settings("FlySight", "Configurator");
 
-    out << "V_Thresh:   " << QString("%1").arg(configuration.vThreshold, 5) << " ; Minimum vertical speed for tone (cm/s)" << endl;
-    out << "H_Thresh:   " << QString("%1").arg(configuration.hThreshold, 5) << " ; Minimum horizontal speed for tone (cm/s)" << endl << endl;
+    QString fileName = QFileDialog::getOpenFileName(
+                this,
+                tr("Simulate Track"),
+                settings.value("logbookFolder").toString(),
+                tr("FlySight tracks (*.csv)"));
 
-    out << "; Miscellaneous" << endl << endl;
+    // Return now if user canceled
+    if (fileName.isEmpty()) return;
 
-    out << "Use_SAS:    " << QString("%1").arg(configuration.adjustSpeed, 5) << " ; Use skydiver's airspeed" << endl;
-    out << "                  ;   0 = No" << endl;
-    out << "                  ;   1 = Yes" << endl;
-    out << "TZ_Offset:  " << QString("%1").arg(configuration.timeZoneOffset, 5) << " ; Timezone offset of output files in seconds" << endl;
-    out << "                  ;   -14400 = UTC-4 (EDT)" << endl;
-    out << "                  ;   -18000 = UTC-5 (EST, CDT)" << endl;
-    out << "                  ;   -21600 = UTC-6 (CST, MDT)" << endl;
-    out << "                  ;   -25200 = UTC-7 (MST, PDT)" << endl;
-    out << "                  ;   -28800 = UTC-8 (PST)" << endl << endl;
+    simulateTrack(fileName);
+}
 
-    out << "; Initialization" << endl << endl;
+void MainWindow::on_actionBrowseLogbook_triggered()
+{
+    // Initialize settings object
+    QSettings settings("FlySight", "Configurator");
 
-    out << "Init_Mode:  " << QString("%1").arg(configuration.initMode, 5) << " ; When the FlySight is powered on" << endl;
-    out << "                  ;   0 = Do nothing" << endl;
-    out << "                  ;   1 = Test speech mode" << endl;
-    out << "                  ;   2 = Play file" << endl;
-    out << "Init_File:  " << configuration.initFile.rightJustified(5) << " ; File to be played" << endl << endl;
+    QString folder = QFileDialog::getExistingDirectory(
+                this,
+                tr("Logbook Folder"),
+                settings.value("logbookFolder").toString());
 
-    out << "; Alarm settings" << endl << endl;
+    // Return now if user canceled
+    if (folder.isEmpty()) return;
 
-    out << "; WARNING: GPS measurements depend on very weak signals" << endl;
-    out << ";          received from orbiting satellites. As such, they" << endl;
-    out << ";          are prone to interference, and should NEVER be" << endl;
-    out << ";          relied upon for life saving purposes." << endl << endl;
+    // Remember last folder browsed
+    settings.setValue("logbookFolder", folder);
 
-    out << ";          UNDER NO CIRCUMSTANCES SHOULD THESE ALARMS BE" << endl;
-    out << ";          USED TO INDICATE DEPLOYMENT OR BREAKOFF ALTITUDE." << endl << endl;
+    TrackBrowserDialog *dialog = new TrackBrowserDialog(folder, this);
+    dialog->setAttribute(Qt::WA_DeleteOnClose);
+    dialog->show();
 
-    out << "; NOTE:    Alarm elevations are given in meters above ground" << endl;
-    out << ";          elevation, which is specified in DZ_Elev." << endl << endl;
+    connect(dialog, SIGNAL(trackActivated(QString)),
+            this, SLOT(simulateTrack(QString)));
+}
 
-    out << "Window:     " << QString("%1").arg(configuration.alarmWindowAbove, 5) << " ; Alarm window (m)" << endl;
-    out << "Win_Above:  " << QString("%1").arg(configuration.alarmWindowAbove, 5) << " ; Alarm window (m)" << endl;
-    out << "Win_Below:  " << QString("%1").arg(configuration.alarmWindowBelow, 5) << " ; Alarm window (m)" << endl;
-    out << "DZ_Elev:    " << QString("%1").arg(configuration.groundElevation, 5) << " ; Ground elevation (m above sea level)" << endl << endl;
+void MainWindow::on_actionIndexJumps_triggered()
+{
+    // Initialize settings object
+    QSettings settings("FlySight", "Configurator");
+
+    QString folder = QFileDialog::getExistingDirectory(
+                this,
+                tr("Logbook Folder"),
+                settings.value("logbookFolder").toString());
+
+    // Return now if user canceled
+    if (folder.isEmpty()) return;
 
-    if (configuration.alarms.empty())
+    // Remember last folder indexed
+    settings.setValue("logbookFolder", folder);
+
+    const QStringList fileNames = TrackReader::findTracks(folder);
+    if (fileNames.isEmpty())
     {
-        Configuration::Alarm alarm;
-        alarm.elevation = 0;
-        alarm.mode = Configuration::NoAlarm;
-        alarm.file = "0";
-        saveAlarm(out, alarm, true);
+        QMessageBox::information(this, tr("FlySight Configurator"),
+                                 tr("No tracks found in %1.")
+                                 .arg(QDir::toNativeSeparators(folder)));
+        return;
     }
-    else
+
+    QProgressDialog progress(tr("Finding jumps..."), tr("Cancel"),
+                             0, fileNames.size(), this);
+    progress.setWindowModality(Qt::WindowModal);
+
+    // Segments are stored with the track cache, so later tools reuse them
+    QFutureWatcher< JumpSegmenter::Result > watcher;
+    connect(&watcher, SIGNAL(progressValueChanged(int)),
+            &progress, SLOT(setValue(int)));
+    connect(&watcher, SIGNAL(finished()),
+            &progress, SLOT(reset()));
+    connect(&progress, SIGNAL(canceled()),
+            &watcher, SLOT(cancel()));
+
+    watcher.setFuture(JumpSegmenter::segmentFiles(fileNames));
+    progress.exec();
+    watcher.waitForFinished();
+
+    int jumps = 0;
+    int indexed = 0;
+    QStringList details;
+    foreach (const JumpSegmenter::Result &result, watcher.future().results())
     {
-        bool firstAlarm = true;
-        foreach (Configuration::Alarm alarm, configuration.alarms)
+        const QString name = QDir::toNativeSeparators(result.fileName);
+        if (result.error.isEmpty())
         {
-            saveAlarm(out, alarm, firstAlarm);
-            firstAlarm = false;
+            details.append(tr("%1: %n jump(s)", 0, result.jumps.size()).arg(name));
+            jumps += result.jumps.size();
+            ++indexed;
+        }
+        else
+        {
+            details.append(tr("%1: %2").arg(name).arg(result.error));
         }
     }
 
-    out << "; Altitude mode settings" << endl << endl;
+    QMessageBox box(QMessageBox::Information, tr("FlySight Configurator"),
+                    tr("Found %1 jumps in %2 of %3 tracks.")
+                    .arg(jumps).arg(indexed).arg(fileNames.size()),
+                    QMessageBox::Ok, this);
+    box.setDetailedText(details.join("\n"));
+    box.exec();
+}
 
-    out << "; WARNING: GPS measurements depend on very weak signals" << endl;
-    out << ";          received from orbiting satellites. As such, they" << endl;
-    out << ";          are prone to interference, and should NEVER be" << endl;
-    out << ";          relied upon for life saving purposes." << endl << endl;
+void MainWindow::simulateTrack(
+        const QString &fileName)
+{
+    // Update configuration
+    foreach(ConfigurationPage *page, pages)
+    {
+        page->updateConfiguration(configuration, ConfigurationPage::Values);
+    }
 
-    out << ";          UNDER NO CIRCUMSTANCES SHOULD ALTITUDE MODE BE" << endl;
-    out << ";          USED TO INDICATE DEPLOYMENT OR BREAKOFF ALTITUDE." << endl << endl;
+    TrackDialog *dialog = new TrackDialog(configuration, fileName, this);
+    dialog->setAttribute(Qt::WA_DeleteOnClose);
+    dialog->show();
 
-    out << "; NOTE:    Altitude is given relative to ground elevation," << endl;
-    out << ";          which is specified in DZ_Elev. Altitude mode will" << endl;
-    out << ";          not function below 1500 m above ground." << endl << endl;;
+    // Simulate again as values are edited
+    connect(this, SIGNAL(configurationEdited(Configuration)),
+            dialog, SLOT(setConfiguration(Configuration)));
+}
 
-    out << "Alt_Units:  " << QString("%1").arg(configuration.altitudeUnits, 5) << " ; Altitude units" << endl;
-    out << "                  ;   0 = m" << endl;
-    out << "                  ;   1 = ft" << endl;
-    out << "Alt_Step:   " << QString("%1").arg(configuration.altitudeStep, 5) << " ; Altitude between announcements" << endl;
-    out << "                  ;   0 = No altitude" << endl << endl;
+void MainWindow::on_actionShowAltitudeProfile_triggered()
+{
+    // Initialize settings object
+    QSettings settings("FlySight", "Configurator");
 
-    out << "; Silence windows" << endl << endl;
+    QString fileName = QFileDialog::getOpenFileName(
+                this,
+                tr("Show Altitude Profile"),
+                settings.value("logbookFolder").toString(),
+                tr("FlySight tracks (*.csv)"));
 
-    out << "; NOTE:    Silence windows are given in meters above ground" << endl;
-    out << ";          elevation, which is specified in DZ_Elev. Tones" << endl;
-    out << ";          will be silenced during these windows and only" << endl;
-    out << ";          alarms will be audible." << endl << endl;
+    // Return now if user canceled
+    if (fileName.isEmpty()) return;
 
-    if (configuration.windows.empty())
-    {
-        Configuration::Window window;
-        window.top = 0;
-        window.bottom = 0;
-        saveWindow(out, window);
-    }
-    else
+    // Update configuration
+    foreach(ConfigurationPage *page, pages)
     {
-        foreach (Configuration::Window window, configuration.windows)
-        {
-            saveWindow(out, window);
-        }
+        page->updateConfiguration(configuration, ConfigurationPage::Values);
     }
 
-    // Update file name
-    setCurrentFile(fileName);
+    AltitudeDialog *dialog = new AltitudeDialog(configuration, fileName, this);
+    dialog->setAttribute(Qt::WA_DeleteOnClose);
+    dialog->show();
 
-    return true;
+    // Bands follow edits to the alarm and silence pages, and dragging a
+    // band edits the pages in turn
+    connect(this, SIGNAL(configurationEdited(Configuration)),
+            dialog, SLOT(setConfiguration(Configuration)));
+    connect(dialog, SIGNAL(configurationChanged(Configuration)),
+            this, SLOT(applyConfiguration(Configuration)));
 }
 
-void MainWindow::saveSpeech(
-        QTextStream &out,
-        const Configuration::Speech &speech,
-        bool firstSpeech)
+void MainWindow::on_actionCompareConfigurations_triggered()
 {
-    out << "Sp_Mode:    " << QString("%1").arg(speech.mode, 5) << " ; Speech mode" << endl;
-    if (firstSpeech)
+    // Initialize settings object
+    QSettings settings("FlySight", "Configurator");
+
+    QString trackFileName = QFileDialog::getOpenFileName(
+                this,
+                tr("Compare Configurations"),
+                settings.value("logbookFolder").toString(),
+                tr("FlySight tracks (*.csv)"));
+
+    // Return now if user canceled
+    if (trackFileName.isEmpty()) return;
+
+    QStringList fileNames = QFileDialog::getOpenFileNames(
+                this,
+                tr("Compare With"),
+                settings.value("folder").toString(),
+                tr("Configuration files (*.txt)"));
+
+    // Return now if user canceled
+    if (fileNames.isEmpty()) return;
+
+    // Update configuration
+    foreach(ConfigurationPage *page, pages)
     {
-        out << "                  ;   0 = Horizontal speed" << endl;
-        out << "                  ;   1 = Vertical speed" << endl;
-        out << "                  ;   2 = Glide ratio" << endl;
-        out << "                  ;   3 = Inverse glide ratio" << endl;
-        out << "                  ;   4 = Total speed" << endl;
-        out << "                  ;   5 = Altitude above DZ_Elev" << endl;
-        out << "                  ;   11 = Dive angle" << endl;
+        page->updateConfiguration(configuration, ConfigurationPage::Values);
     }
-    out << "Sp_Units:   " << QString("%1").arg(speech.units, 5) << " ; Speech units" << endl;
-    if (firstSpeech)
+
+    ComparisonDialog *dialog = new ComparisonDialog(configuration, trackFileName, fileNames, this);
+    dialog->setAttribute(Qt::WA_DeleteOnClose);
+    dialog->show();
+
+    // Compare again as values are edited
+    connect(this, SIGNAL(configurationEdited(Configuration)),
+            dialog, SLOT(setConfiguration(Configuration)));
+}
+
+void MainWindow::on_actionCompareInLogbook_triggered()
+{
+    // Initialize settings object
+    QSettings settings("FlySight", "Configurator");
+
+    QString fileNameA = QFileDialog::getOpenFileName(
+                this,
+                tr("Original Configuration"),
+                settings.value("folder").toString(),
+                tr("Configuration files (*.txt)"));
+
+    // Return now if user canceled
+    if (fileNameA.isEmpty()) return;
+
+    QString fileNameB = QFileDialog::getOpenFileName(
+                this,
+                tr("Changed Configuration"),
+                QFileInfo(fileNameA).absolutePath(),
+                tr("Configuration files (*.txt)"));
+
+    // Return now if user canceled
+    if (fileNameB.isEmpty()) return;
+
+    QString folder = QFileDialog::getExistingDirectory(
+                this,
+                tr("Logbook Folder"),
+                settings.value("logbookFolder").toString());
+
+    // Return now if user canceled
+    if (folder.isEmpty()) return;
+
+    // Remember last folder checked
+    settings.setValue("logbookFolder", folder);
+
+    // Update configuration
+    foreach(ConfigurationPage *page, pages)
     {
-        out << "                  ;   0 = km/h or m" << endl;
-        out << "                  ;   1 = mph or feet" << endl;
+        page->updateConfiguration(configuration, ConfigurationPage::Values);
     }
-    out << "Sp_Dec:     " << QString("%1").arg(speech.decimals, 5) << " ; Speech precision" << endl;
-    if (firstSpeech)
+
+    // Both are shown in the current display units
+    Configuration a(configuration.displayUnits);
+    Configuration b(configuration.displayUnits);
+    if (!ConfigurationFile::load(fileNameA, a) || !ConfigurationFile::load(fileNameB, b))
     {
-        out << "                  ;   Altitude step in Mode 5" << endl;
-        out << "                  ;   Decimal places in all other Modes" << endl;
+        QMessageBox::warning(this, tr("Compare Configurations in Logbook"),
+                             tr("Couldn't read the configuration files."));
+        return;
     }
-    out << endl;
+
+    RegressionDialog *dialog = new RegressionDialog(a, b, folder, this);
+    dialog->setWindowTitle(tr("%1 vs. %2")
+                           .arg(QFileInfo(fileNameA).fileName())
+                           .arg(QFileInfo(fileNameB).fileName()));
+    dialog->setAttribute(Qt::WA_DeleteOnClose);
+    dialog->show();
 }
 
-void MainWindow::saveAlarm(
-        QTextStream &out,
-        const Configuration::Alarm &alarm,
-        bool firstAlarm)
+void MainWindow::on_actionPreviewLive_triggered()
 {
-    out << "Alarm_Elev: " << QString("%1").arg(alarm.elevation, 5) << " ; Alarm elevation (m above ground level)" << endl;
-    out << "Alarm_Type: " << QString("%1").arg(alarm.mode, 5) << " ; Alarm type" << endl;
-    if (firstAlarm)
+    // Update configuration
+    foreach(ConfigurationPage *page, pages)
     {
-        out << "                  ;   0 = No alarm" << endl;
-        out << "                  ;   1 = Beep" << endl;
-        out << "                  ;   2 = Chirp up" << endl;
-        out << "                  ;   3 = Chirp down" << endl;
-        out << "                  ;   4 = Play file" << endl;
+        page->updateConfiguration(configuration, ConfigurationPage::Values);
     }
-    out << "Alarm_File: " << alarm.file.rightJustified(5) << " ; File to be played" << endl << endl;
-}
 
-void MainWindow::saveWindow(
-        QTextStream &out,
-        const Configuration::Window window)
-{
-    out << "Win_Top:    " << QString("%1").arg(window.top, 5) << " ; Silence window top (m)" << endl;
-    out << "Win_Bottom: " << QString("%1").arg(window.bottom, 5) << " ; Silence window bottom (m)" << endl << endl;
+    LiveDialog *dialog = new LiveDialog(configuration, this);
+    dialog->setAttribute(Qt::WA_DeleteOnClose);
+    dialog->show();
+
+    // Tone follows values as they are edited
+    connect(this, SIGNAL(configurationEdited(Configuration)),
+            dialog, SLOT(setConfiguration(Configuration)));
 }
 
-void MainWindow::setUnits(
-        int units)
+void MainWindow::on_actionCheckRobustness_triggered()
 {
-    if (configuration.displayUnits == (Configuration::DisplayUnits) units)
-        return;
+    // Initialize settings object
+    QSettings settings("FlySight", "Configurator");
 
-    // Update configuration from pages
+    QStringList fileNames = QFileDialog::getOpenFileNames(
+                this,
+                tr("Check Alarm Robustness"),
+                settings.value("logbookFolder").toString(),
+                tr("FlySight tracks (*.csv)"));
+
+    // Return now if user canceled
+    if (fileNames.isEmpty()) return;
+
+    // Update configuration
     foreach(ConfigurationPage *page, pages)
     {
         page->updateConfiguration(configuration, ConfigurationPage::Values);
     }
 
-    // Update display units
-    configuration.displayUnits = (Configuration::DisplayUnits) units;
-    ui->unitsComboBox->setCurrentIndex(units);
-
-    // Update pages from configuration
-    updatePages();
+    RobustnessDialog *dialog = new RobustnessDialog(configuration, fileNames, this);
+    dialog->setAttribute(Qt::WA_DeleteOnClose);
+    dialog->show();
 }
 
-void MainWindow::updateConfigurationOptions()
+void MainWindow::on_actionSuggestRanges_triggered()
 {
-    if (updating) return;
+    // Initialize settings object
+    QSettings settings("FlySight", "Configurator");
 
-    // Update configuration from pages
+    QString folder = QFileDialog::getExistingDirectory(
+                this,
+                tr("Logbook Folder"),
+                settings.value("logbookFolder").toString());
+
+    // Return now if user canceled
+    if (folder.isEmpty()) return;
+
+    // Remember last folder checked
+    settings.setValue("logbookFolder", folder);
+
+    // Update configuration
     foreach(ConfigurationPage *page, pages)
     {
         page->updateConfiguration(configuration, ConfigurationPage::Values);
     }
-    foreach(ConfigurationPage *page, pages)
+
+    SuggestDialog dialog(configuration, folder, this);
+    if (dialog.exec() == QDialog::Accepted)
     {
-        page->updateConfiguration(configuration, ConfigurationPage::Options);
+        configuration = dialog.suggestion();
+        updatePages();
     }
-
-    // Now update the configuration pages
-    updatePages();
 }
 
-void MainWindow::updatePages()
+void MainWindow::on_actionFillElevations_triggered()
 {
-    updating = true;
+    // Initialize settings object
+    QSettings settings("FlySight", "Configurator");
 
-    // Update pages from configuration
-    foreach(ConfigurationPage *page, pages)
+    QString folder = QFileDialog::getExistingDirectory(
+                this,
+                tr("Configuration Library"),
+                settings.value("libraryFolder").toString());
+
+    // Return now if user canceled
+    if (folder.isEmpty()) return;
+
+    // Remember last folder used
+    settings.setValue("libraryFolder", folder);
+
+    QString tileFolder = settings.value("elevationFolder").toString();
+    if (tileFolder.isEmpty() || !QDir(tileFolder).exists())
     {
-        page->setConfiguration(configuration);
+        tileFolder = QFileDialog::getExistingDirectory(
+                    this,
+                    tr("Elevation Tile Folder"),
+                    tileFolder);
+
+        // Return now if user canceled
+        if (tileFolder.isEmpty()) return;
+
+        settings.setValue("elevationFolder", tileFolder);
     }
 
-    updating = false;
-}
+    const QStringList fileNames = ConfigurationFile::find(folder);
+    if (fileNames.isEmpty())
+    {
+        QMessageBox::information(this, tr("FlySight Configurator"),
+                                 tr("No configurations found in %1.")
+                                 .arg(QDir::toNativeSeparators(folder)));
+        return;
+    }
 
-void MainWindow::closeEvent(
-        QCloseEvent *event)
-{
-    if (maybeSave())
+    if (QMessageBox::question(this, tr("FlySight Configurator"),
+                              tr("Set DZ_Elev in %n configuration(s) from the "
+                                 "landing point of the latest track beside each?",
+                                 0, fileNames.size()))
+            != QMessageBox::Yes)
     {
-        event->accept();
+        return;
     }
-    else
+
+    ElevationModel model;
+    model.setFolder(tileFolder);
+
+    QProgressDialog progress(tr("Filling ground elevation..."), tr("Cancel"),
+                             0, fileNames.size(), this);
+    progress.setWindowModality(Qt::WindowModal);
+
+    QFutureWatcher< ElevationFiller::Result > watcher;
+    connect(&watcher, SIGNAL(progressValueChanged(int)),
+            &progress, SLOT(setValue(int)));
+    connect(&watcher, SIGNAL(finished()),
+            &progress, SLOT(reset()));
+    connect(&progress, SIGNAL(canceled()),
+            &watcher, SLOT(cancel()));
+
+    watcher.setFuture(ElevationFiller::fillFiles(fileNames, &model));
+    progress.exec();
+    watcher.waitForFinished();
+
+    int filled = 0;
+    QStringList details;
+    foreach (const ElevationFiller::Result &result, watcher.future().results())
     {
-        event->ignore();
+        const QString name = QDir::toNativeSeparators(result.fileName);
+        if (result.error.isEmpty())
+        {
+            details.append(tr("%1: %2 m").arg(name).arg(result.elevation));
+            ++filled;
+        }
+        else
+        {
+            details.append(tr("%1: %2").arg(name).arg(result.error));
+        }
     }
+
+    QMessageBox box(QMessageBox::Information, tr("FlySight Configurator"),
+                    tr("Set DZ_Elev in %1 of %2 configurations.")
+                    .arg(filled).arg(fileNames.size()),
+                    QMessageBox::Ok, this);
+    box.setDetailedText(details.join("\n"));
+    box.exec();
 }
 
-void MainWindow::on_actionNew_triggered()
+void MainWindow::on_actionFillTimeZones_triggered()
 {
-    if (maybeSave())
+    // Initialize settings object
+    QSettings settings("FlySight", "Configurator");
+
+    QString folder = QFileDialog::getExistingDirectory(
+                this,
+                tr("Configuration Library"),
+                settings.value("libraryFolder").toString());
+
+    // Return now if user canceled
+    if (folder.isEmpty()) return;
+
+    // Remember last folder used
+    settings.setValue("libraryFolder", folder);
+
+    QString boundaryFile = settings.value("timeZoneFile").toString();
+    if (boundaryFile.isEmpty() || !QFile::exists(boundaryFile))
     {
-        // Reset configuration but keep units
-        configuration = Configuration(configuration.displayUnits);
+        boundaryFile = QFileDialog::getOpenFileName(
+                    this,
+                    tr("Time Zone Boundaries"),
+                    boundaryFile,
+                    tr("GeoJSON files (*.json *.geojson)"));
 
-        // Update configuration
-        updatePages();
+        // Return now if user canceled
+        if (boundaryFile.isEmpty()) return;
 
-        // Initialize file name
-        setCurrentFile(QString());
+        settings.setValue("timeZoneFile", boundaryFile);
     }
-}
 
-void MainWindow::on_actionOpen_triggered()
-{
-    if (maybeSave())
+    const QStringList fileNames = ConfigurationFile::find(folder);
+    if (fileNames.isEmpty())
     {
-        // Initialize settings object
-        QSettings settings("FlySight", "Configurator");
+        QMessageBox::information(this, tr("FlySight Configurator"),
+                                 tr("No configurations found in %1.")
+                                 .arg(QDir::toNativeSeparators(folder)));
+        return;
+    }
 
-        QString fileName = QFileDialog::getOpenFileName(
-                    this,
-                    tr("Open"),
-                    settings.value("folder").toString(),
-                    tr("Configuration files (*.txt)"));
+    if (QMessageBox::question(this, tr("FlySight Configurator"),
+                              tr("Set TZ_Offset in %n configuration(s) from the "
+                                 "first fix of the latest track beside each?",
+                                 0, fileNames.size()))
+            != QMessageBox::Yes)
+    {
+        return;
+    }
 
-        // Return now if user canceled
-        if (!fileName.isEmpty())
+    TimeZoneResolver resolver;
+
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    const bool loaded = resolver.load(boundaryFile);
+    QApplication::restoreOverrideCursor();
+
+    if (!loaded)
+    {
+        QMessageBox::warning(this, tr("FlySight Configurator"),
+                             tr("Cannot read time zone boundaries %1:\n%2.")
+                             .arg(QDir::toNativeSeparators(boundaryFile))
+                             .arg(resolver.errorString()));
+        return;
+    }
+
+    QProgressDialog progress(tr("Filling time zone offset..."), tr("Cancel"),
+                             0, fileNames.size(), this);
+    progress.setWindowModality(Qt::WindowModal);
+
+    QFutureWatcher< TimeZoneFiller::Result > watcher;
+    connect(&watcher, SIGNAL(progressValueChanged(int)),
+            &progress, SLOT(setValue(int)));
+    connect(&watcher, SIGNAL(finished()),
+            &progress, SLOT(reset()));
+    connect(&progress, SIGNAL(canceled()),
+            &watcher, SLOT(cancel()));
+
+    watcher.setFuture(TimeZoneFiller::fillFiles(fileNames, &resolver));
+    progress.exec();
+    watcher.waitForFinished();
+
+    int filled = 0;
+    QStringList details;
+    foreach (const TimeZoneFiller::Result &result, watcher.future().results())
+    {
+        const QString name = QDir::toNativeSeparators(result.fileName);
+        if (result.error.isEmpty())
         {
-            // Open the configuration
-            loadFile(fileName);
+            details.append(tr("%1: %2 s (%3)").arg(name).arg(result.offset)
+                           .arg(result.zone.isEmpty() ? tr("nautical") : result.zone));
+            ++filled;
+        }
+        else
+        {
+            details.append(tr("%1: %2").arg(name).arg(result.error));
         }
     }
-}
 
-void MainWindow::on_actionSave_triggered()
-{
-    save();
+    QMessageBox box(QMessageBox::Information, tr("FlySight Configurator"),
+                    tr("Set TZ_Offset in %1 of %2 configurations.")
+                    .arg(filled).arg(fileNames.size()),
+                    QMessageBox::Ok, this);
+    box.setDetailedText(details.join("\n"));
+    box.exec();
 }
 
-void MainWindow::on_actionSaveAs_triggered()
+void MainWindow::on_actionGenerateVariants_triggered()
 {
-    saveAs();
+    // Update configuration
+    foreach(ConfigurationPage *page, pages)
+    {
+        page->updateConfiguration(configuration, ConfigurationPage::Values);
+    }
+
+    // Initialize settings object
+    QSettings settings("FlySight", "Configurator");
+
+    QString tableFile = QFileDialog::getOpenFileName(
+                this,
+                tr("Variant Table"),
+                settings.value("variantTable").toString(),
+                tr("CSV files (*.csv)"));
+
+    // Return now if user canceled
+    if (tableFile.isEmpty()) return;
+
+    // Remember last table used
+    settings.setValue("variantTable", tableFile);
+
+    ConfigurationGenerator::Variants variants;
+    QString error;
+    if (!ConfigurationGenerator::readTable(tableFile, variants, error))
+    {
+        QMessageBox::warning(this, tr("FlySight Configurator"),
+                             tr("Cannot read variant table %1:\n%2")
+                             .arg(QDir::toNativeSeparators(tableFile))
+                             .arg(error));
+        return;
+    }
+
+    if (variants.isEmpty())
+    {
+        QMessageBox::information(this, tr("FlySight Configurator"),
+                                 tr("No variants found in %1.")
+                                 .arg(QDir::toNativeSeparators(tableFile)));
+        return;
+    }
+
+    QString folder = QFileDialog::getExistingDirectory(
+                this,
+                tr("Configuration Library"),
+                settings.value("libraryFolder").toString());
+
+    // Return now if user canceled
+    if (folder.isEmpty()) return;
+
+    // Remember last folder used
+    settings.setValue("libraryFolder", folder);
+
+    QProgressDialog progress(tr("Writing configurations..."), tr("Cancel"),
+                             0, variants.size(), this);
+    progress.setWindowModality(Qt::WindowModal);
+
+    // Progress is counted in chunks of variants
+    QFutureWatcher< ConfigurationGenerator::Result > watcher;
+    connect(&watcher, SIGNAL(progressRangeChanged(int,int)),
+            &progress, SLOT(setRange(int,int)));
+    connect(&watcher, SIGNAL(progressValueChanged(int)),
+            &progress, SLOT(setValue(int)));
+    connect(&watcher, SIGNAL(finished()),
+            &progress, SLOT(reset()));
+    connect(&progress, SIGNAL(canceled()),
+            &watcher, SLOT(cancel()));
+
+    QElapsedTimer timer;
+    timer.start();
+
+    watcher.setFuture(ConfigurationGenerator::generate(variants, configuration, folder));
+    progress.exec();
+    watcher.waitForFinished();
+
+    const double seconds = timer.nsecsElapsed() / 1e9;
+
+    int written = 0;
+    QStringList details;
+    foreach (const ConfigurationGenerator::Result &result, watcher.future().results())
+    {
+        written += result.written;
+        details.append(result.errors);
+    }
+
+    QMessageBox box(QMessageBox::Information, tr("FlySight Configurator"),
+                    tr("Wrote %1 of %2 configurations in %3 s (%4 files/s).")
+                    .arg(written).arg(variants.size())
+                    .arg(seconds, 0, 'f', 2)
+                    .arg(seconds > 0 ? written / seconds : 0, 0, 'f', 0),
+                    QMessageBox::Ok, this);
+    box.setDetailedText(details.join("\n"));
+    box.exec();
 }
 
 void MainWindow::setCurrentFile(
@@ -27,9 +27,9 @@
 #include <QMainWindow>
 
 #include "configuration.h"
+#include "configurationprofiles.h"
 
 class ConfigurationPage;
-class QTextStream;
 
 namespace Ui {
 class MainWindow;
@@ -50,6 +50,10 @@ public:
 
     Units units() const { return currentUnits; }
 
+signals:
+    // Sent as values are edited, before they are committed to the file
+    void configurationEdited(const Configuration &configuration);
+
 protected:
     void closeEvent(QCloseEvent *event);
 
@@ -67,28 +71,45 @@ private:
 
     QString curFile;
 
+    // Profiles opened so far, kept so that reopening one only resolves
+    // what changed on disk
+    ConfigurationProfiles profiles;
+
     bool save();
     bool saveAs();
 
     bool loadFile(const QString &fileName);
     bool saveFile(const QString &fileName);
 
-    void saveSpeech(QTextStream &out, const Configuration::Speech &speech, bool firstSpeech);
-    void saveAlarm(QTextStream &out, const Configuration::Alarm &alarm, bool firstAlarm);
-    void saveWindow(QTextStream &out, const Configuration::Window window);
-
     void setCurrentFile(const QString &fileName);
     bool maybeSave();
 
 private slots:
     void on_actionNew_triggered();
     void on_actionOpen_triggered();
+    void on_actionOpenProfile_triggered();
     void on_actionSave_triggered();
     void on_actionSaveAs_triggered();
+    void on_actionCheckAlarms_triggered();
+    void on_actionSimulateTrack_triggered();
+    void on_actionBrowseLogbook_triggered();
+    void on_actionIndexJumps_triggered();
+    void on_actionShowAltitudeProfile_triggered();
+    void on_actionCompareConfigurations_triggered();
+    void on_actionCompareInLogbook_triggered();
+    void on_actionPreviewLive_triggered();
+    void on_actionCheckRobustness_triggered();
+    void on_actionSuggestRanges_triggered();
+    void on_actionFillElevations_triggered();
+    void on_actionFillTimeZones_triggered();
+    void on_actionGenerateVariants_triggered();
 
     void setUnits(int newUnits);
     void updatePages();
     void updateConfigurationOptions();
+    void editConfiguration();
+    void applyConfiguration(const Configuration &newConfiguration);
+    void simulateTrack(const QString &fileName);
 };
 
 #endif // MAINWINDOW_H
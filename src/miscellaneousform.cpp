@@ -25,12 +25,17 @@
 #include "ui_miscellaneousform.h"
 
 #include "configuration.h"
+#include "timezonedialog.h"
 
 MiscellaneousForm::MiscellaneousForm(QWidget *parent) :
     ConfigurationPage(parent),
     ui(new Ui::MiscellaneousForm)
 {
     ui->setupUi(this);
+
+    // Fill offset from time zone boundaries
+    connect(ui->timezoneButton, SIGNAL(clicked(bool)),
+            this, SLOT(lookUpTimeZone()));
 }
 
 MiscellaneousForm::~MiscellaneousForm()
@@ -38,6 +43,18 @@ MiscellaneousForm::~MiscellaneousForm()
     delete ui;
 }
 
+void MiscellaneousForm::lookUpTimeZone()
+{
+    TimeZoneDialog dialog(&resolver, this);
+    if (dialog.exec() != QDialog::Accepted) return;
+
+    const QString text = QString::number(dialog.offset());
+    ui->timezoneEdit->setText(text);
+
+    // Open tracks are simulated again, as for a typed value
+    emit valuesEdited();
+}
+
 void MiscellaneousForm::setConfiguration(
         const Configuration &configuration)
 {
@@ -25,6 +25,7 @@
 #define MISCELLANEOUSFORM_H
 
 #include "configurationpage.h"
+#include "timezoneresolver.h"
 
 namespace Ui {
 class MiscellaneousForm;
@@ -46,6 +47,12 @@ public:
 
 private:
     Ui::MiscellaneousForm *ui;
+
+    // Kept so boundaries are only read once
+    TimeZoneResolver resolver;
+
+private slots:
+    void lookUpTimeZone();
 };
 
 #endif // MISCELLANEOUSFORM_H
@@ -0,0 +1,253 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "quantilesketch.h"
+
+#include <QDataStream>
+#include <QPair>
+#include <QtMath>
+
+#include <algorithm>
+
+#include "counterrng.h"
+
+// Ratio between the capacities of neighbouring levels
+#define SKETCH_DECAY (2. / 3.)
+
+// Fewest values a level may hold
+#define SKETCH_MIN_CAPACITY 2
+
+static bool weightedLessThan(
+        const QPair< float, qint64 > &a,
+        const QPair< float, qint64 > &b)
+{
+    return a.first < b.first;
+}
+
+QuantileSketch::QuantileSketch(
+        int k) :
+    k(k),
+    n(0),
+    compactions(0)
+{
+    levels.resize(1);
+}
+
+void QuantileSketch::clear()
+{
+    n = 0;
+    compactions = 0;
+
+    levels.clear();
+    levels.resize(1);
+}
+
+void QuantileSketch::add(
+        float value)
+{
+    levels[0].append(value);
+    ++n;
+
+    if (levels[0].size() >= capacity(0))
+    {
+        compress();
+    }
+}
+
+void QuantileSketch::merge(
+        const QuantileSketch &other)
+{
+    if (other.levels.size() > levels.size())
+    {
+        levels.resize(other.levels.size());
+    }
+
+    for (int h = 0; h < other.levels.size(); ++h)
+    {
+        levels[h] += other.levels[h];
+    }
+
+    n += other.n;
+    compactions += other.compactions;
+
+    compress();
+}
+
+int QuantileSketch::capacity(
+        int level) const
+{
+    // Top level gets k, shrinking geometrically towards level 0
+    const int depth = levels.size() - 1 - level;
+    return qMax(SKETCH_MIN_CAPACITY, qCeil(k * qPow(SKETCH_DECAY, depth)));
+}
+
+int QuantileSketch::retained() const
+{
+    int size = 0;
+    foreach (const QVector< float > &level, levels)
+    {
+        size += level.size();
+    }
+    return size;
+}
+
+void QuantileSketch::compress()
+{
+    for (;;)
+    {
+        int total = 0;
+        for (int h = 0; h < levels.size(); ++h)
+        {
+            total += capacity(h);
+        }
+
+        if (retained() < total) return;
+
+        // Compact the lowest level that is full
+        for (int h = 0; h < levels.size(); ++h)
+        {
+            if (levels[h].size() >= capacity(h))
+            {
+                compact(h);
+                break;
+            }
+        }
+    }
+}
+
+void QuantileSketch::compact(
+        int level)
+{
+    if (level + 1 == levels.size())
+    {
+        levels.resize(levels.size() + 1);
+    }
+
+    QVector< float > &values = levels[level];
+    std::sort(values.begin(), values.end());
+
+    // An odd value out stays behind
+    float leftover = 0;
+    const bool odd = values.size() % 2;
+    if (odd)
+    {
+        leftover = values.last();
+        values.removeLast();
+    }
+
+    // Keep the odd or even values, chosen by a counter-based coin rather
+    // than a shared generator. The same adds and merges in the same order
+    // always give the same sketch, but a different merge order can keep
+    // different values.
+    const int offset = CounterRng(n, level).bits(compactions++) & 1;
+
+    QVector< float > &next = levels[level + 1];
+    for (int i = offset; i < values.size(); i += 2)
+    {
+        next.append(values[i]);
+    }
+
+    values.clear();
+    if (odd) values.append(leftover);
+}
+
+float QuantileSketch::quantile(
+        double q) const
+{
+    if (n == 0) return 0;
+
+    QVector< QPair< float, qint64 > > weighted;
+    weighted.reserve(retained());
+
+    for (int h = 0; h < levels.size(); ++h)
+    {
+        foreach (float value, levels[h])
+        {
+            weighted.append(qMakePair(value, (qint64) 1 << h));
+        }
+    }
+
+    std::sort(weighted.begin(), weighted.end(), weightedLessThan);
+
+    qint64 total = 0;
+    for (int i = 0; i < weighted.size(); ++i)
+    {
+        total += weighted[i].second;
+    }
+
+    const double target = qBound(0., q, 1.) * total;
+
+    qint64 cumulative = 0;
+    for (int i = 0; i < weighted.size(); ++i)
+    {
+        cumulative += weighted[i].second;
+        if (cumulative >= target) return weighted[i].first;
+    }
+
+    return weighted.last().first;
+}
+
+QDataStream &operator<<(
+        QDataStream &out,
+        const QuantileSketch &sketch)
+{
+    out << (qint32) sketch.k << sketch.n << sketch.compactions
+        << (qint32) sketch.levels.size();
+
+    foreach (const QVector< float > &level, sketch.levels)
+    {
+        out << (qint32) level.size();
+        foreach (float value, level)
+        {
+            out << value;
+        }
+    }
+
+    return out;
+}
+
+QDataStream &operator>>(
+        QDataStream &in,
+        QuantileSketch &sketch)
+{
+    qint32 k, levelCount;
+    in >> k >> sketch.n >> sketch.compactions >> levelCount;
+
+    sketch.k = k;
+    sketch.levels.resize(qMax(levelCount, 1));
+
+    for (int h = 0; h < levelCount && in.status() == QDataStream::Ok; ++h)
+    {
+        qint32 size;
+        in >> size;
+
+        QVector< float > &level = sketch.levels[h];
+        level.resize(qMax(size, 0));
+        for (int i = 0; i < level.size(); ++i)
+        {
+            in >> level[i];
+        }
+    }
+
+    return in;
+}
@@ -0,0 +1,70 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef QUANTILESKETCH_H
+#define QUANTILESKETCH_H
+
+#include <QVector>
+
+class QDataStream;
+
+// Default accuracy parameter. Rank error is about 1.7 / SKETCH_K.
+#define SKETCH_K 200
+
+// KLL quantile sketch. Values are kept in levels where each level's
+// values stand for twice as many samples as the level below, and full
+// levels are compacted by keeping every other sorted value. Memory stays
+// about 3 * k values however many samples are added, and two sketches
+// can be merged.
+class QuantileSketch
+{
+public:
+    explicit QuantileSketch(int k = SKETCH_K);
+
+    void add(float value);
+    void merge(const QuantileSketch &other);
+    void clear();
+
+    qint64 count() const { return n; }
+    bool isEmpty() const { return n == 0; }
+
+    // Approximate value with the fraction q of samples below it
+    float quantile(double q) const;
+
+    friend QDataStream &operator<<(QDataStream &out, const QuantileSketch &sketch);
+    friend QDataStream &operator>>(QDataStream &in, QuantileSketch &sketch);
+
+private:
+    int k;
+    qint64 n;
+    quint64 compactions;
+
+    QVector< QVector< float > > levels;
+
+    int capacity(int level) const;
+    int retained() const;
+    void compress();
+    void compact(int level);
+};
+
+#endif // QUANTILESKETCH_H
@@ -0,0 +1,127 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "rangestatistics.h"
+
+RangeStatistics::RangeStatistics() :
+    limit(0)
+{
+
+}
+
+static double interval(
+        const double *time,
+        int i,
+        int size)
+{
+    const double dt = (i + 1 < size) ? time[i + 1] - time[i] : 0;
+    return (dt > STATISTICS_MAX_GAP) ? 0 : dt;
+}
+
+void RangeStatistics::build(
+        const TrackColumn< double > &newTime,
+        const TrackColumn< float > &newValues,
+        double threshold)
+{
+    time = newTime;
+    values = newValues;
+
+    const int size = qMin(time.size(), values.size());
+    const double *t = time.constData();
+    const float *v = values.constData();
+
+    pyramid.build(v, size);
+
+    duration.resize(size + 1);
+    weighted.resize(size + 1);
+
+    duration[0] = 0;
+    weighted[0] = 0;
+
+    for (int i = 0; i < size; ++i)
+    {
+        const double dt = interval(t, i, size);
+        duration[i + 1] = duration[i] + dt;
+        weighted[i + 1] = weighted[i] + v[i] * dt;
+    }
+
+    above.clear();
+    setThreshold(threshold);
+}
+
+void RangeStatistics::setThreshold(
+        double threshold)
+{
+    const int size = pyramid.size();
+    if (threshold == limit && above.size() == size + 1) return;
+
+    limit = threshold;
+
+    const double *t = time.constData();
+    const float *v = values.constData();
+
+    above.resize(size + 1);
+    above[0] = 0;
+
+    for (int i = 0; i < size; ++i)
+    {
+        above[i + 1] = above[i] + ((v[i] > threshold) ? interval(t, i, size) : 0);
+    }
+}
+
+void RangeStatistics::clear()
+{
+    time.clear();
+    values.clear();
+    pyramid.clear();
+    duration.clear();
+    weighted.clear();
+    above.clear();
+}
+
+RangeStatistics::Statistics RangeStatistics::range(
+        int begin,
+        int end) const
+{
+    Statistics s;
+    s.minimum = 0;
+    s.maximum = 0;
+    s.mean = 0;
+    s.duration = 0;
+    s.timeAbove = 0;
+
+    begin = qMax(begin, 0);
+    end = qMin(end, pyramid.size());
+    if (begin >= end) return s;
+
+    pyramid.range(begin, end, s.minimum, s.maximum);
+
+    // The last sample of the range only counts up to its own time
+    s.duration = duration[end - 1] - duration[begin];
+    s.timeAbove = above[end - 1] - above[begin];
+    s.mean = (s.duration > 0)
+            ? (weighted[end - 1] - weighted[begin]) / s.duration
+            : values[begin];
+
+    return s;
+}
@@ -0,0 +1,79 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef RANGESTATISTICS_H
+#define RANGESTATISTICS_H
+
+#include <QVector>
+
+#include "trackcolumn.h"
+#include "trackpyramid.h"
+
+// Samples further apart than this (s) do not count towards time spent
+#define STATISTICS_MAX_GAP 5.0
+
+// Minimum, maximum, time-weighted mean and time above a threshold of a
+// series over any range of samples. Minimum and maximum come from a
+// pyramid in O(log n), and the others from prefix sums in O(1), so a
+// selection can be dragged over a long track without rescanning it.
+class RangeStatistics
+{
+public:
+    typedef struct {
+        float minimum;
+        float maximum;
+        double mean;
+        double duration;        // s
+        double timeAbove;       // s
+    } Statistics;
+
+    RangeStatistics();
+
+    // Each sample lasts until the next one
+    void build(const TrackColumn< double > &time,
+               const TrackColumn< float > &values, double threshold);
+    void clear();
+
+    int size() const { return values.size(); }
+    double threshold() const { return limit; }
+    void setThreshold(double threshold);
+
+    Statistics range(int begin, int end) const;
+
+private:
+    TrackColumn< double > time;
+    TrackColumn< float > values;
+    TrackPyramid pyramid;
+    double limit;
+
+    // Sums over the first i samples
+    QVector< double > duration;
+    QVector< double > weighted;
+    QVector< double > above;
+
+    // The pyramid points into values
+    RangeStatistics(const RangeStatistics &);
+    RangeStatistics &operator=(const RangeStatistics &);
+};
+
+#endif // RANGESTATISTICS_H
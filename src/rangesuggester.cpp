@@ -0,0 +1,309 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "rangesuggester.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QtConcurrentMap>
+
+#include "jumpsegmenter.h"
+#include "sasstage.h"
+#include "simulator.h"
+#include "track.h"
+#include "trackcache.h"
+
+// Identifies sketch cache files, and their layout
+#define SKETCH_MAGIC   0x46535153
+#define SKETCH_VERSION 2
+
+// Tone and rate ranges cover the middle of the distribution
+#define SUGGEST_LOW_QUANTILE  0.05
+#define SUGGEST_HIGH_QUANTILE 0.95
+
+// Thresholds sit below nearly all freefall speeds
+#define THRESHOLD_QUANTILE 0.01
+#define THRESHOLD_FRACTION 0.5
+
+#define SKETCH_MODE_COUNT 6
+
+static const Configuration::Mode sketchedModes[SKETCH_MODE_COUNT] = {
+    Configuration::HorizontalSpeed,
+    Configuration::VerticalSpeed,
+    Configuration::GlideRatio,
+    Configuration::InverseGlideRatio,
+    Configuration::TotalSpeed,
+    Configuration::DiveAngle
+};
+
+class SketchFile
+{
+public:
+    typedef RangeSuggester::Result result_type;
+
+    SketchFile(bool adjustSpeed) : adjustSpeed(adjustSpeed) {}
+
+    RangeSuggester::Result operator()(const QString &fileName) const
+    {
+        return RangeSuggester::sketchFile(fileName, adjustSpeed);
+    }
+
+private:
+    bool adjustSpeed;
+};
+
+RangeSuggester::RangeSuggester() :
+    sketches(SKETCH_MODE_COUNT)
+{
+
+}
+
+void RangeSuggester::add(
+        const Result &result)
+{
+    if (result.sketches.size() != sketches.size()) return;
+
+    for (int i = 0; i < sketches.size(); ++i)
+    {
+        sketches[i].merge(result.sketches[i]);
+    }
+}
+
+void RangeSuggester::clear()
+{
+    for (int i = 0; i < sketches.size(); ++i)
+    {
+        sketches[i].clear();
+    }
+}
+
+qint64 RangeSuggester::sampleCount() const
+{
+    return sketches[0].count();
+}
+
+int RangeSuggester::sketchIndex(
+        Configuration::Mode mode)
+{
+    for (int i = 0; i < SKETCH_MODE_COUNT; ++i)
+    {
+        if (sketchedModes[i] == mode) return i;
+    }
+    return -1;
+}
+
+Configuration RangeSuggester::suggest(
+        const Configuration &configuration) const
+{
+    Configuration result = configuration;
+
+    const int tone = sketchIndex(configuration.toneMode);
+    if (tone >= 0 && !sketches[tone].isEmpty())
+    {
+        result.minTone = qRound(sketches[tone].quantile(SUGGEST_LOW_QUANTILE));
+        result.maxTone = qRound(sketches[tone].quantile(SUGGEST_HIGH_QUANTILE));
+    }
+
+    // Magnitude of Value 1 follows the tone's measurement. Change in
+    // Value 1 is not sketched.
+    const int rate = sketchIndex(configuration.rateMode == Configuration::ValueMagnitude
+                                 ? configuration.toneMode : configuration.rateMode);
+    if (rate >= 0 && !sketches[rate].isEmpty())
+    {
+        result.minRateValue = qRound(sketches[rate].quantile(SUGGEST_LOW_QUANTILE));
+        result.maxRateValue = qRound(sketches[rate].quantile(SUGGEST_HIGH_QUANTILE));
+    }
+
+    const QuantileSketch &vertical = sketches[sketchIndex(Configuration::VerticalSpeed)];
+    if (!vertical.isEmpty())
+    {
+        result.vThreshold = qMax(0, qRound(THRESHOLD_FRACTION
+                                           * vertical.quantile(THRESHOLD_QUANTILE)));
+    }
+
+    const QuantileSketch &horizontal = sketches[sketchIndex(Configuration::HorizontalSpeed)];
+    if (!horizontal.isEmpty())
+    {
+        result.hThreshold = qMax(0, qRound(THRESHOLD_FRACTION
+                                           * horizontal.quantile(THRESHOLD_QUANTILE)));
+    }
+
+    return result;
+}
+
+QFuture< RangeSuggester::Result > RangeSuggester::sketchFiles(
+        const QStringList &fileNames,
+        bool adjustSpeed)
+{
+    // Each file is sketched on the global thread pool
+    return QtConcurrent::mapped(fileNames, SketchFile(adjustSpeed));
+}
+
+RangeSuggester::Result RangeSuggester::sketchFile(
+        const QString &fileName,
+        bool adjustSpeed)
+{
+    Result result;
+    result.fileName = fileName;
+    result.freefalls = 0;
+
+    Track track;
+    TrackCache cache;
+    if (!cache.load(fileName, track))
+    {
+        result.error = cache.errorString();
+        return result;
+    }
+
+    const QString path = cachePath(track.hash, adjustSpeed);
+    if (!path.isEmpty() && readCache(path, result)) return result;
+
+    result.sketches = sketchTrack(track, adjustSpeed, result.freefalls);
+
+    if (!path.isEmpty()) writeCache(path, result);
+
+    return result;
+}
+
+QVector< QuantileSketch > RangeSuggester::sketchTrack(
+        const Track &track,
+        bool adjustSpeed,
+        int &freefalls)
+{
+    QVector< QuantileSketch > result(SKETCH_MODE_COUNT);
+
+    JumpSegmenter segmenter;
+    TrackCache().segment(track, segmenter);
+
+    // Speeds as the device compares them with Use_SAS
+    Simulation simulation;
+    SasStage sas;
+    if (adjustSpeed)
+    {
+        sas.start(simulation, track);
+    }
+
+    freefalls = 0;
+    SimulationSample sample;
+
+    foreach (const JumpSegmenter::Segment &segment, segmenter.segments())
+    {
+        if (segment.phase != JumpSegmenter::Freefall) continue;
+        ++freefalls;
+
+        for (int i = segment.begin; i < segment.end; ++i)
+        {
+            sample.extract(track, i, 0);
+
+            if (adjustSpeed)
+            {
+                sas.process(sample);
+            }
+
+            for (int j = 0; j < SKETCH_MODE_COUNT; ++j)
+            {
+                result[j].add(sample.value(sketchedModes[j]));
+            }
+        }
+    }
+
+    return result;
+}
+
+QString RangeSuggester::cachePath(
+        const QByteArray &hash,
+        bool adjustSpeed)
+{
+    if (hash.isEmpty()) return QString();
+
+    // Sketches with Use_SAS are kept apart from those without
+    const QDir folder(QDir(QStandardPaths::writableLocation(
+                               QStandardPaths::CacheLocation)).filePath("sketches"));
+    return folder.filePath(QString::fromLatin1(hash.toHex())
+                           + (adjustSpeed ? "-sas.sketch" : ".sketch"));
+}
+
+bool RangeSuggester::readCache(
+        const QString &path,
+        Result &result)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_6);
+
+    quint32 magic, version, segmenterVersion, sampleVersion;
+    qint32 freefalls, count;
+    in >> magic >> version >> segmenterVersion >> sampleVersion
+       >> freefalls >> count;
+
+    // Sketches also go stale when segments or sample metrics change
+    if (magic != SKETCH_MAGIC || version != SKETCH_VERSION
+            || segmenterVersion != JUMP_SEGMENTER_VERSION
+            || sampleVersion != SIMULATION_SAMPLE_VERSION
+            || count != SKETCH_MODE_COUNT)
+    {
+        return false;
+    }
+
+    QVector< QuantileSketch > sketches(count);
+    for (int i = 0; i < count; ++i)
+    {
+        in >> sketches[i];
+    }
+
+    if (in.status() != QDataStream::Ok) return false;
+
+    result.freefalls = freefalls;
+    result.sketches = sketches;
+    return true;
+}
+
+void RangeSuggester::writeCache(
+        const QString &path,
+        const Result &result)
+{
+    // The cache is only an optimization, so failures are not reported
+    if (!QDir().mkpath(QFileInfo(path).absolutePath())) return;
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return;
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_6);
+    out << (quint32) SKETCH_MAGIC << (quint32) SKETCH_VERSION
+        << (quint32) JUMP_SEGMENTER_VERSION << (quint32) SIMULATION_SAMPLE_VERSION
+        << (qint32) result.freefalls << (qint32) result.sketches.size();
+
+    foreach (const QuantileSketch &sketch, result.sketches)
+    {
+        out << sketch;
+    }
+
+    file.commit();
+}
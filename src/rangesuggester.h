@@ -0,0 +1,81 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef RANGESUGGESTER_H
+#define RANGESUGGESTER_H
+
+#include <QFuture>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "configuration.h"
+#include "quantilesketch.h"
+
+class Track;
+
+// Suggests tone, rate and threshold ranges from the distribution of each
+// measurement mode over the freefall parts of a logbook. Each file is
+// reduced to one sketch per mode, which is cached by track hash and
+// Use_SAS, so adding jumps only sketches the new files.
+class RangeSuggester
+{
+public:
+    typedef struct {
+        QString fileName;
+        QString error;
+        int freefalls;
+        QVector< QuantileSketch > sketches;     // One per sketched mode
+    } Result;
+
+    RangeSuggester();
+
+    void add(const Result &result);
+    void clear();
+
+    // Freefall samples added so far
+    qint64 sampleCount() const;
+
+    // Copy of the configuration with ranges for its modes, leaving
+    // fields unchanged where there is no data
+    Configuration suggest(const Configuration &configuration) const;
+
+    // Speeds are scaled to airspeed if adjustSpeed (Use_SAS) is set
+    static QFuture< Result > sketchFiles(const QStringList &fileNames,
+                                         bool adjustSpeed);
+    static Result sketchFile(const QString &fileName, bool adjustSpeed);
+
+private:
+    QVector< QuantileSketch > sketches;
+
+    // Index of the mode's sketch, or -1 if the mode is not sketched
+    static int sketchIndex(Configuration::Mode mode);
+    static QVector< QuantileSketch > sketchTrack(const Track &track, bool adjustSpeed,
+                                                 int &freefalls);
+
+    static QString cachePath(const QByteArray &hash, bool adjustSpeed);
+    static bool readCache(const QString &path, Result &result);
+    static void writeCache(const QString &path, const Result &result);
+};
+
+#endif // RANGESUGGESTER_H
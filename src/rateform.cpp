@@ -43,6 +43,19 @@ RateForm::RateForm(QWidget *parent) :
 
     connect(ui->modeComboBox, SIGNAL(currentIndexChanged(int)),
             this, SIGNAL(selectionChanged()));
+
+    // Redraw the preview as values are typed
+    ui->curveWidget->setKind(ToneCurve::Rate);
+    connect(ui->minimumValueEdit, SIGNAL(textEdited(QString)),
+            this, SLOT(updatePreview()));
+    connect(ui->maximumValueEdit, SIGNAL(textEdited(QString)),
+            this, SLOT(updatePreview()));
+    connect(ui->minimumEdit, SIGNAL(textEdited(QString)),
+            this, SLOT(updatePreview()));
+    connect(ui->maximumEdit, SIGNAL(textEdited(QString)),
+            this, SLOT(updatePreview()));
+    connect(ui->flatlineCheckBox, SIGNAL(toggled(bool)),
+            this, SLOT(updatePreview()));
 }
 
 RateForm::~RateForm()
@@ -53,6 +66,8 @@ RateForm::~RateForm()
 void RateForm::setConfiguration(
         const Configuration &configuration)
 {
+    this->configuration = configuration;
+
     int index = ui->modeComboBox->findData(configuration.rateMode);
     ui->modeComboBox->setCurrentIndex(index);
 
@@ -115,6 +130,8 @@ void RateForm::setConfiguration(
         ui->maximumLabel->setText(tr("Maximum:"));
         break;
     }
+
+    ui->curveWidget->setConfiguration(configuration);
 }
 
 void RateForm::updateConfiguration(
@@ -145,3 +162,10 @@ void RateForm::updateConfiguration(
         configuration.flatline = ui->flatlineCheckBox->isChecked();
     }
 }
+
+void RateForm::updatePreview()
+{
+    Configuration preview = configuration;
+    updateConfiguration(preview, Values);
+    ui->curveWidget->setConfiguration(preview);
+}
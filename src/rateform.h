@@ -24,10 +24,9 @@
 #ifndef RATEFORM_H
 #define RATEFORM_H
 
+#include "configuration.h"
 #include "configurationpage.h"
 
-class Configuration;
-
 namespace Ui {
 class RateForm;
 }
@@ -48,6 +47,11 @@ public:
 
 private:
     Ui::RateForm *ui;
+
+    Configuration configuration;
+
+private slots:
+    void updatePreview();
 };
 
 #endif // RATEFORM_H
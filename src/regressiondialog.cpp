@@ -0,0 +1,161 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "regressiondialog.h"
+#include "ui_regressiondialog.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QTreeWidgetItem>
+
+#include "trackreader.h"
+
+RegressionDialog::RegressionDialog(
+        const Configuration &a,
+        const Configuration &b,
+        const QString &folder,
+        QWidget *parent) :
+    QDialog(parent),
+    ui(new Ui::RegressionDialog),
+    configuration(a),
+    changed(0),
+    simulated(0)
+{
+    ui->setupUi(this);
+
+    const QStringList fileNames = TrackReader::findTracks(folder);
+    ui->statusLabel->setText(tr("Comparing %1 tracks in %2...")
+                             .arg(fileNames.size())
+                             .arg(QDir::toNativeSeparators(folder)));
+
+    connect(&watcher, SIGNAL(progressRangeChanged(int,int)),
+            ui->progressBar, SLOT(setRange(int,int)));
+    connect(&watcher, SIGNAL(progressValueChanged(int)),
+            ui->progressBar, SLOT(setValue(int)));
+    connect(&watcher, SIGNAL(resultReadyAt(int)),
+            this, SLOT(addResult(int)));
+    connect(&watcher, SIGNAL(finished()),
+            this, SLOT(finished()));
+
+    watcher.setFuture(RegressionReport::compareFiles(fileNames, a, b));
+}
+
+RegressionDialog::~RegressionDialog()
+{
+    // Stop processing before results are discarded
+    watcher.cancel();
+    watcher.waitForFinished();
+
+    delete ui;
+}
+
+QString RegressionDialog::timeText(
+        double time)
+{
+    const QDateTime dateTime = QDateTime::fromMSecsSinceEpoch(
+                qRound64(time * 1000), Qt::UTC);
+    return dateTime.toString("yyyy-MM-dd hh:mm:ss.zzz");
+}
+
+QString RegressionDialog::alarmText(
+        const AlarmEvaluator::Event &event) const
+{
+    return QString("%1 %2")
+            .arg(configuration.valueToDistanceUnits(qRound(event.altitude)))
+            .arg(configuration.distanceUnits());
+}
+
+void RegressionDialog::addResult(
+        int index)
+{
+    const RegressionReport::Result result = watcher.resultAt(index);
+
+    QTreeWidgetItem *fileItem = new QTreeWidgetItem(ui->treeWidget);
+    fileItem->setText(0, QFileInfo(result.fileName).fileName());
+    fileItem->setToolTip(0, QDir::toNativeSeparators(result.fileName));
+
+    if (!result.error.isEmpty())
+    {
+        fileItem->setText(1, result.error);
+        return;
+    }
+
+    simulated += result.simulated;
+
+    if (!RegressionReport::isChanged(result))
+    {
+        fileItem->setText(1, tr("No change"));
+        return;
+    }
+
+    ++changed;
+
+    fileItem->setText(1, tr("Tone %1 s, ").arg(result.b.toneTime - result.a.toneTime, 0, 'f', 1)
+                      + tr("%n alarm(s), ", 0, result.alarms.size())
+                      + tr("%n callout(s)", 0, result.speech.size()));
+    fileItem->setText(2, tr("%1 s").arg(result.a.toneTime, 0, 'f', 1));
+    fileItem->setText(3, tr("%1 s").arg(result.b.toneTime, 0, 'f', 1));
+
+    foreach (const RegressionReport::AlarmChange &change, result.alarms)
+    {
+        const AlarmEvaluator::Event &event = change.hasA ? change.a : change.b;
+
+        QTreeWidgetItem *item = new QTreeWidgetItem(fileItem);
+        item->setText(0, timeText(event.time));
+
+        QString text = QString("%1 %2")
+                .arg(AlarmEvaluator::eventName(event.type))
+                .arg(event.index + 1);
+        if (!change.hasB) text += " " + tr("only in A");
+        else if (!change.hasA) text += " " + tr("only in B");
+        else text += " " + tr("moved %1 s").arg(change.b.time - change.a.time, 0, 'f', 2);
+        item->setText(1, text);
+
+        if (change.hasA) item->setText(2, alarmText(change.a));
+        if (change.hasB) item->setText(3, alarmText(change.b));
+    }
+
+    foreach (const RegressionReport::SpeechChange &change, result.speech)
+    {
+        QTreeWidgetItem *item = new QTreeWidgetItem(fileItem);
+        item->setText(0, timeText(change.hasA ? change.a.time : change.b.time));
+
+        if (!change.hasB) item->setText(1, tr("Callout only in A"));
+        else if (!change.hasA) item->setText(1, tr("Callout only in B"));
+        else item->setText(1, tr("Callout changed"));
+
+        if (change.hasA) item->setText(2, Simulation::speechText(change.a));
+        if (change.hasB) item->setText(3, Simulation::speechText(change.b));
+    }
+}
+
+void RegressionDialog::finished()
+{
+    const int count = ui->treeWidget->topLevelItemCount();
+    ui->statusLabel->setText(tr("%1 of %2 tracks changed. Simulated %3 of %4 configurations; the rest were cached.")
+                             .arg(changed)
+                             .arg(count)
+                             .arg(simulated)
+                             .arg(2 * count));
+}
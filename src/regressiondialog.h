@@ -0,0 +1,67 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef REGRESSIONDIALOG_H
+#define REGRESSIONDIALOG_H
+
+#include <QDialog>
+#include <QFutureWatcher>
+
+#include "configuration.h"
+#include "regressionreport.h"
+
+class QTreeWidgetItem;
+
+namespace Ui {
+class RegressionDialog;
+}
+
+class RegressionDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit RegressionDialog(const Configuration &a,
+                              const Configuration &b,
+                              const QString &folder,
+                              QWidget *parent = 0);
+    ~RegressionDialog();
+
+private:
+    Ui::RegressionDialog *ui;
+
+    Configuration configuration;
+    QFutureWatcher< RegressionReport::Result > watcher;
+
+    int changed;
+    int simulated;
+
+    QString alarmText(const AlarmEvaluator::Event &event) const;
+    static QString timeText(double time);
+
+private slots:
+    void addResult(int index);
+    void finished();
+};
+
+#endif // REGRESSIONDIALOG_H
@@ -0,0 +1,261 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "regressionreport.h"
+
+#include <QMap>
+#include <QPair>
+#include <QtConcurrentMap>
+
+#include <algorithm>
+
+#include "simulationcache.h"
+#include "simulationcomparison.h"
+#include "track.h"
+#include "trackcache.h"
+
+// Callouts closer than this are taken to be the same callout (s)
+#define SPEECH_MATCH_WINDOW 0.5
+
+class CompareFile
+{
+public:
+    typedef RegressionReport::Result result_type;
+
+    CompareFile(const Configuration &a, const Configuration &b) :
+        a(a), b(b) {}
+
+    RegressionReport::Result operator()(const QString &fileName) const
+    {
+        return RegressionReport::compareFile(fileName, a, b);
+    }
+
+private:
+    Configuration a;
+    Configuration b;
+};
+
+static double alarmTime(
+        const RegressionReport::AlarmChange &change)
+{
+    return change.hasA ? change.a.time : change.b.time;
+}
+
+static bool alarmChangeLessThan(
+        const RegressionReport::AlarmChange &first,
+        const RegressionReport::AlarmChange &second)
+{
+    return alarmTime(first) < alarmTime(second);
+}
+
+QFuture< RegressionReport::Result > RegressionReport::compareFiles(
+        const QStringList &fileNames,
+        const Configuration &a,
+        const Configuration &b)
+{
+    return QtConcurrent::mapped(fileNames, CompareFile(a, b));
+}
+
+RegressionReport::Result RegressionReport::compareFile(
+        const QString &fileName,
+        const Configuration &a,
+        const Configuration &b)
+{
+    Result result;
+    result.fileName = fileName;
+    result.simulated = 0;
+
+    Track track;
+    TrackCache trackCache;
+    if (!trackCache.load(fileName, track))
+    {
+        result.error = trackCache.errorString();
+        return result;
+    }
+
+    const QByteArray keyA = SimulationCache::key(a, 0, track.hash);
+    const QByteArray keyB = SimulationCache::key(b, 0, track.hash);
+
+    // Cached results skip resampling as well
+    SimulationCache simulationCache;
+    Simulation simulationA, simulationB;
+    TrackColumn< double > timeA, timeB;
+    const bool cachedA = simulationCache.load(keyA, simulationA, timeA);
+    const bool cachedB = simulationCache.load(keyB, simulationB, timeB);
+
+    // Configurations missing from the cache share their common stages
+    QVector< Configuration > configurations;
+    if (!cachedA) configurations.append(a);
+    if (!cachedB) configurations.append(b);
+
+    if (!configurations.isEmpty())
+    {
+        SimulationComparison comparison;
+        comparison.setTrack(track);
+        comparison.run(configurations);
+
+        int next = 0;
+        if (!cachedA)
+        {
+            simulationA = comparison.simulation(next);
+            timeA = comparison.track(next++).time;
+        }
+        if (!cachedB)
+        {
+            simulationB = comparison.simulation(next);
+            timeB = comparison.track(next++).time;
+        }
+
+        result.simulated = comparison.size() - comparison.cacheHits();
+    }
+
+    result.a = summarize(simulationA, timeA);
+    result.b = summarize(simulationB, timeB);
+
+    result.alarms = compareAlarms(result.a.alarms, result.b.alarms);
+    result.speech = compareSpeech(result.a.speech, result.b.speech);
+
+    return result;
+}
+
+bool RegressionReport::isChanged(
+        const Result &result)
+{
+    return result.a.toneTime != result.b.toneTime
+            || !result.alarms.isEmpty()
+            || !result.speech.isEmpty();
+}
+
+RegressionReport::Summary RegressionReport::summarize(
+        const Simulation &simulation,
+        const TrackColumn< double > &time)
+{
+    Summary summary;
+    summary.toneTime = 0;
+    summary.alarms = simulation.alarms;
+    summary.speech = simulation.speech;
+
+    // Each sample sounds until the next one
+    for (int j = 0; j + 1 < simulation.state.size() && j + 1 < time.size(); ++j)
+    {
+        if (simulation.state[j] != Simulation::Silent)
+        {
+            summary.toneTime += time[j + 1] - time[j];
+        }
+    }
+
+    return summary;
+}
+
+QVector< RegressionReport::AlarmChange > RegressionReport::compareAlarms(
+        const AlarmEvaluator::Events &a,
+        const AlarmEvaluator::Events &b)
+{
+    // Pair the nth crossing of each alarm or window in A with the nth in B
+    typedef QPair< int, int > Key;
+    QMap< Key, QVector< int > > eventsA, eventsB;
+
+    for (int i = 0; i < a.size(); ++i)
+    {
+        eventsA[qMakePair((int) a[i].type, a[i].index)].append(i);
+    }
+    for (int i = 0; i < b.size(); ++i)
+    {
+        eventsB[qMakePair((int) b[i].type, b[i].index)].append(i);
+    }
+
+    QList< Key > keys = eventsA.keys();
+    keys.append(eventsB.keys());
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+    QVector< AlarmChange > changes;
+    foreach (const Key &key, keys)
+    {
+        const QVector< int > indexA = eventsA.value(key);
+        const QVector< int > indexB = eventsB.value(key);
+
+        for (int i = 0; i < qMax(indexA.size(), indexB.size()); ++i)
+        {
+            AlarmChange change;
+            change.hasA = i < indexA.size();
+            change.hasB = i < indexB.size();
+            if (change.hasA) change.a = a[indexA[i]];
+            if (change.hasB) change.b = b[indexB[i]];
+
+            if (change.hasA && change.hasB && change.a.time == change.b.time) continue;
+
+            changes.append(change);
+        }
+    }
+
+    std::sort(changes.begin(), changes.end(), alarmChangeLessThan);
+    return changes;
+}
+
+QVector< RegressionReport::SpeechChange > RegressionReport::compareSpeech(
+        const Simulation::Speeches &a,
+        const Simulation::Speeches &b)
+{
+    QVector< SpeechChange > changes;
+
+    // Both lists are in time order, so callouts are matched by merging
+    int i = 0, j = 0;
+    while (i < a.size() || j < b.size())
+    {
+        SpeechChange change;
+        change.hasA = false;
+        change.hasB = false;
+
+        if (j >= b.size() || (i < a.size() && a[i].time < b[j].time - SPEECH_MATCH_WINDOW))
+        {
+            change.hasA = true;
+            change.a = a[i++];
+        }
+        else if (i >= a.size() || b[j].time < a[i].time - SPEECH_MATCH_WINDOW)
+        {
+            change.hasB = true;
+            change.b = b[j++];
+        }
+        else
+        {
+            change.hasA = true;
+            change.hasB = true;
+            change.a = a[i++];
+            change.b = b[j++];
+
+            if (change.a.time == change.b.time
+                    && change.a.index == change.b.index
+                    && change.a.mode == change.b.mode
+                    && change.a.value == change.b.value
+                    && change.a.decimals == change.b.decimals)
+            {
+                continue;
+            }
+        }
+
+        changes.append(change);
+    }
+
+    return changes;
+}
@@ -0,0 +1,96 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef REGRESSIONREPORT_H
+#define REGRESSIONREPORT_H
+
+#include <QFuture>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "alarmevaluator.h"
+#include "configuration.h"
+#include "simulator.h"
+#include "trackcolumn.h"
+
+// Compares two configurations over every track in a logbook. Results
+// come from the simulation cache wherever a configuration has already
+// been simulated on a track, so only a configuration which changed is
+// simulated again.
+class RegressionReport
+{
+public:
+    typedef struct {
+        double toneTime;            // s with tone or chirps sounding
+        AlarmEvaluator::Events alarms;
+        Simulation::Speeches speech;
+    } Summary;
+
+    // Alarm crossing or callout which moved, changed or exists in only
+    // one configuration
+    typedef struct {
+        bool hasA;
+        bool hasB;
+        AlarmEvaluator::Event a;
+        AlarmEvaluator::Event b;
+    } AlarmChange;
+
+    typedef struct {
+        bool hasA;
+        bool hasB;
+        Simulation::Speech a;
+        Simulation::Speech b;
+    } SpeechChange;
+
+    typedef struct {
+        QString fileName;
+        QString error;
+        Summary a;
+        Summary b;
+        int simulated;              // Simulations not found in the cache
+        QVector< AlarmChange > alarms;
+        QVector< SpeechChange > speech;
+    } Result;
+
+    // Compares the files on the global thread pool
+    static QFuture< Result > compareFiles(const QStringList &fileNames,
+                                          const Configuration &a,
+                                          const Configuration &b);
+    static Result compareFile(const QString &fileName,
+                              const Configuration &a,
+                              const Configuration &b);
+
+    static bool isChanged(const Result &result);
+
+private:
+    static Summary summarize(const Simulation &simulation,
+                             const TrackColumn< double > &time);
+
+    static QVector< AlarmChange > compareAlarms(const AlarmEvaluator::Events &a,
+                                                const AlarmEvaluator::Events &b);
+    static QVector< SpeechChange > compareSpeech(const Simulation::Speeches &a,
+                                                 const Simulation::Speeches &b);
+};
+
+#endif // REGRESSIONREPORT_H
@@ -0,0 +1,146 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "robustnessdialog.h"
+#include "ui_robustnessdialog.h"
+
+#include <QFileInfo>
+#include <QTreeWidgetItem>
+
+#include "trackcache.h"
+
+RobustnessDialog::RobustnessDialog(
+        const Configuration &configuration,
+        const QStringList &fileNames,
+        QWidget *parent) :
+    QDialog(parent),
+    ui(new Ui::RobustnessDialog),
+    configuration(configuration)
+{
+    ui->setupUi(this);
+
+    ui->sigmaSpinBox->setSuffix(QString(" ") + configuration.distanceUnits());
+    ui->sigmaSpinBox->setValue(configuration.valueToDistanceUnits(3));
+
+    ui->treeWidget->setHeaderLabels(
+                QStringList() << tr("Event") << tr("Without noise")
+                << tr("Probability") << tr("Missed") << tr("Extra")
+                << tr("Mean delay (s)") << tr("Spread (s)"));
+
+    QStringList errors;
+    foreach (const QString &fileName, fileNames)
+    {
+        Track track;
+        TrackCache cache;
+        if (cache.load(fileName, track))
+        {
+            tracks.append(track);
+        }
+        else
+        {
+            errors.append(QString("%1: %2")
+                          .arg(QFileInfo(fileName).fileName())
+                          .arg(cache.errorString()));
+        }
+    }
+
+    QString status = tr("Loaded %n track(s).", 0, tracks.size());
+    if (!errors.isEmpty()) status += "\n" + errors.join("\n");
+    ui->statusLabel->setText(status);
+    ui->runButton->setEnabled(!tracks.isEmpty());
+
+    connect(&watcher, SIGNAL(progressRangeChanged(int,int)),
+            ui->progressBar, SLOT(setRange(int,int)));
+    connect(&watcher, SIGNAL(progressValueChanged(int)),
+            ui->progressBar, SLOT(setValue(int)));
+    connect(&watcher, SIGNAL(finished()),
+            this, SLOT(finished()));
+}
+
+RobustnessDialog::~RobustnessDialog()
+{
+    // Stop processing before the analysis is discarded
+    watcher.cancel();
+    watcher.waitForFinished();
+
+    delete ui;
+}
+
+void RobustnessDialog::on_runButton_clicked()
+{
+    AlarmRobustness::NoiseModel model;
+    model.altitudeSigma = ui->sigmaSpinBox->value()
+            / configuration.valueToDistanceUnits(1);
+    model.correlationTime = ui->correlationSpinBox->value();
+    model.dropoutRate = ui->dropoutRateSpinBox->value();
+    model.dropoutLength = ui->dropoutLengthSpinBox->value();
+
+    robustness.reset(new AlarmRobustness(configuration, model,
+                                         ui->seedSpinBox->value()));
+    foreach (const Track &track, tracks)
+    {
+        robustness->addTrack(track);
+    }
+
+    ui->runButton->setEnabled(false);
+    ui->treeWidget->clear();
+    ui->statusLabel->setText(tr("Running %1 realizations of %n jump(s)...",
+                                0, robustness->jumpCount())
+                             .arg(ui->realizationsSpinBox->value()));
+
+    watcher.setFuture(robustness->run(ui->realizationsSpinBox->value()));
+}
+
+void RobustnessDialog::finished()
+{
+    ui->runButton->setEnabled(true);
+    if (watcher.isCanceled()) return;
+
+    // Results are reduced in realization order
+    const QList< AlarmRobustness::Outcome > outcomes = watcher.future().results();
+    const QVector< AlarmRobustness::Statistics > statistics =
+            robustness->summarize(outcomes);
+
+    foreach (const AlarmRobustness::Statistics &s, statistics)
+    {
+        QTreeWidgetItem *item = new QTreeWidgetItem(ui->treeWidget);
+
+        item->setText(0, QString("%1 %2")
+                      .arg(AlarmEvaluator::eventName(s.type))
+                      .arg(s.index + 1));
+        item->setText(1, tr("%1 of %2").arg(s.reference).arg(robustness->jumpCount()));
+        item->setText(2, QString("%1%").arg(s.probability * 100, 0, 'f', 1));
+        item->setText(3, s.reference > 0
+                      ? QString("%1%").arg(s.missedRate * 100, 0, 'f', 1)
+                      : QString());
+        item->setText(4, QString::number(s.extraRate, 'f', 2));
+        item->setText(5, s.reference > 0
+                      ? QString::number(s.meanDelay, 'f', 2) : QString());
+        item->setText(6, s.reference > 0
+                      ? QString::number(s.delaySpread, 'f', 2) : QString());
+    }
+
+    ui->statusLabel->setText(tr("Ran %1 realizations of %n jump(s).",
+                                0, robustness->jumpCount())
+                             .arg(outcomes.size()));
+}
@@ -0,0 +1,64 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef ROBUSTNESSDIALOG_H
+#define ROBUSTNESSDIALOG_H
+
+#include <QDialog>
+#include <QFutureWatcher>
+#include <QScopedPointer>
+#include <QStringList>
+
+#include "alarmrobustness.h"
+#include "configuration.h"
+#include "track.h"
+
+namespace Ui {
+class RobustnessDialog;
+}
+
+class RobustnessDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit RobustnessDialog(const Configuration &configuration,
+                              const QStringList &fileNames,
+                              QWidget *parent = 0);
+    ~RobustnessDialog();
+
+private:
+    Ui::RobustnessDialog *ui;
+
+    Configuration configuration;
+    QVector< Track > tracks;
+
+    QScopedPointer< AlarmRobustness > robustness;
+    QFutureWatcher< AlarmRobustness::Outcome > watcher;
+
+private slots:
+    void on_runButton_clicked();
+    void finished();
+};
+
+#endif // ROBUSTNESSDIALOG_H
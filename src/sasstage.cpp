@@ -0,0 +1,57 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "sasstage.h"
+
+#include "atmosphere.h"
+#include "track.h"
+
+SasStage::SasStage() :
+    factors(0)
+{
+
+}
+
+void SasStage::start(
+        Simulation &simulation,
+        const Track &track)
+{
+    // Factors for the whole track in one pass over the altitude column
+    simulation.airspeedFactor.resize(track.size());
+    Atmosphere::airspeedFactors(track.hMSL.constData(),
+                                simulation.airspeedFactor.data(),
+                                track.size());
+
+    factors = simulation.airspeedFactor.constData();
+}
+
+void SasStage::process(
+        SimulationSample &sample)
+{
+    // Ratios and angles are unchanged by a common scale
+    const double factor = factors[sample.index];
+
+    sample.horizontalSpeed *= factor;
+    sample.verticalSpeed *= factor;
+    sample.totalSpeed *= factor;
+}
@@ -0,0 +1,428 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "simulationcache.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QSaveFile>
+#include <QSettings>
+#include <QStandardPaths>
+
+#include <cstring>
+
+#include "jumpsegmenter.h"
+#include "simulationgraph.h"
+
+#define CACHE_MAGIC        "FSSIMUL"
+#define CACHE_VERSION      2
+#define CACHE_BYTE_ORDER   0x01020304
+#define CACHE_SUFFIX       ".fssim"
+#define CACHE_ALIGNMENT    64
+#define CACHE_DEFAULT_SIZE (256LL * 1024 * 1024)
+#define CACHE_TRIM_FRACTION 0.9     // Of the maximum size, left after a trim
+
+typedef enum {
+    TimeColumn = 0,
+    PitchColumn,
+    RateColumn,
+    StateColumn,
+    AirspeedColumn,
+    AlarmColumn,
+    SpeechColumn,
+    SimulationColumnCount
+} SimulationColumnIndex;
+
+typedef struct {
+    qint64  offset;
+    qint32  count;
+    quint32 elementSize;
+} SimulationColumn;
+
+typedef struct {
+    char    magic[8];
+    quint32 version;
+    quint32 byteOrder;
+    quint32 segmenterVersion;
+    quint32 sampleVersion;
+    qint64  fileSize;
+    char    key[20];
+    qint32  columnCount;
+    SimulationColumn columns[SimulationColumnCount];
+} SimulationHeader;
+
+typedef struct {
+    double  time;
+    double  altitude;
+    qint32  type;
+    qint32  index;
+    qint32  sample;
+    qint32  reserved;
+} SimulationAlarm;
+
+typedef struct {
+    double  time;
+    double  value;
+    qint32  sample;
+    qint32  index;
+    qint32  mode;
+    qint32  decimals;
+} SimulationSpeech;
+
+static inline qint64 align(
+        qint64 pos)
+{
+    return (pos + CACHE_ALIGNMENT - 1) & ~(qint64) (CACHE_ALIGNMENT - 1);
+}
+
+static bool writePadding(
+        QSaveFile &file,
+        qint64 pos)
+{
+    static const char zeros[CACHE_ALIGNMENT] = { 0 };
+    const qint64 padding = pos - file.pos();
+    return padding == 0 || file.write(zeros, padding) == padding;
+}
+
+template< typename T >
+static bool writeColumn(
+        QSaveFile &file,
+        const T *values,
+        const SimulationColumn &entry)
+{
+    const qint64 bytes = entry.count * (qint64) sizeof(T);
+    return writePadding(file, entry.offset)
+            && (bytes == 0 || file.write((const char *) values, bytes) == bytes);
+}
+
+template< typename T >
+static bool readColumn(
+        const uchar *data,
+        const SimulationHeader &header,
+        const SimulationColumn &entry,
+        QVector< T > &values)
+{
+    if (entry.elementSize != sizeof(T)) return false;
+    if (entry.count < 0) return false;
+    if (entry.offset < (qint64) sizeof(header)) return false;
+    if (entry.offset + entry.count * (qint64) sizeof(T) > header.fileSize) return false;
+
+    values.resize(entry.count);
+    if (entry.count) memcpy(values.data(), data + entry.offset, entry.count * sizeof(T));
+    return true;
+}
+
+SimulationCache::SimulationCache()
+{
+    // Initialize settings object
+    QSettings settings("FlySight", "Configurator");
+
+    const QString defaultFolder = QDir(QStandardPaths::writableLocation(
+                                           QStandardPaths::CacheLocation)).filePath("simulations");
+
+    cacheFolder = settings.value("simulationCache/folder", defaultFolder).toString();
+    maxSize = settings.value("simulationCache/maximumSize", CACHE_DEFAULT_SIZE).toLongLong();
+}
+
+void SimulationCache::setFolder(
+        const QString &folder)
+{
+    cacheFolder = folder;
+}
+
+void SimulationCache::setMaximumSize(
+        qint64 bytes)
+{
+    maxSize = bytes;
+}
+
+QByteArray SimulationCache::key(
+        const Configuration &configuration,
+        double smoothing,
+        const QByteArray &trackHash)
+{
+    if (trackHash.isEmpty()) return QByteArray();
+
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_6);
+
+    // Fields outside the simulation graph keys don't change the results
+    for (int node = 0; node < SimulationGraph::NodeCount; ++node)
+    {
+        out << SimulationGraph::key((SimulationGraph::Node) node, configuration);
+    }
+    out << smoothing << trackHash;
+
+    return QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+}
+
+QString SimulationCache::cachePath(
+        const QByteArray &key) const
+{
+    if (cacheFolder.isEmpty() || key.isEmpty()) return QString();
+
+    return QDir(cacheFolder).filePath(QString::fromLatin1(key.toHex()) + CACHE_SUFFIX);
+}
+
+bool SimulationCache::load(
+        const QByteArray &key,
+        Simulation &simulation,
+        TrackColumn< double > &time) const
+{
+    const QString path = cachePath(key);
+    if (path.isEmpty()) return false;
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    const qint64 size = file.size();
+    if (size < (qint64) sizeof(SimulationHeader)) return false;
+
+    const uchar *data = file.map(0, size);
+    if (!data) return false;
+
+    SimulationHeader header;
+    memcpy(&header, data, sizeof(header));
+
+    // Check format
+    if (memcmp(header.magic, CACHE_MAGIC, sizeof(header.magic))) return false;
+    if (header.version != CACHE_VERSION) return false;
+    if (header.byteOrder != CACHE_BYTE_ORDER) return false;
+    if (header.fileSize != size) return false;
+
+    // Results also go stale when segments or sample metrics change
+    if (header.segmenterVersion != JUMP_SEGMENTER_VERSION) return false;
+    if (header.sampleVersion != SIMULATION_SAMPLE_VERSION) return false;
+    if (header.columnCount != SimulationColumnCount) return false;
+    if (key.size() != (int) sizeof(header.key)
+            || memcmp(header.key, key.constData(), sizeof(header.key)))
+    {
+        return false;
+    }
+
+    QVector< double > times;
+    QVector< SimulationAlarm > alarms;
+    QVector< SimulationSpeech > speech;
+    Simulation result;
+
+    const bool ok = readColumn(data, header, header.columns[TimeColumn], times)
+            && readColumn(data, header, header.columns[PitchColumn], result.pitch)
+            && readColumn(data, header, header.columns[RateColumn], result.rate)
+            && readColumn(data, header, header.columns[StateColumn], result.state)
+            && readColumn(data, header, header.columns[AirspeedColumn], result.airspeedFactor)
+            && readColumn(data, header, header.columns[AlarmColumn], alarms)
+            && readColumn(data, header, header.columns[SpeechColumn], speech);
+
+    file.unmap((uchar *) data);
+    if (!ok) return false;
+
+    foreach (const SimulationAlarm &record, alarms)
+    {
+        AlarmEvaluator::Event event;
+        event.type = (AlarmEvaluator::EventType) record.type;
+        event.index = record.index;
+        event.sample = record.sample;
+        event.time = record.time;
+        event.altitude = record.altitude;
+        result.alarms.append(event);
+    }
+
+    foreach (const SimulationSpeech &record, speech)
+    {
+        Simulation::Speech callout;
+        callout.sample = record.sample;
+        callout.time = record.time;
+        callout.index = record.index;
+        callout.mode = (Configuration::Mode) record.mode;
+        callout.value = record.value;
+        callout.decimals = record.decimals;
+        result.speech.append(callout);
+    }
+
+    simulation = result;
+    time = TrackColumn< double >(times);
+
+    // Mark as recently used
+    file.close();
+    if (file.open(QIODevice::ReadWrite))
+    {
+        file.setFileTime(QDateTime::currentDateTimeUtc(), QFileDevice::FileModificationTime);
+    }
+
+    return true;
+}
+
+bool SimulationCache::store(
+        const QByteArray &key,
+        const Simulation &simulation,
+        const TrackColumn< double > &time) const
+{
+    const QString path = cachePath(key);
+    if (path.isEmpty()) return false;
+
+    if (!QDir().mkpath(QFileInfo(path).absolutePath())) return false;
+
+    QVector< SimulationAlarm > alarms;
+    foreach (const AlarmEvaluator::Event &event, simulation.alarms)
+    {
+        SimulationAlarm record;
+        record.time = event.time;
+        record.altitude = event.altitude;
+        record.type = event.type;
+        record.index = event.index;
+        record.sample = event.sample;
+        record.reserved = 0;
+        alarms.append(record);
+    }
+
+    QVector< SimulationSpeech > speech;
+    foreach (const Simulation::Speech &callout, simulation.speech)
+    {
+        SimulationSpeech record;
+        record.time = callout.time;
+        record.value = callout.value;
+        record.sample = callout.sample;
+        record.index = callout.index;
+        record.mode = callout.mode;
+        record.decimals = callout.decimals;
+        speech.append(record);
+    }
+
+    SimulationHeader header;
+    memset(&header, 0, sizeof(header));
+
+    memcpy(header.magic, CACHE_MAGIC, sizeof(header.magic));
+    header.version = CACHE_VERSION;
+    header.byteOrder = CACHE_BYTE_ORDER;
+    header.segmenterVersion = JUMP_SEGMENTER_VERSION;
+    header.sampleVersion = SIMULATION_SAMPLE_VERSION;
+    memcpy(header.key, key.constData(), qMin< int >(key.size(), sizeof(header.key)));
+    header.columnCount = SimulationColumnCount;
+
+#define LAYOUT_COLUMN(c,n,s)header.columns[c].count = n; header.columns[c].elementSize = s;
+
+    LAYOUT_COLUMN(TimeColumn, time.size(), sizeof(double));
+    LAYOUT_COLUMN(PitchColumn, simulation.pitch.size(), sizeof(float));
+    LAYOUT_COLUMN(RateColumn, simulation.rate.size(), sizeof(float));
+    LAYOUT_COLUMN(StateColumn, simulation.state.size(), sizeof(quint8));
+    LAYOUT_COLUMN(AirspeedColumn, simulation.airspeedFactor.size(), sizeof(float));
+    LAYOUT_COLUMN(AlarmColumn, alarms.size(), sizeof(SimulationAlarm));
+    LAYOUT_COLUMN(SpeechColumn, speech.size(), sizeof(SimulationSpeech));
+
+#undef LAYOUT_COLUMN
+
+    // Lay out aligned columns one after another
+    qint64 pos = sizeof(header);
+    for (int c = 0; c < SimulationColumnCount; ++c)
+    {
+        pos = align(pos);
+        header.columns[c].offset = pos;
+        pos += header.columns[c].count * (qint64) header.columns[c].elementSize;
+    }
+    header.fileSize = pos;
+
+    // Size of any entry this one replaces
+    const qint64 replaced = QFileInfo(path).size();
+
+    // Write to a temporary file which replaces the entry on commit, so
+    // readers in other processes never see a partial file
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+
+    const bool ok = file.write((const char *) &header, sizeof(header)) == sizeof(header)
+            && writeColumn(file, time.constData(), header.columns[TimeColumn])
+            && writeColumn(file, simulation.pitch.constData(), header.columns[PitchColumn])
+            && writeColumn(file, simulation.rate.constData(), header.columns[RateColumn])
+            && writeColumn(file, simulation.state.constData(), header.columns[StateColumn])
+            && writeColumn(file, simulation.airspeedFactor.constData(), header.columns[AirspeedColumn])
+            && writeColumn(file, alarms.constData(), header.columns[AlarmColumn])
+            && writeColumn(file, speech.constData(), header.columns[SpeechColumn]);
+
+    if (!ok)
+    {
+        file.cancelWriting();
+        return false;
+    }
+
+    if (!file.commit()) return false;
+
+    addUsage(header.fileSize - replaced);
+    return true;
+}
+
+void SimulationCache::addUsage(
+        qint64 bytes) const
+{
+    if (cacheFolder.isEmpty() || maxSize <= 0) return;
+
+    // Size of each folder, shared by the caches of all threads. A folder
+    // is listed when first used and again only when it needs trimming,
+    // and trims leave room for further entries.
+    static QMutex mutex;
+    static QHash< QString, qint64 > usage;
+
+    QMutexLocker locker(&mutex);
+
+    QHash< QString, qint64 >::iterator it = usage.find(cacheFolder);
+    if (it == usage.end())
+    {
+        it = usage.insert(cacheFolder, trim(maxSize));
+    }
+    else
+    {
+        *it += bytes;
+    }
+
+    if (*it > maxSize)
+    {
+        *it = trim((qint64) (maxSize * CACHE_TRIM_FRACTION));
+    }
+}
+
+qint64 SimulationCache::trim(
+        qint64 limit) const
+{
+    // Remove least recently used entries until the cache fits
+    const QFileInfoList entries = QDir(cacheFolder).entryInfoList(
+                QStringList() << QString("*") + CACHE_SUFFIX,
+                QDir::Files, QDir::Time);
+
+    qint64 total = 0;
+    qint64 kept = 0;
+    foreach (const QFileInfo &entry, entries)
+    {
+        total += entry.size();
+        if (total > limit && QFile::remove(entry.absoluteFilePath())) continue;
+
+        kept += entry.size();
+    }
+
+    return kept;
+}
@@ -0,0 +1,77 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef SIMULATIONCACHE_H
+#define SIMULATIONCACHE_H
+
+#include <QByteArray>
+#include <QString>
+
+#include "configuration.h"
+#include "simulator.h"
+#include "trackcolumn.h"
+
+// Stores simulation results on disk, keyed by the configuration fields
+// the simulation reads and the content hash of the track, so repeated
+// simulations are shared between sessions and tools. Entries are
+// written by atomic rename and evicted least recently used first.
+// Entries from another version of the segmenter or sample metrics are
+// not used.
+class SimulationCache
+{
+public:
+    SimulationCache();
+
+    // Empty folder disables the cache
+    QString folder() const { return cacheFolder; }
+    void setFolder(const QString &folder);
+
+    // Zero means no limit
+    qint64 maximumSize() const { return maxSize; }
+    void setMaximumSize(qint64 bytes);
+
+    // Identifies the results of a configuration on a track, or empty
+    // if the track has no content hash
+    static QByteArray key(const Configuration &configuration,
+                          double smoothing,
+                          const QByteArray &trackHash);
+
+    // Time column is that of the track as simulated, after resampling
+    bool load(const QByteArray &key, Simulation &simulation,
+              TrackColumn< double > &time) const;
+    bool store(const QByteArray &key, const Simulation &simulation,
+               const TrackColumn< double > &time) const;
+
+    QString cachePath(const QByteArray &key) const;
+
+private:
+    QString cacheFolder;
+    qint64  maxSize;
+
+    void addUsage(qint64 bytes) const;
+
+    // Size of the folder after removing entries above the limit
+    qint64 trim(qint64 limit) const;
+};
+
+#endif // SIMULATIONCACHE_H
@@ -0,0 +1,185 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "simulationcomparison.h"
+
+#include <QtAlgorithms>
+
+#include "alarmstage.h"
+#include "simulationcache.h"
+#include "speechstage.h"
+#include "tonestage.h"
+#include "trackresampler.h"
+#include "tracksmoother.h"
+
+SimulationComparison::SimulationComparison() :
+    smoothing(0),
+    runs(0),
+    hits(0)
+{
+
+}
+
+void SimulationComparison::setTrack(
+        const Track &track)
+{
+    source = track;
+}
+
+QVector< SimulationComparison::Group > SimulationComparison::partition(
+        const Group &members,
+        SimulationGraph::Node node,
+        const QVector< Configuration > &configurations)
+{
+    QVector< Group > groups;
+    QVector< QVector< int > > keys;
+
+    // Only a handful of configurations, so a linear search is enough
+    foreach (int i, members)
+    {
+        const QVector< int > key = SimulationGraph::key(node, configurations[i]);
+
+        const int group = keys.indexOf(key);
+        if (group < 0)
+        {
+            keys.append(key);
+            groups.append(Group() << i);
+        }
+        else
+        {
+            groups[group].append(i);
+        }
+    }
+
+    return groups;
+}
+
+void SimulationComparison::run(
+        const QVector< Configuration > &configurations)
+{
+    const int count = configurations.size();
+
+    tracks = QVector< Track >(count);
+    results = QVector< Simulation >(count);
+    runs = 0;
+    hits = 0;
+
+    SimulationCache cache;
+    QVector< QByteArray > keys(count);
+    QVector< bool > cached(count);
+
+    Group all;
+    for (int i = 0; i < count; ++i)
+    {
+        TrackColumn< double > time;
+        keys[i] = SimulationCache::key(configurations[i], smoothing, source.hash);
+        cached[i] = cache.load(keys[i], results[i], time);
+        if (cached[i]) ++hits;
+
+        all.append(i);
+    }
+
+    // The smoothing window is shared, so it never splits a branch
+    foreach (const Group &resampled, partition(all, SimulationGraph::ResampleNode, configurations))
+    {
+        const Track track = TrackSmoother(smoothing).smooth(
+                    TrackResampler(configurations[resampled[0]]).resample(source));
+        runs += 2;
+
+        // Cached results still need the track they were simulated on
+        Group pending;
+        foreach (int i, resampled)
+        {
+            tracks[i] = track;
+            if (!cached[i]) pending.append(i);
+        }
+
+        foreach (const Group &metrics, partition(pending, SimulationGraph::MetricsNode, configurations))
+        {
+            Simulation metricsResult;
+            SimulationGraph::extractMetrics(configurations[metrics[0]], track,
+                                            metricsResult, samples);
+            ++runs;
+
+            foreach (const Group &alarms, partition(metrics, SimulationGraph::AlarmNode, configurations))
+            {
+                const QVector< Group > tones = partition(alarms, SimulationGraph::ToneNode, configurations);
+                const QVector< Group > speeches = partition(alarms, SimulationGraph::SpeechNode, configurations);
+
+                // The alarm stage and every tone and speech variant below
+                // it share one pass over the samples
+                Simulation alarmResult;
+                QVector< Simulation > toneResults(tones.size());
+                QVector< Simulation > speechResults(speeches.size());
+
+                QVector< SimulationStage * > stages;
+                stages.append(new AlarmStage(configurations[alarms[0]]));
+                stages.last()->start(alarmResult, track);
+                for (int j = 0; j < tones.size(); ++j)
+                {
+                    stages.append(new ToneStage(configurations[tones[j][0]]));
+                    stages.last()->start(toneResults[j], track);
+                }
+                for (int j = 0; j < speeches.size(); ++j)
+                {
+                    stages.append(new SpeechStage(configurations[speeches[j][0]]));
+                    stages.last()->start(speechResults[j], track);
+                }
+
+                SimulationGraph::runStages(stages, samples);
+                runs += stages.size();
+                qDeleteAll(stages);
+
+                for (int j = 0; j < tones.size(); ++j)
+                {
+                    foreach (int i, tones[j])
+                    {
+                        results[i].pitch = toneResults[j].pitch;
+                        results[i].rate = toneResults[j].rate;
+                        results[i].state = toneResults[j].state;
+                    }
+                }
+
+                for (int j = 0; j < speeches.size(); ++j)
+                {
+                    foreach (int i, speeches[j])
+                    {
+                        results[i].speech = speechResults[j].speech;
+                    }
+                }
+
+                foreach (int i, alarms)
+                {
+                    results[i].alarms = alarmResult.alarms;
+                    results[i].airspeedFactor = metricsResult.airspeedFactor;
+                }
+            }
+        }
+    }
+
+    // The cache is only an optimization, so failures are not reported
+    for (int i = 0; i < count; ++i)
+    {
+        if (!cached[i]) cache.store(keys[i], results[i], tracks[i].time);
+    }
+}
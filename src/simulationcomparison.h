@@ -0,0 +1,86 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef SIMULATIONCOMPARISON_H
+#define SIMULATIONCOMPARISON_H
+
+#include <QVector>
+
+#include "configuration.h"
+#include "simulationgraph.h"
+#include "simulator.h"
+#include "track.h"
+
+// Simulates one track with several configurations at once. Each stage
+// runs once for every distinct set of the fields it reads, following the
+// nodes of SimulationGraph, so configurations which differ only in their
+// tone settings share the resampled track, metrics and alarms. Results
+// share storage wherever their stage was shared. Configurations found in
+// the simulation cache skip every stage after smoothing.
+class SimulationComparison
+{
+public:
+    SimulationComparison();
+
+    void setTrack(const Track &track);
+
+    // Savitzky-Golay window (s) applied to velocities, or zero for none
+    void setSmoothing(double window) { smoothing = window; }
+
+    void run(const QVector< Configuration > &configurations);
+
+    int size() const { return results.size(); }
+
+    // Track as simulated with a configuration, after resampling to its Rate
+    const Track &track(int i) const { return tracks[i]; }
+    const Simulation &simulation(int i) const { return results[i]; }
+
+    // Stages run by the last comparison, and the number separate
+    // simulations would have needed
+    int stageRuns() const { return runs; }
+    int separateRuns() const { return results.size() * SimulationGraph::NodeCount; }
+
+    // Simulations read from the cache by the last comparison
+    int cacheHits() const { return hits; }
+
+private:
+    typedef QVector< int > Group;
+
+    Track source;
+    double smoothing;
+
+    QVector< Track > tracks;
+    QVector< Simulation > results;
+    int runs;
+    int hits;
+
+    // Metrics of the branch being simulated. Alarm stages mark silenced
+    // samples in place, so each alarm branch is finished before the next.
+    QVector< SimulationSample > samples;
+
+    static QVector< Group > partition(const Group &members,
+                                      SimulationGraph::Node node,
+                                      const QVector< Configuration > &configurations);
+};
+
+#endif // SIMULATIONCOMPARISON_H
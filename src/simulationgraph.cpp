@@ -0,0 +1,238 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "simulationgraph.h"
+
+#include <QtAlgorithms>
+
+#include "alarmstage.h"
+#include "sasstage.h"
+#include "speechstage.h"
+#include "tonestage.h"
+#include "trackresampler.h"
+#include "tracksmoother.h"
+
+SimulationGraph::SimulationGraph() :
+    smoothing(0)
+{
+    for (int i = 0; i < NodeCount; ++i)
+    {
+        valid[i] = false;
+    }
+}
+
+void SimulationGraph::setTrack(
+        const Track &track)
+{
+    source = track;
+
+    for (int i = 0; i < NodeCount; ++i)
+    {
+        valid[i] = false;
+    }
+}
+
+void SimulationGraph::setSmoothing(
+        double window)
+{
+    if (window == smoothing) return;
+
+    // The window is not part of the configuration, so it invalidates
+    // the node directly
+    smoothing = window;
+    valid[SmoothNode] = false;
+}
+
+QVector< int > SimulationGraph::key(
+        Node node,
+        const Configuration &configuration)
+{
+    QVector< int > key;
+
+    switch (node)
+    {
+    case ResampleNode:
+        key << configuration.rate;
+        break;
+    case MetricsNode:
+        key << configuration.groundElevation
+            << configuration.adjustSpeed;
+        break;
+    case AlarmNode:
+        key << configuration.alarmWindowAbove
+            << configuration.alarmWindowBelow;
+        foreach (const Configuration::Alarm &alarm, configuration.alarms)
+        {
+            key << alarm.elevation << alarm.mode;
+        }
+        key << -1;
+        foreach (const Configuration::Window &window, configuration.windows)
+        {
+            key << window.top << window.bottom;
+        }
+        break;
+    case ToneNode:
+        key << configuration.toneMode
+            << configuration.minTone
+            << configuration.maxTone
+            << configuration.limits
+            << configuration.rateMode
+            << configuration.minRateValue
+            << configuration.maxRateValue
+            << configuration.minRate
+            << configuration.maxRate
+            << configuration.flatline
+            << configuration.vThreshold
+            << configuration.hThreshold;
+        break;
+    case SpeechNode:
+        key << configuration.speechRate
+            << configuration.altitudeUnits
+            << configuration.altitudeStep
+            << configuration.vThreshold
+            << configuration.hThreshold;
+        foreach (const Configuration::Speech &speech, configuration.speeches)
+        {
+            key << speech.mode << speech.units << speech.decimals;
+        }
+        break;
+    default:
+        break;
+    }
+
+    return key;
+}
+
+bool SimulationGraph::isStale(
+        Node node,
+        const Configuration &configuration)
+{
+    const QVector< int > newKey = key(node, configuration);
+    if (valid[node] && newKey == keys[node]) return false;
+
+    keys[node] = newKey;
+    valid[node] = true;
+    return true;
+}
+
+int SimulationGraph::update(
+        const Configuration &configuration)
+{
+    int recomputed = 0;
+
+    // Each node is stale if its own fields changed or an input was recomputed
+    if (isStale(ResampleNode, configuration))
+    {
+        resampled = TrackResampler(configuration).resample(source);
+        recomputed |= 1 << ResampleNode;
+    }
+
+    if (isStale(SmoothNode, configuration) || (recomputed & (1 << ResampleNode)))
+    {
+        smoothed = TrackSmoother(smoothing).smooth(resampled);
+        recomputed |= 1 << SmoothNode;
+    }
+
+    if (isStale(MetricsNode, configuration) || (recomputed & (1 << SmoothNode)))
+    {
+        extractMetrics(configuration, smoothed, result, samples);
+        recomputed |= 1 << MetricsNode;
+    }
+
+    // Stale stages after the metrics share one pass over the samples
+    QVector< SimulationStage * > stages;
+
+    if (isStale(AlarmNode, configuration) || (recomputed & (1 << MetricsNode)))
+    {
+        stages.append(new AlarmStage(configuration));
+        recomputed |= 1 << AlarmNode;
+    }
+
+    if (isStale(ToneNode, configuration) || (recomputed & (1 << AlarmNode)))
+    {
+        stages.append(new ToneStage(configuration));
+        recomputed |= 1 << ToneNode;
+    }
+
+    if (isStale(SpeechNode, configuration) || (recomputed & (1 << AlarmNode)))
+    {
+        stages.append(new SpeechStage(configuration));
+        recomputed |= 1 << SpeechNode;
+    }
+
+    foreach (SimulationStage *stage, stages)
+    {
+        stage->start(result, smoothed);
+    }
+    runStages(stages, samples);
+    qDeleteAll(stages);
+
+    return recomputed;
+}
+
+void SimulationGraph::extractMetrics(
+        const Configuration &configuration,
+        const Track &track,
+        Simulation &simulation,
+        QVector< SimulationSample > &samples)
+{
+    const int size = track.size();
+    samples.resize(size);
+
+    SasStage sas;
+    if (configuration.adjustSpeed)
+    {
+        sas.start(simulation, track);
+    }
+    else
+    {
+        simulation.airspeedFactor.clear();
+    }
+
+    for (int i = 0; i < size; ++i)
+    {
+        SimulationSample &sample = samples[i];
+        sample.extract(track, i, configuration.groundElevation);
+
+        if (configuration.adjustSpeed)
+        {
+            sas.process(sample);
+        }
+    }
+}
+
+void SimulationGraph::runStages(
+        const QVector< SimulationStage * > &stages,
+        QVector< SimulationSample > &samples)
+{
+    if (stages.isEmpty()) return;
+
+    SimulationSample *sample = samples.data();
+    for (int i = 0; i < samples.size(); ++i)
+    {
+        for (int j = 0; j < stages.size(); ++j)
+        {
+            stages[j]->process(sample[i]);
+        }
+    }
+}
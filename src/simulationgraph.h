@@ -0,0 +1,103 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef SIMULATIONGRAPH_H
+#define SIMULATIONGRAPH_H
+
+#include <QVector>
+
+#include "configuration.h"
+#include "simulator.h"
+#include "track.h"
+
+class SimulationStage;
+
+// Simulates one track while the configuration is being edited. Each
+// node keeps its results until a configuration field it reads changes,
+// or a node it depends on is recomputed:
+//
+//   Resample -> Smooth -> Metrics -> Alarms -> Tone
+//                                           -> Speech
+//
+// Stale alarm, tone and speech nodes run together in one pass over the
+// samples, so speech is simulated alongside the tone.
+class SimulationGraph
+{
+public:
+    typedef enum {
+        ResampleNode = 0,
+        SmoothNode,
+        MetricsNode,
+        AlarmNode,
+        ToneNode,
+        SpeechNode,
+        NodeCount
+    } Node;
+
+    SimulationGraph();
+
+    void setTrack(const Track &track);
+
+    // Savitzky-Golay window (s) applied to velocities, or zero for none
+    void setSmoothing(double window);
+
+    // Track as simulated, after resampling to Rate and smoothing
+    const Track &track() const { return smoothed; }
+
+    // Recomputes stale nodes, returning them as bits of (1 << Node)
+    int update(const Configuration &configuration);
+
+    const Simulation &simulation() const { return result; }
+
+    // Configuration fields read by a node
+    static QVector< int > key(Node node, const Configuration &configuration);
+
+    // Metrics of every sample of the track, after Use_SAS
+    static void extractMetrics(const Configuration &configuration,
+                               const Track &track, Simulation &simulation,
+                               QVector< SimulationSample > &samples);
+
+    // Runs started stages together in one pass over samples already
+    // extracted from the track. Each stage sees a sample after the
+    // stages before it, so alarms must come before tone and speech.
+    static void runStages(const QVector< SimulationStage * > &stages,
+                          QVector< SimulationSample > &samples);
+
+private:
+    Track source;
+    Track resampled;
+    Track smoothed;
+    Simulation result;
+
+    double smoothing;
+
+    // Samples after metric extraction, Use_SAS and alarms
+    QVector< SimulationSample > samples;
+
+    QVector< int > keys[NodeCount];
+    bool valid[NodeCount];
+
+    bool isStale(Node node, const Configuration &configuration);
+};
+
+#endif // SIMULATIONGRAPH_H
@@ -0,0 +1,75 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "simulator.h"
+
+#include <cmath>
+
+#include "track.h"
+
+#define RAD_TO_DEG 57.29577951308232
+
+void SimulationSample::extract(
+        const Track &track,
+        int i,
+        int groundElevation)
+{
+    const float velN = track.velN[i];
+    const float velE = track.velE[i];
+
+    const double h = sqrt(velN * velN + velE * velE) * 100;
+    const double v = track.velD[i] * 100.;
+
+    index = i;
+    time = track.time[i];
+    altitude = track.hMSL[i] - groundElevation;
+    horizontalSpeed = h;
+    verticalSpeed = v;
+    totalSpeed = sqrt(h * h + v * v);
+    glideRatio = (v != 0) ? h / v * 100 : 0;
+    inverseGlideRatio = (h != 0) ? v / h * 100 : 0;
+    diveAngle = atan2(v, h) * RAD_TO_DEG;
+    silenced = false;
+}
+
+double SimulationSample::value(
+        Configuration::Mode mode) const
+{
+    switch (mode)
+    {
+    case Configuration::HorizontalSpeed:   return horizontalSpeed;
+    case Configuration::VerticalSpeed:     return verticalSpeed;
+    case Configuration::GlideRatio:        return glideRatio;
+    case Configuration::InverseGlideRatio: return inverseGlideRatio;
+    case Configuration::TotalSpeed:        return totalSpeed;
+    case Configuration::Altitude:          return altitude;
+    case Configuration::DiveAngle:         return diveAngle;
+    default:                               return 0;
+    }
+}
+
+QString Simulation::speechText(
+        const Speech &speech)
+{
+    return QString::number(speech.value, 'f', qMax(speech.decimals, 0));
+}
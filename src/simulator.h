@@ -0,0 +1,101 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef SIMULATOR_H
+#define SIMULATOR_H
+
+#include <QVector>
+
+#include "alarmevaluator.h"
+#include "configuration.h"
+
+class Track;
+
+// Changed whenever SimulationSample::extract gives different metrics, so
+// results cached from them are rebuilt
+#define SIMULATION_SAMPLE_VERSION 1
+
+class SimulationSample
+{
+public:
+    int index;
+    double time;                // Seconds since epoch (UTC)
+    double altitude;            // m above ground
+    double horizontalSpeed;     // cm/s
+    double verticalSpeed;       // cm/s
+    double totalSpeed;          // cm/s
+    double glideRatio;          // ratio * 100
+    double inverseGlideRatio;   // ratio * 100
+    double diveAngle;           // degrees
+    bool silenced;              // Inside an alarm or silence window
+
+    // Metrics for one track sample, before any stage has run
+    void extract(const Track &track, int i, int groundElevation);
+
+    double value(Configuration::Mode mode) const;
+};
+
+class Simulation
+{
+public:
+    typedef enum {
+        Silent = 0,
+        Tone,
+        ChirpUp,
+        ChirpDown
+    } ToneState;
+
+    typedef struct {
+        int sample;
+        double time;                // Seconds since epoch (UTC)
+        int index;                  // Speech index, -1 for Alt_Step
+        Configuration::Mode mode;
+        double value;               // Rounded, in spoken units
+        int decimals;
+    } Speech;
+
+    typedef QVector< Speech > Speeches;
+
+    QVector< float > pitch;         // 0 (minimum) to 1 (maximum)
+    QVector< float > rate;          // Beeps per second, 0 for continuous
+    QVector< quint8 > state;
+    QVector< float > airspeedFactor;    // Use_SAS speed scale, empty if off
+
+    AlarmEvaluator::Events alarms;
+    Speeches speech;
+
+    static QString speechText(const Speech &speech);
+};
+
+class SimulationStage
+{
+public:
+    virtual ~SimulationStage() {}
+
+    // Stages write their results into the simulation, and may process
+    // whole columns of the track before the per-sample pass
+    virtual void start(Simulation &simulation, const Track &track) = 0;
+    virtual void process(SimulationSample &sample) = 0;
+};
+
+#endif // SIMULATOR_H
@@ -0,0 +1,154 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "speechstage.h"
+
+#include <cmath>
+
+#define CMS_PER_KMH  27.77777777777778
+#define CMS_PER_MPH  44.70416666666667
+#define CMS_PER_KNOT 51.44444444444444
+#define M_PER_FT     0.3048
+
+// Altitude is not announced below this height (m)
+#define MIN_ALTITUDE 1500
+
+SpeechStage::SpeechStage(
+        const Configuration &configuration) :
+    configuration(configuration),
+    events(0),
+    nextTime(0),
+    nextSpeech(0),
+    hasPrevious(false),
+    prevAltitude(0)
+{
+
+}
+
+void SpeechStage::start(
+        Simulation &simulation,
+        const Track &track)
+{
+    Q_UNUSED(track);
+
+    events = &simulation.speech;
+    events->clear();
+
+    nextTime = 0;
+    nextSpeech = 0;
+    hasPrevious = false;
+}
+
+double SpeechStage::spokenValue(
+        const Configuration::Speech &speech,
+        const SimulationSample &sample)
+{
+    double value = sample.value(speech.mode);
+
+    switch (speech.mode)
+    {
+    case Configuration::HorizontalSpeed:
+    case Configuration::VerticalSpeed:
+    case Configuration::TotalSpeed:
+        switch (speech.units)
+        {
+        case Configuration::Kilometers: value /= CMS_PER_KMH;  break;
+        case Configuration::Miles:      value /= CMS_PER_MPH;  break;
+        case Configuration::Knots:      value /= CMS_PER_KNOT; break;
+        }
+        break;
+    case Configuration::GlideRatio:
+    case Configuration::InverseGlideRatio:
+        value /= 100;
+        break;
+    case Configuration::Altitude:
+        // Sp_Dec holds the altitude step in this mode
+        if (speech.units == Configuration::Miles) value /= M_PER_FT;
+        if (speech.decimals > 0) return floor(value / speech.decimals) * speech.decimals;
+        return floor(value);
+    default:
+        break;
+    }
+
+    const double scale = pow(10., speech.decimals);
+    return qRound64(value * scale) / scale;
+}
+
+void SpeechStage::speak(
+        int index,
+        Configuration::Mode mode,
+        double value,
+        int decimals,
+        const SimulationSample &sample)
+{
+    Simulation::Speech speech;
+    speech.sample = sample.index;
+    speech.time = sample.time;
+    speech.index = index;
+    speech.mode = mode;
+    speech.value = value;
+    speech.decimals = decimals;
+    events->append(speech);
+}
+
+void SpeechStage::process(
+        SimulationSample &sample)
+{
+    const bool active = !sample.silenced
+            && sample.verticalSpeed >= configuration.vThreshold
+            && sample.horizontalSpeed >= configuration.hThreshold;
+
+    // Speech modes take turns every Sp_Rate seconds
+    if (active && configuration.speechRate > 0
+            && !configuration.speeches.isEmpty()
+            && sample.time >= nextTime)
+    {
+        const Configuration::Speech &speech = configuration.speeches[nextSpeech];
+        const int decimals = (speech.mode == Configuration::Altitude) ? 0 : speech.decimals;
+
+        speak(nextSpeech, speech.mode, spokenValue(speech, sample), decimals, sample);
+
+        nextSpeech = (nextSpeech + 1) % configuration.speeches.size();
+        nextTime = sample.time + configuration.speechRate;
+    }
+
+    // Altitude callouts every Alt_Step while descending
+    const double altitude = (configuration.altitudeUnits == Configuration::Feet)
+            ? sample.altitude / M_PER_FT : sample.altitude;
+    const double minimum = (configuration.altitudeUnits == Configuration::Feet)
+            ? MIN_ALTITUDE / M_PER_FT : MIN_ALTITUDE;
+    const int step = configuration.altitudeStep;
+
+    if (active && step > 0 && hasPrevious && altitude < prevAltitude)
+    {
+        // Lowest step crossed since the previous sample
+        const double crossed = (floor(altitude / step) + 1) * step;
+        if (crossed <= prevAltitude && crossed >= minimum)
+        {
+            speak(-1, Configuration::Altitude, crossed, 0, sample);
+        }
+    }
+
+    hasPrevious = true;
+    prevAltitude = altitude;
+}
@@ -0,0 +1,55 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef SPEECHSTAGE_H
+#define SPEECHSTAGE_H
+
+#include "configuration.h"
+#include "simulator.h"
+
+class SpeechStage : public SimulationStage
+{
+public:
+    explicit SpeechStage(const Configuration &configuration);
+
+    void start(Simulation &simulation, const Track &track);
+    void process(SimulationSample &sample);
+
+    static double spokenValue(const Configuration::Speech &speech,
+                              const SimulationSample &sample);
+
+private:
+    Configuration configuration;
+    Simulation::Speeches *events;
+
+    double nextTime;
+    int nextSpeech;
+
+    bool hasPrevious;
+    double prevAltitude;
+
+    void speak(int index, Configuration::Mode mode, double value,
+               int decimals, const SimulationSample &sample);
+};
+
+#endif // SPEECHSTAGE_H
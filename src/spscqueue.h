@@ -0,0 +1,93 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <QAtomicInteger>
+#include <QVector>
+
+// Bounded queue for one producer thread and one consumer thread. Neither
+// side takes a lock. Each index is written by one side only, and published
+// with release ordering so the slot it covers is visible to the other.
+template < typename T >
+class SpscQueue
+{
+public:
+    // Capacity is rounded up to a power of two
+    explicit SpscQueue(int capacity) :
+        head(0),
+        tail(0)
+    {
+        int size = 1;
+        while (size < capacity) size *= 2;
+
+        buffer.resize(size);
+        items = buffer.data();
+        mask = size - 1;
+    }
+
+    int capacity() const { return buffer.size(); }
+
+    // Called by the producer. Returns false if the queue is full.
+    bool push(const T &value)
+    {
+        const quint32 h = head.load();
+        if (h - tail.loadAcquire() > mask) return false;
+
+        items[h & mask] = value;
+        head.storeRelease(h + 1);
+        return true;
+    }
+
+    // Called by the consumer. Returns false if the queue is empty.
+    bool pop(T &value)
+    {
+        const quint32 t = tail.load();
+        if (t == head.loadAcquire()) return false;
+
+        value = items[t & mask];
+        tail.storeRelease(t + 1);
+        return true;
+    }
+
+    bool isEmpty() const
+    {
+        return tail.loadAcquire() == head.loadAcquire();
+    }
+
+private:
+    QVector< T > buffer;
+    T *items;
+    quint32 mask;
+
+    // Kept on separate cache lines so the two threads don't contend
+    QAtomicInteger< quint32 > head;
+    char headPadding[64 - sizeof(QAtomicInteger< quint32 >)];
+    QAtomicInteger< quint32 > tail;
+    char tailPadding[64 - sizeof(QAtomicInteger< quint32 >)];
+
+    Q_DISABLE_COPY(SpscQueue)
+};
+
+#endif // SPSCQUEUE_H
@@ -0,0 +1,178 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "suggestdialog.h"
+#include "ui_suggestdialog.h"
+
+#include <QDir>
+#include <QPushButton>
+#include <QTreeWidgetItem>
+
+#include "trackreader.h"
+
+SuggestDialog::SuggestDialog(
+        const Configuration &configuration,
+        const QString &folder,
+        QWidget *parent) :
+    QDialog(parent),
+    ui(new Ui::SuggestDialog),
+    configuration(configuration),
+    suggested(configuration),
+    files(0),
+    freefalls(0)
+{
+    ui->setupUi(this);
+
+    ui->treeWidget->setHeaderLabels(
+                QStringList() << tr("Setting") << tr("Current") << tr("Suggested"));
+
+    // Nothing to apply until every file is in
+    ui->buttonBox->button(QDialogButtonBox::Ok)->setEnabled(false);
+
+    const QStringList fileNames = TrackReader::findTracks(folder);
+    ui->statusLabel->setText(tr("Reading %1 tracks in %2...")
+                             .arg(fileNames.size())
+                             .arg(QDir::toNativeSeparators(folder)));
+
+    connect(&watcher, SIGNAL(progressRangeChanged(int,int)),
+            ui->progressBar, SLOT(setRange(int,int)));
+    connect(&watcher, SIGNAL(progressValueChanged(int)),
+            ui->progressBar, SLOT(setValue(int)));
+    connect(&watcher, SIGNAL(resultReadyAt(int)),
+            this, SLOT(addResult(int)));
+    connect(&watcher, SIGNAL(finished()),
+            this, SLOT(finished()));
+
+    watcher.setFuture(RangeSuggester::sketchFiles(fileNames, configuration.adjustSpeed));
+}
+
+SuggestDialog::~SuggestDialog()
+{
+    // Stop processing before results are discarded
+    watcher.cancel();
+    watcher.waitForFinished();
+
+    delete ui;
+}
+
+void SuggestDialog::addResult(
+        int index)
+{
+    const RangeSuggester::Result result = watcher.resultAt(index);
+    if (!result.error.isEmpty()) return;
+
+    // Sketches are merged as files finish, so suggestions firm up as
+    // more jumps are read
+    suggester.add(result);
+    ++files;
+    freefalls += result.freefalls;
+
+    suggested = suggester.suggest(configuration);
+    updateTable();
+}
+
+void SuggestDialog::finished()
+{
+    // Files finish in a different order each run, and merge order changes
+    // what a sketch keeps, so merge again in file order for a suggestion
+    // which is the same every time
+    suggester.clear();
+    files = 0;
+    freefalls = 0;
+    foreach (const RangeSuggester::Result &result, watcher.future().results())
+    {
+        if (!result.error.isEmpty()) continue;
+
+        suggester.add(result);
+        ++files;
+        freefalls += result.freefalls;
+    }
+
+    suggested = suggester.suggest(configuration);
+    updateTable();
+
+    if (suggester.sampleCount() == 0)
+    {
+        ui->statusLabel->setText(tr("No freefall found in %n track(s).", 0, files));
+        return;
+    }
+
+    ui->statusLabel->setText(tr("Suggested from %1 freefalls in %2 tracks (%3 samples).")
+                             .arg(freefalls)
+                             .arg(files)
+                             .arg(suggester.sampleCount()));
+    ui->buttonBox->button(QDialogButtonBox::Ok)->setEnabled(true);
+}
+
+void SuggestDialog::updateTable()
+{
+    typedef struct {
+        QString name;
+        double current;
+        double suggested;
+    } Row;
+
+    const QString speedUnits = configuration.speedUnits();
+
+    QVector< Row > rows;
+    Row row;
+
+    row.name = tr("Tone minimum");
+    row.current = configuration.minToneToUnits();
+    row.suggested = suggested.minToneToUnits();
+    rows.append(row);
+
+    row.name = tr("Tone maximum");
+    row.current = configuration.maxToneToUnits();
+    row.suggested = suggested.maxToneToUnits();
+    rows.append(row);
+
+    row.name = tr("Rate minimum");
+    row.current = configuration.minRateToUnits();
+    row.suggested = suggested.minRateToUnits();
+    rows.append(row);
+
+    row.name = tr("Rate maximum");
+    row.current = configuration.maxRateToUnits();
+    row.suggested = suggested.maxRateToUnits();
+    rows.append(row);
+
+    row.name = tr("Vertical speed threshold (%1)").arg(speedUnits);
+    row.current = configuration.vThresholdToUnits();
+    row.suggested = suggested.vThresholdToUnits();
+    rows.append(row);
+
+    row.name = tr("Horizontal speed threshold (%1)").arg(speedUnits);
+    row.current = configuration.hThresholdToUnits();
+    row.suggested = suggested.hThresholdToUnits();
+    rows.append(row);
+
+    ui->treeWidget->clear();
+    foreach (const Row &r, rows)
+    {
+        QTreeWidgetItem *item = new QTreeWidgetItem(ui->treeWidget);
+        item->setText(0, r.name);
+        item->setText(1, QString::number(r.current, 'f', 2));
+        item->setText(2, QString::number(r.suggested, 'f', 2));
+    }
+}
@@ -0,0 +1,69 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef SUGGESTDIALOG_H
+#define SUGGESTDIALOG_H
+
+#include <QDialog>
+#include <QFutureWatcher>
+
+#include "configuration.h"
+#include "rangesuggester.h"
+
+namespace Ui {
+class SuggestDialog;
+}
+
+class SuggestDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit SuggestDialog(const Configuration &configuration,
+                           const QString &folder,
+                           QWidget *parent = 0);
+    ~SuggestDialog();
+
+    // Configuration with the suggested ranges applied
+    Configuration suggestion() const { return suggested; }
+
+private:
+    Ui::SuggestDialog *ui;
+
+    Configuration configuration;
+    Configuration suggested;
+
+    RangeSuggester suggester;
+    QFutureWatcher< RangeSuggester::Result > watcher;
+
+    int files;
+    int freefalls;
+
+    void updateTable();
+
+private slots:
+    void addResult(int index);
+    void finished();
+};
+
+#endif // SUGGESTDIALOG_H
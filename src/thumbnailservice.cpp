@@ -0,0 +1,272 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+#include "thumbnailservice.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QPainter>
+#include <QPolygonF>
+#include <QRunnable>
+#include <QStandardPaths>
+
+#include <cfloat>
+#include <cmath>
+
+#include "track.h"
+#include "trackcache.h"
+
+class ThumbnailWorker : public QRunnable
+{
+public:
+    ThumbnailWorker(ThumbnailService *service) : service(service) {}
+
+    void run()
+    {
+        // Keep going until the queue is empty, so visible files are
+        // picked up as soon as a worker is free
+        QString fileName;
+        while (service->takeNext(fileName))
+        {
+            emit service->rendered(fileName, service->renderFile(fileName));
+        }
+    }
+
+private:
+    ThumbnailService *service;
+};
+
+ThumbnailService::ThumbnailService(
+        const QSize &size,
+        QObject *parent) :
+    QObject(parent),
+    thumbnailSize(size),
+    memory(THUMBNAIL_MEMORY_SIZE),
+    workers(0),
+    stopping(false)
+{
+    // Delivered on the thread the service lives in
+    connect(this, SIGNAL(rendered(QString,QImage)),
+            this, SLOT(store(QString,QImage)));
+}
+
+ThumbnailService::~ThumbnailService()
+{
+    {
+        QMutexLocker locker(&mutex);
+        stopping = true;
+        pending.clear();
+    }
+
+    pool.waitForDone();
+}
+
+bool ThumbnailService::thumbnail(
+        const QString &fileName,
+        QImage &image)
+{
+    const QImage *cached = memory.object(fileName);
+    if (cached)
+    {
+        image = *cached;
+        return true;
+    }
+
+    QMutexLocker locker(&mutex);
+
+    if (queued.contains(fileName)) return false;
+
+    pending.append(fileName);
+    queued.insert(fileName);
+
+    if (workers < pool.maxThreadCount())
+    {
+        ++workers;
+        pool.start(new ThumbnailWorker(this));
+    }
+
+    return false;
+}
+
+void ThumbnailService::setVisible(
+        const QStringList &fileNames)
+{
+    QMutexLocker locker(&mutex);
+
+    visible.clear();
+    foreach (const QString &fileName, fileNames)
+    {
+        visible.insert(fileName);
+    }
+}
+
+bool ThumbnailService::takeNext(
+        QString &fileName)
+{
+    QMutexLocker locker(&mutex);
+
+    if (stopping || pending.isEmpty())
+    {
+        --workers;
+        return false;
+    }
+
+    // First visible file, or the oldest request if none are visible
+    int next = 0;
+    for (int i = 0; i < pending.size(); ++i)
+    {
+        if (visible.contains(pending[i]))
+        {
+            next = i;
+            break;
+        }
+    }
+
+    fileName = pending.takeAt(next);
+    return true;
+}
+
+void ThumbnailService::store(
+        const QString &fileName,
+        const QImage &image)
+{
+    {
+        QMutexLocker locker(&mutex);
+        queued.remove(fileName);
+    }
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
+    const int bytes = (int) image.sizeInBytes();
+#else
+    const int bytes = image.byteCount();
+#endif
+
+    // Failures are kept too, as an empty image, so they aren't retried
+    memory.insert(fileName, new QImage(image), qMax(bytes, 1));
+
+    emit thumbnailReady(fileName);
+}
+
+QString ThumbnailService::cachePath(
+        const QByteArray &hash) const
+{
+    if (hash.isEmpty()) return QString();
+
+    const QDir folder(QDir(QStandardPaths::writableLocation(
+                               QStandardPaths::CacheLocation)).filePath("thumbnails"));
+    return folder.filePath(QString("%1-%2x%3.png")
+                           .arg(QString::fromLatin1(hash.toHex()))
+                           .arg(thumbnailSize.width())
+                           .arg(thumbnailSize.height()));
+}
+
+QImage ThumbnailService::renderFile(
+        const QString &fileName) const
+{
+    Track track;
+    TrackCache cache;
+    if (!cache.load(fileName, track)) return QImage();
+
+    const QString path = cachePath(track.hash);
+
+    QImage image;
+    if (!path.isEmpty() && image.load(path, "PNG")) return image;
+
+    image = render(track, thumbnailSize);
+
+    // The cache is only an optimization, so failures are not reported
+    if (!path.isEmpty() && QDir().mkpath(QFileInfo(path).absolutePath()))
+    {
+        image.save(path, "PNG");
+    }
+
+    return image;
+}
+
+QImage ThumbnailService::render(
+        const Track &track,
+        const QSize &size)
+{
+    QImage image(size, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+
+    const int count = track.size();
+    const int columns = size.width();
+    if (count < 2 || columns < 1) return image;
+
+    const double *time = track.time.constData();
+    const float *hMSL = track.hMSL.constData();
+    const float *velN = track.velN.constData();
+    const float *velE = track.velE.constData();
+    const float *velD = track.velD.constData();
+
+    const double start = time[0];
+    const double span = qMax(time[count - 1] - start, 1e-3);
+
+    // Decimate to the lowest and highest altitude and the top speed
+    // under each pixel column
+    QVector< float > low(columns, FLT_MAX), high(columns, -FLT_MAX), speed(columns, -1);
+
+    float minAltitude = hMSL[0], maxAltitude = hMSL[0];
+    float maxSpeed = 0;
+
+    for (int i = 0; i < count; ++i)
+    {
+        const int x = qBound(0, (int) ((time[i] - start) / span * columns), columns - 1);
+        const float h = hMSL[i];
+        const float v = sqrt(velN[i] * velN[i] + velE[i] * velE[i] + velD[i] * velD[i]);
+
+        low[x] = qMin(low[x], h);
+        high[x] = qMax(high[x], h);
+        speed[x] = qMax(speed[x], v);
+
+        minAltitude = qMin(minAltitude, h);
+        maxAltitude = qMax(maxAltitude, h);
+        maxSpeed = qMax(maxSpeed, v);
+    }
+
+    const double bottom = size.height() - 1;
+    const double altitudeScale = bottom / qMax(maxAltitude - minAltitude, 1.f);
+    const double speedScale = bottom / qMax(maxSpeed, 1.f);
+
+    QPolygonF altitude, speeds;
+    for (int x = 0; x < columns; ++x)
+    {
+        if (speed[x] < 0) continue;
+
+        altitude << QPointF(x + 0.5, bottom - (high[x] - minAltitude) * altitudeScale)
+                 << QPointF(x + 0.5, bottom - (low[x] - minAltitude) * altitudeScale);
+        speeds << QPointF(x + 0.5, bottom - speed[x] * speedScale);
+    }
+
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    painter.setPen(QColor(255, 0, 0, 160));
+    painter.drawPolyline(speeds);
+
+    painter.setPen(Qt::blue);
+    painter.drawPolyline(altitude);
+
+    return image;
+}
@@ -0,0 +1,94 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+#ifndef THUMBNAILSERVICE_H
+#define THUMBNAILSERVICE_H
+
+#include <QCache>
+#include <QImage>
+#include <QMutex>
+#include <QObject>
+#include <QSet>
+#include <QSize>
+#include <QStringList>
+#include <QThreadPool>
+
+class Track;
+
+// Budget for thumbnails held in memory (bytes)
+#define THUMBNAIL_MEMORY_SIZE (16 * 1024 * 1024)
+
+// Renders altitude and speed sparklines of tracks on a pool of worker
+// threads. Thumbnails are kept on disk under the hash of the track, so
+// they survive renames, and the most recently used are kept in memory.
+// Files marked visible are rendered before the rest of the queue.
+class ThumbnailService : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ThumbnailService(const QSize &size, QObject *parent = 0);
+    ~ThumbnailService();
+
+    QSize size() const { return thumbnailSize; }
+
+    // Returns false and queues the file if the thumbnail isn't in memory.
+    // thumbnailReady is sent once it is.
+    bool thumbnail(const QString &fileName, QImage &image);
+
+    // Files currently on screen, which jump the queue
+    void setVisible(const QStringList &fileNames);
+
+    static QImage render(const Track &track, const QSize &size);
+
+signals:
+    void thumbnailReady(const QString &fileName);
+
+    // Sent from worker threads
+    void rendered(const QString &fileName, const QImage &image);
+
+private:
+    friend class ThumbnailWorker;
+
+    QSize thumbnailSize;
+
+    QCache< QString, QImage > memory;
+
+    QThreadPool pool;
+
+    // Shared with workers
+    QMutex mutex;
+    QStringList pending;
+    QSet< QString > queued;     // Pending or being rendered
+    QSet< QString > visible;
+    int workers;
+    bool stopping;
+
+    bool takeNext(QString &fileName);
+    QImage renderFile(const QString &fileName) const;
+    QString cachePath(const QByteArray &hash) const;
+
+private slots:
+    void store(const QString &fileName, const QImage &image);
+};
+
+#endif // THUMBNAILSERVICE_H
@@ -0,0 +1,201 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+#include "timezonedialog.h"
+#include "ui_timezonedialog.h"
+
+#include <QApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QFileDialog>
+#include <QPushButton>
+#include <QSettings>
+
+#include "timezoneresolver.h"
+#include "track.h"
+#include "trackcache.h"
+
+TimeZoneDialog::TimeZoneDialog(
+        TimeZoneResolver *resolver,
+        QWidget *parent) :
+    QDialog(parent),
+    ui(new Ui::TimeZoneDialog),
+    resolver(resolver),
+    time(QDateTime::currentMSecsSinceEpoch() / 1000.0),
+    timeZoneOffset(0)
+{
+    ui->setupUi(this);
+
+    // Initialize settings object
+    QSettings settings("FlySight", "Configurator");
+
+    const QString fileName = settings.value("timeZoneFile").toString();
+    ui->fileEdit->setText(QDir::toNativeSeparators(fileName));
+    if (resolver->isEmpty() && !fileName.isEmpty()) load(fileName);
+
+    ui->latitudeSpinBox->setValue(settings.value("timeZoneLatitude").toDouble());
+    ui->longitudeSpinBox->setValue(settings.value("timeZoneLongitude").toDouble());
+
+    connect(ui->latitudeSpinBox, SIGNAL(valueChanged(double)),
+            this, SLOT(lookUp()));
+    connect(ui->longitudeSpinBox, SIGNAL(valueChanged(double)),
+            this, SLOT(lookUp()));
+
+    lookUp();
+}
+
+TimeZoneDialog::~TimeZoneDialog()
+{
+    delete ui;
+}
+
+void TimeZoneDialog::load(
+        const QString &fileName)
+{
+    // Boundary files are large, so this takes a few seconds
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    resolver->load(fileName);
+    QApplication::restoreOverrideCursor();
+}
+
+void TimeZoneDialog::on_browseButton_clicked()
+{
+    QString fileName = QFileDialog::getOpenFileName(
+                this,
+                tr("Time Zone Boundaries"),
+                QDir::fromNativeSeparators(ui->fileEdit->text()),
+                tr("GeoJSON files (*.json *.geojson)"));
+
+    // Return now if user canceled
+    if (fileName.isEmpty()) return;
+
+    ui->fileEdit->setText(QDir::toNativeSeparators(fileName));
+    on_fileEdit_editingFinished();
+}
+
+void TimeZoneDialog::on_fileEdit_editingFinished()
+{
+    const QString fileName = QDir::fromNativeSeparators(ui->fileEdit->text());
+
+    // Initialize settings object
+    QSettings settings("FlySight", "Configurator");
+    if (fileName == settings.value("timeZoneFile").toString()
+            && !resolver->isEmpty()) return;
+
+    // Remember file for next time
+    settings.setValue("timeZoneFile", fileName);
+
+    load(fileName);
+    lookUp();
+}
+
+void TimeZoneDialog::on_trackButton_clicked()
+{
+    // Initialize settings object
+    QSettings settings("FlySight", "Configurator");
+
+    QString fileName = QFileDialog::getOpenFileName(
+                this,
+                tr("First Fix from Track"),
+                settings.value("logbookFolder").toString(),
+                tr("FlySight tracks (*.csv)"));
+
+    // Return now if user canceled
+    if (fileName.isEmpty()) return;
+
+    Track track;
+    TrackCache cache;
+    if (!cache.load(fileName, track))
+    {
+        ui->statusLabel->setText(cache.errorString());
+        return;
+    }
+
+    if (track.size() == 0)
+    {
+        ui->statusLabel->setText(tr("No fixes in %1.")
+                                 .arg(QDir::toNativeSeparators(fileName)));
+        return;
+    }
+
+    // Daylight saving as it was when the track was logged
+    time = track.time[0];
+
+    // Look up once both are set
+    ui->latitudeSpinBox->blockSignals(true);
+    ui->latitudeSpinBox->setValue(track.lat[0]);
+    ui->latitudeSpinBox->blockSignals(false);
+    ui->longitudeSpinBox->setValue(track.lon[0]);
+}
+
+void TimeZoneDialog::lookUp()
+{
+    QPushButton *okButton = ui->buttonBox->button(QDialogButtonBox::Ok);
+
+    if (resolver->isEmpty())
+    {
+        const QString error = resolver->errorString();
+        ui->statusLabel->setText(error.isEmpty()
+                                 ? tr("Choose a time zone boundary file.")
+                                 : tr("Couldn't read boundaries: %1").arg(error));
+        okButton->setEnabled(false);
+        return;
+    }
+
+    const double lat = ui->latitudeSpinBox->value();
+    const double lon = ui->longitudeSpinBox->value();
+
+    const QString zone = resolver->zoneAt(lat, lon);
+    timeZoneOffset = resolver->offsetAt(lat, lon, time);
+
+    const QString date = QDateTime::fromMSecsSinceEpoch(
+                (qint64) (time * 1000), Qt::UTC).toString("yyyy-MM-dd");
+
+    if (zone.isEmpty())
+    {
+        ui->statusLabel->setText(tr("Outside every zone; nautical time is %1.")
+                                 .arg(formatOffset(timeZoneOffset)));
+    }
+    else
+    {
+        ui->statusLabel->setText(tr("%1 is %2 on %3.")
+                                 .arg(zone)
+                                 .arg(formatOffset(timeZoneOffset))
+                                 .arg(date));
+    }
+    okButton->setEnabled(true);
+
+    // Remember position for next time
+    QSettings settings("FlySight", "Configurator");
+    settings.setValue("timeZoneLatitude", lat);
+    settings.setValue("timeZoneLongitude", lon);
+}
+
+QString TimeZoneDialog::formatOffset(
+        int offset)
+{
+    const int minutes = qAbs(offset) / 60;
+    return QString("UTC%1%2:%3")
+            .arg(offset < 0 ? '-' : '+')
+            .arg(minutes / 60, 2, 10, QChar('0'))
+            .arg(minutes % 60, 2, 10, QChar('0'));
+}
@@ -0,0 +1,66 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+#ifndef TIMEZONEDIALOG_H
+#define TIMEZONEDIALOG_H
+
+#include <QDialog>
+
+class TimeZoneResolver;
+
+namespace Ui {
+class TimeZoneDialog;
+}
+
+class TimeZoneDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    // Boundaries are loaded into the resolver if it is empty, so they
+    // can be kept for the next lookup
+    explicit TimeZoneDialog(TimeZoneResolver *resolver, QWidget *parent = 0);
+    ~TimeZoneDialog();
+
+    // Seconds from UTC, as TZ_Offset is stored
+    int offset() const { return timeZoneOffset; }
+
+private:
+    Ui::TimeZoneDialog *ui;
+
+    TimeZoneResolver *resolver;
+    double time;
+    int timeZoneOffset;
+
+    void load(const QString &fileName);
+
+    static QString formatOffset(int offset);
+
+private slots:
+    void on_browseButton_clicked();
+    void on_trackButton_clicked();
+    void on_fileEdit_editingFinished();
+
+    void lookUp();
+};
+
+#endif // TIMEZONEDIALOG_H
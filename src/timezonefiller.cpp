@@ -0,0 +1,96 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+#include "timezonefiller.h"
+
+#include <QObject>
+#include <QtConcurrent>
+
+#include "configurationfile.h"
+#include "timezoneresolver.h"
+#include "track.h"
+#include "trackcache.h"
+
+class FillTimeZone
+{
+public:
+    typedef TimeZoneFiller::Result result_type;
+
+    FillTimeZone(const TimeZoneResolver *resolver) : resolver(resolver) {}
+
+    TimeZoneFiller::Result operator()(const QString &fileName) const
+    {
+        return TimeZoneFiller::fillFile(fileName, resolver);
+    }
+
+private:
+    const TimeZoneResolver *resolver;
+};
+
+QFuture< TimeZoneFiller::Result > TimeZoneFiller::fillFiles(
+        const QStringList &fileNames,
+        const TimeZoneResolver *resolver)
+{
+    return QtConcurrent::mapped(fileNames, FillTimeZone(resolver));
+}
+
+TimeZoneFiller::Result TimeZoneFiller::fillFile(
+        const QString &fileName,
+        const TimeZoneResolver *resolver)
+{
+    Result result;
+    result.fileName = fileName;
+    result.offset = 0;
+
+    result.trackName = ConfigurationFile::latestTrack(fileName);
+    if (result.trackName.isEmpty())
+    {
+        result.error = QObject::tr("No tracks beside configuration");
+        return result;
+    }
+
+    Track track;
+    TrackCache cache;
+    if (!cache.load(result.trackName, track))
+    {
+        result.error = cache.errorString();
+        return result;
+    }
+
+    if (track.size() == 0)
+    {
+        result.error = QObject::tr("No fixes in track");
+        return result;
+    }
+
+    // Offset in effect when the track was logged
+    result.zone = resolver->zoneAt(track.lat[0], track.lon[0]);
+    result.offset = resolver->offsetAt(track.lat[0], track.lon[0], track.time[0]);
+
+    QString error;
+    if (!ConfigurationFile::setValue(fileName, "TZ_Offset", result.offset, error))
+    {
+        result.error = error;
+    }
+
+    return result;
+}
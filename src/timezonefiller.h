@@ -0,0 +1,51 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+#ifndef TIMEZONEFILLER_H
+#define TIMEZONEFILLER_H
+
+#include <QFuture>
+#include <QString>
+#include <QStringList>
+
+class TimeZoneResolver;
+
+// Sets TZ_Offset in each configuration of a library from the first fix
+// of the latest track stored beside it
+class TimeZoneFiller
+{
+public:
+    typedef struct {
+        QString fileName;
+        QString trackName;
+        QString zone;       // Empty outside every zone
+        int offset;         // s
+        QString error;      // Empty on success
+    } Result;
+
+    // The resolver must outlive the future
+    static QFuture< Result > fillFiles(const QStringList &fileNames,
+                                       const TimeZoneResolver *resolver);
+    static Result fillFile(const QString &fileName, const TimeZoneResolver *resolver);
+};
+
+#endif // TIMEZONEFILLER_H
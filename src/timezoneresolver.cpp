@@ -0,0 +1,445 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+#include "timezoneresolver.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QObject>
+#include <QTimeZone>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+typedef struct {
+    int row;
+    float x;
+    int polygon;
+} Crossing;
+
+bool operator<(
+        const Crossing &a,
+        const Crossing &b)
+{
+    return (a.row != b.row) ? (a.row < b.row) : (a.x < b.x);
+}
+
+inline double orient(
+        double ax, double ay,
+        double bx, double by,
+        double cx, double cy)
+{
+    return (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+}
+
+QVector< QPointF > readRing(
+        const QJsonArray &array)
+{
+    QVector< QPointF > ring;
+    ring.reserve(array.size());
+
+    foreach (const QJsonValue &value, array)
+    {
+        const QJsonArray point = value.toArray();
+        if (point.size() < 2) continue;
+        ring.append(QPointF(point[0].toDouble(), point[1].toDouble()));
+    }
+
+    // GeoJSON repeats the first point at the end
+    if (ring.size() > 1 && ring.first() == ring.last()) ring.removeLast();
+
+    return ring;
+}
+
+QVector< QVector< QPointF > > readPolygon(
+        const QJsonArray &array)
+{
+    QVector< QVector< QPointF > > rings;
+    foreach (const QJsonValue &value, array)
+    {
+        rings.append(readRing(value.toArray()));
+    }
+    return rings;
+}
+
+} // namespace
+
+TimeZoneResolver::TimeZoneResolver() :
+    columns(0),
+    rows(0)
+{
+
+}
+
+bool TimeZoneResolver::load(
+        const QString &fileName)
+{
+    clear();
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        error = file.errorString();
+        return false;
+    }
+
+    QJsonParseError parseError;
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (document.isNull())
+    {
+        error = parseError.errorString();
+        return false;
+    }
+
+    foreach (const QJsonValue &value, document.object()["features"].toArray())
+    {
+        const QJsonObject feature = value.toObject();
+        const QString zone = feature["properties"].toObject()["tzid"].toString();
+        const QJsonObject geometry = feature["geometry"].toObject();
+        const QString type = geometry["type"].toString();
+        const QJsonArray coordinates = geometry["coordinates"].toArray();
+
+        if (zone.isEmpty()) continue;
+
+        if (type == "Polygon")
+        {
+            addPolygon(zone, readPolygon(coordinates));
+        }
+        else if (type == "MultiPolygon")
+        {
+            foreach (const QJsonValue &polygon, coordinates)
+            {
+                addPolygon(zone, readPolygon(polygon.toArray()));
+            }
+        }
+    }
+
+    if (polygons.isEmpty())
+    {
+        error = QObject::tr("No time zone boundaries in file");
+        return false;
+    }
+
+    build();
+    return true;
+}
+
+void TimeZoneResolver::clear()
+{
+    error.clear();
+
+    zones.clear();
+    polygons.clear();
+    edges.clear();
+
+    columns = rows = 0;
+
+    cellZone.clear();
+    cellGroups.clear();
+    groups.clear();
+    cellEdges.clear();
+}
+
+void TimeZoneResolver::addPolygon(
+        const QString &zone,
+        const QVector< QVector< QPointF > > &rings)
+{
+    Polygon polygon;
+
+    polygon.zone = zones.indexOf(zone);
+    if (polygon.zone < 0)
+    {
+        polygon.zone = zones.size();
+        zones.append(zone);
+    }
+
+    polygon.begin = edges.size();
+
+    foreach (const QVector< QPointF > &ring, rings)
+    {
+        if (ring.size() < 3) continue;
+
+        for (int i = 0; i < ring.size(); ++i)
+        {
+            const QPointF &a = ring[i];
+            const QPointF &b = ring[(i + 1) % ring.size()];
+
+            Edge edge;
+            edge.x1 = a.x();
+            edge.y1 = a.y();
+            edge.x2 = b.x();
+            edge.y2 = b.y();
+            edges.append(edge);
+        }
+    }
+
+    polygon.end = edges.size();
+
+    if (polygon.end > polygon.begin) polygons.append(polygon);
+}
+
+void TimeZoneResolver::build()
+{
+    columns = (int) (360 / TIMEZONE_CELL_SIZE);
+    rows = (int) (180 / TIMEZONE_CELL_SIZE);
+
+    const int cells = columns * rows;
+
+    QVector< int > edgePolygon(edges.size());
+    for (int p = 0; p < polygons.size(); ++p)
+    {
+        for (int e = polygons[p].begin; e < polygons[p].end; ++e)
+        {
+            edgePolygon[e] = p;
+        }
+    }
+
+    // Bucket edges by the cells their bounds cover, in two passes so the
+    // buckets can share one array. Edges stay in polygon order within a
+    // cell, so each polygon's edges are contiguous.
+    QVector< int > cellStart(cells + 1, 0);
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        QVector< int > next;
+        if (pass == 1)
+        {
+            for (int c = 0; c < cells; ++c) cellStart[c + 1] += cellStart[c];
+            cellEdges.resize(cellStart[cells]);
+            next = cellStart;
+        }
+
+        for (int e = 0; e < edges.size(); ++e)
+        {
+            const Edge &edge = edges[e];
+
+            const int c0 = qBound(0, (int) floor((qMin(edge.x1, edge.x2) + 180) / TIMEZONE_CELL_SIZE), columns - 1);
+            const int c1 = qBound(0, (int) floor((qMax(edge.x1, edge.x2) + 180) / TIMEZONE_CELL_SIZE), columns - 1);
+            const int r0 = qBound(0, (int) floor((qMin(edge.y1, edge.y2) + 90) / TIMEZONE_CELL_SIZE), rows - 1);
+            const int r1 = qBound(0, (int) floor((qMax(edge.y1, edge.y2) + 90) / TIMEZONE_CELL_SIZE), rows - 1);
+
+            for (int r = r0; r <= r1; ++r)
+            {
+                for (int c = c0; c <= c1; ++c)
+                {
+                    const int cell = r * columns + c;
+                    if (pass == 0) ++cellStart[cell + 1];
+                    else cellEdges[next[cell]++] = e;
+                }
+            }
+        }
+    }
+
+    // One group per polygon crossing each cell
+    cellGroups.resize(cells + 1);
+    groups.clear();
+    for (int c = 0; c < cells; ++c)
+    {
+        cellGroups[c] = groups.size();
+        for (int i = cellStart[c]; i < cellStart[c + 1]; ++i)
+        {
+            const int p = edgePolygon[cellEdges[i]];
+            if (groups.size() > cellGroups[c] && groups.last().polygon == p)
+            {
+                groups.last().end = i + 1;
+            }
+            else
+            {
+                Group group;
+                group.polygon = p;
+                group.inside = false;
+                group.begin = i;
+                group.end = i + 1;
+                groups.append(group);
+            }
+        }
+    }
+    cellGroups[cells] = groups.size();
+
+    // Crossings of each row of cell centres, for a sweep from west to east
+    QVector< Crossing > crossings;
+    for (int e = 0; e < edges.size(); ++e)
+    {
+        const Edge &edge = edges[e];
+        if (edge.y1 == edge.y2) continue;
+
+        const int r0 = qMax(0, (int) ceil((qMin(edge.y1, edge.y2) + 90) / TIMEZONE_CELL_SIZE - 0.5));
+        const int r1 = qMin(rows - 1, (int) floor((qMax(edge.y1, edge.y2) + 90) / TIMEZONE_CELL_SIZE - 0.5));
+
+        for (int r = r0; r <= r1; ++r)
+        {
+            const double y = -90 + (r + 0.5) * TIMEZONE_CELL_SIZE;
+            if ((edge.y1 > y) == (edge.y2 > y)) continue;
+
+            Crossing crossing;
+            crossing.row = r;
+            crossing.x = edge.x1 + (y - edge.y1) * (edge.x2 - edge.x1) / (edge.y2 - edge.y1);
+            crossing.polygon = edgePolygon[e];
+            crossings.append(crossing);
+        }
+    }
+    std::sort(crossings.begin(), crossings.end());
+
+    cellZone.fill(-1, cells);
+
+    QVector< char > inside(polygons.size(), 0);
+    QVector< int > active;
+
+    int k = 0;
+    for (int r = 0; r < rows; ++r)
+    {
+        for (int c = 0; c < columns; ++c)
+        {
+            const double x = -180 + (c + 0.5) * TIMEZONE_CELL_SIZE;
+
+            // Polygons containing the centre are those crossed an odd
+            // number of times to its west
+            for (; k < crossings.size() && crossings[k].row == r && crossings[k].x < x; ++k)
+            {
+                const int p = crossings[k].polygon;
+                inside[p] ^= 1;
+                if (inside[p]) active.append(p);
+                else active.remove(active.indexOf(p));
+            }
+
+            const int cell = r * columns + c;
+            for (int g = cellGroups[cell]; g < cellGroups[cell + 1]; ++g)
+            {
+                groups[g].inside = inside[groups[g].polygon];
+            }
+
+            // A polygon which contains the centre without crossing the
+            // cell contains all of it
+            foreach (int p, active)
+            {
+                bool crosses = false;
+                for (int g = cellGroups[cell]; g < cellGroups[cell + 1]; ++g)
+                {
+                    if (groups[g].polygon == p) crosses = true;
+                }
+                if (!crosses)
+                {
+                    cellZone[cell] = p;
+                    break;
+                }
+            }
+        }
+
+        // Skip crossings east of the last centre
+        while (k < crossings.size() && crossings[k].row == r) ++k;
+
+        foreach (int p, active) inside[p] = 0;
+        active.clear();
+    }
+}
+
+int TimeZoneResolver::cellIndex(
+        double lat,
+        double lon,
+        double &centreX,
+        double &centreY) const
+{
+    const int c = qBound(0, (int) floor((lon + 180) / TIMEZONE_CELL_SIZE), columns - 1);
+    const int r = qBound(0, (int) floor((lat + 90) / TIMEZONE_CELL_SIZE), rows - 1);
+
+    centreX = -180 + (c + 0.5) * TIMEZONE_CELL_SIZE;
+    centreY = -90 + (r + 0.5) * TIMEZONE_CELL_SIZE;
+
+    return r * columns + c;
+}
+
+int TimeZoneResolver::zoneIndex(
+        double lat,
+        double lon) const
+{
+    if (polygons.isEmpty() || cellGroups.isEmpty()) return -1;
+
+    double cx, cy;
+    const int cell = cellIndex(lat, lon, cx, cy);
+
+    const double px = lon, py = lat;
+
+    for (int g = cellGroups[cell]; g < cellGroups[cell + 1]; ++g)
+    {
+        const Group &group = groups[g];
+
+        // Each edge crossed between the point and the centre flips
+        // whether the point is inside
+        bool inside = group.inside;
+        for (int i = group.begin; i < group.end; ++i)
+        {
+            const Edge &edge = edges[cellEdges[i]];
+
+            const bool a = orient(px, py, cx, cy, edge.x1, edge.y1) > 0;
+            const bool b = orient(px, py, cx, cy, edge.x2, edge.y2) > 0;
+            if (a == b) continue;
+
+            const bool p = orient(edge.x1, edge.y1, edge.x2, edge.y2, px, py) > 0;
+            const bool c = orient(edge.x1, edge.y1, edge.x2, edge.y2, cx, cy) > 0;
+            if (p != c) inside = !inside;
+        }
+
+        if (inside) return polygons[group.polygon].zone;
+    }
+
+    const int p = cellZone[cell];
+    return (p < 0) ? -1 : polygons[p].zone;
+}
+
+QString TimeZoneResolver::zoneAt(
+        double lat,
+        double lon) const
+{
+    const int index = zoneIndex(lat, lon);
+    return (index < 0) ? QString() : zones[index];
+}
+
+int TimeZoneResolver::offsetAt(
+        double lat,
+        double lon,
+        double time) const
+{
+    int offset;
+
+    const QString zone = zoneAt(lat, lon);
+    if (!zone.isEmpty() && zoneOffset(zone, time, offset)) return offset;
+
+    // Nautical time, one hour per 15 degrees
+    return qRound(lon / 15) * 3600;
+}
+
+bool TimeZoneResolver::zoneOffset(
+        const QString &zone,
+        double time,
+        int &offset)
+{
+    const QTimeZone timeZone(zone.toLatin1());
+    if (!timeZone.isValid()) return false;
+
+    offset = timeZone.offsetFromUtc(
+                QDateTime::fromMSecsSinceEpoch((qint64) (time * 1000), Qt::UTC));
+    return true;
+}
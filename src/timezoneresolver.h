@@ -0,0 +1,106 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+#ifndef TIMEZONERESOLVER_H
+#define TIMEZONERESOLVER_H
+
+#include <QPointF>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// Size of grid cells in the index (degrees)
+#define TIMEZONE_CELL_SIZE 0.5
+
+// Finds the time zone of a coordinate from zone boundary polygons, such
+// as the GeoJSON released by timezone-boundary-builder. Boundaries are
+// indexed on a grid: cells which no boundary crosses hold their zone
+// directly, and the rest hold the edges crossing them along with which
+// polygons contain the cell centre. A lookup then only tests the line
+// from the point to the centre of its cell against those edges.
+class TimeZoneResolver
+{
+public:
+    TimeZoneResolver();
+
+    bool load(const QString &fileName);
+    QString errorString() const { return error; }
+
+    void clear();
+    bool isEmpty() const { return polygons.isEmpty(); }
+
+    // Rings are closed implicitly, with x as longitude and y as latitude.
+    // Holes are given as further rings of the same polygon.
+    void addPolygon(const QString &zone, const QVector< QVector< QPointF > > &rings);
+
+    // Must be called after polygons are added and before any lookup
+    void build();
+
+    // -1 outside every zone
+    int zoneIndex(double lat, double lon) const;
+    QString zoneName(int index) const { return zones[index]; }
+    QString zoneAt(double lat, double lon) const;
+
+    // Offset of local time from UTC (s) at a time in seconds since epoch,
+    // daylight saving included. Outside every zone, or for zones the
+    // system doesn't know, the nautical offset of the longitude is used.
+    int offsetAt(double lat, double lon, double time) const;
+
+    static bool zoneOffset(const QString &zone, double time, int &offset);
+
+private:
+    typedef struct {
+        float x1, y1;
+        float x2, y2;
+    } Edge;
+
+    typedef struct {
+        int zone;
+        int begin;          // Edges of all rings
+        int end;
+    } Polygon;
+
+    typedef struct {
+        int polygon;
+        bool inside;        // Whether the polygon contains the cell centre
+        int begin;          // Into cellEdges
+        int end;
+    } Group;
+
+    QString error;
+
+    QStringList zones;
+    QVector< Polygon > polygons;
+    QVector< Edge > edges;
+
+    int columns;
+    int rows;
+
+    QVector< int > cellZone;        // Polygon filling a cell, or -1
+    QVector< int > cellGroups;      // Start of each cell's groups
+    QVector< Group > groups;
+    QVector< int > cellEdges;
+
+    int cellIndex(double lat, double lon, double &centreX, double &centreY) const;
+};
+
+#endif // TIMEZONERESOLVER_H
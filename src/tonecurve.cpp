@@ -0,0 +1,250 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "tonecurve.h"
+
+#include <QPainter>
+#include <QPen>
+
+#include <cmath>
+
+#include "tonestage.h"
+
+// Space reserved below the curve for value labels
+#define VALUE_AXIS_HEIGHT 16
+
+ToneCurve::ToneCurve(
+        QWidget *parent) :
+    QWidget(parent),
+    curveKind(Pitch),
+    valid(false),
+    minimum(0),
+    maximum(0)
+{
+    setMinimumSize(120, 80);
+}
+
+void ToneCurve::setKind(
+        Kind kind)
+{
+    if (kind == curveKind) return;
+
+    curveKind = kind;
+    valid = false;
+    setConfiguration(configuration);
+}
+
+QSize ToneCurve::sizeHint() const
+{
+    return QSize(240, 120);
+}
+
+void ToneCurve::setConfiguration(
+        const Configuration &newConfiguration)
+{
+    const bool changed = !valid || affectsCurve(newConfiguration);
+    configuration = newConfiguration;
+
+    if (!changed) return;
+
+    rebuild();
+    update();
+}
+
+bool ToneCurve::affectsCurve(
+        const Configuration &other) const
+{
+    if (other.displayUnits != configuration.displayUnits) return true;
+
+    switch (curveKind)
+    {
+    case Pitch:
+        return other.toneMode != configuration.toneMode
+                || other.minTone != configuration.minTone
+                || other.maxTone != configuration.maxTone
+                || other.limits != configuration.limits;
+    case Rate:
+        return other.toneMode != configuration.toneMode
+                || other.rateMode != configuration.rateMode
+                || other.minRateValue != configuration.minRateValue
+                || other.maxRateValue != configuration.maxRateValue
+                || other.minRate != configuration.minRate
+                || other.maxRate != configuration.maxRate
+                || other.flatline != configuration.flatline;
+    }
+
+    return true;
+}
+
+void ToneCurve::rebuild()
+{
+    double low, high;
+    if (curveKind == Pitch)
+    {
+        low = configuration.minTone;
+        high = configuration.maxTone;
+    }
+    else
+    {
+        low = configuration.minRateValue;
+        high = configuration.maxRateValue;
+    }
+
+    // Show a quarter of the range beyond either end
+    const double margin = qMax(fabs(high - low), 1.) / 4;
+    minimum = qMin(low, high) - margin;
+    maximum = qMax(low, high) + margin;
+
+    // Magnitude and change are never negative
+    if (curveKind == Rate
+            && (configuration.rateMode == Configuration::ValueMagnitude
+                || configuration.rateMode == Configuration::ValueChange))
+    {
+        minimum = qMax(minimum, 0.);
+    }
+
+    table.resize(TONE_CURVE_SIZE);
+    states.resize(TONE_CURVE_SIZE);
+
+    for (int i = 0; i < TONE_CURVE_SIZE; ++i)
+    {
+        const double value = minimum + (maximum - minimum) * i / (TONE_CURVE_SIZE - 1);
+
+        if (curveKind == Pitch)
+        {
+            double pitch;
+            states[i] = ToneStage::tone(configuration, value, pitch);
+            table[i] = pitch;
+        }
+        else
+        {
+            states[i] = Simulation::Tone;
+            table[i] = ToneStage::beepRate(configuration, value);
+        }
+    }
+
+    valid = true;
+}
+
+double ToneCurve::valueToUnits(
+        double value) const
+{
+    if (curveKind == Pitch)
+    {
+        return configuration.toneToUnits(qRound(value));
+    }
+    else
+    {
+        return configuration.rateToUnits(qRound(value));
+    }
+}
+
+void ToneCurve::paintEvent(
+        QPaintEvent *event)
+{
+    Q_UNUSED(event);
+
+    QPainter painter(this);
+    painter.fillRect(rect(), palette().base());
+
+    if (!valid) return;
+
+    const QRectF plot = QRectF(rect().adjusted(4, 4, -4, -VALUE_AXIS_HEIGHT));
+
+    // Pitch runs from 0 to 1, rate from 0 to the fastest beep
+    double top = 1;
+    if (curveKind == Rate)
+    {
+        top = qMax(configuration.minRate, configuration.maxRate) / 100.;
+        if (top <= 0) top = 1;
+    }
+
+    const double xScale = plot.width() / (TONE_CURVE_SIZE - 1);
+    const double yScale = plot.height() / top;
+
+    // Minimum and maximum guides, labelled in display units
+    double low, high;
+    if (curveKind == Pitch)
+    {
+        low = configuration.minTone;
+        high = configuration.maxTone;
+    }
+    else
+    {
+        low = configuration.minRateValue;
+        high = configuration.maxRateValue;
+    }
+
+    const double valueScale = plot.width() / (maximum - minimum);
+    const double guides[] = { low, high };
+    for (int i = 0; i < 2; ++i)
+    {
+        const double x = plot.left() + (guides[i] - minimum) * valueScale;
+
+        painter.setPen(QPen(palette().mid().color(), 0, Qt::DashLine));
+        painter.drawLine(QPointF(x, plot.top()), QPointF(x, plot.bottom()));
+
+        painter.setPen(palette().text().color());
+        painter.drawText(QRectF(x - 40, plot.bottom(), 80, VALUE_AXIS_HEIGHT),
+                         Qt::AlignCenter, QString::number(valueToUnits(guides[i])));
+    }
+
+    // Tone as a solid line, chirps as dashed lines at either end
+    QPolygonF points;
+    int state = -1;
+
+    for (int i = 0; i <= TONE_CURVE_SIZE; ++i)
+    {
+        const int next = (i < TONE_CURVE_SIZE) ? states[i] : -1;
+
+        if (next != state && !points.isEmpty())
+        {
+            switch (state)
+            {
+            case Simulation::Tone:
+                painter.setPen(QPen(palette().highlight().color(), 2));
+                break;
+            default:
+                painter.setPen(QPen(palette().highlight().color(), 2, Qt::DotLine));
+                break;
+            }
+            painter.drawPolyline(points);
+            points.clear();
+        }
+
+        if (i == TONE_CURVE_SIZE) break;
+
+        state = next;
+
+        double y;
+        switch (state)
+        {
+        case Simulation::Tone:      y = table[i];   break;
+        case Simulation::ChirpUp:   y = top;        break;
+        case Simulation::ChirpDown: y = 0;          break;
+        default:                    continue;
+        }
+
+        points << QPointF(plot.left() + i * xScale, plot.bottom() - y * yScale);
+    }
+}
@@ -0,0 +1,78 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef TONECURVE_H
+#define TONECURVE_H
+
+#include <QVector>
+#include <QWidget>
+
+#include "configuration.h"
+
+// Entries in the lookup table behind the curve
+#define TONE_CURVE_SIZE 256
+
+// Preview of how a value maps to tone pitch or beep rate. The curve is
+// drawn from a lookup table which is rebuilt only when a setting that
+// affects the mapping changes.
+class ToneCurve : public QWidget
+{
+    Q_OBJECT
+
+public:
+    typedef enum {
+        Pitch = 0,
+        Rate
+    } Kind;
+
+    explicit ToneCurve(QWidget *parent = 0);
+
+    Kind kind() const { return curveKind; }
+    void setKind(Kind kind);
+
+    void setConfiguration(const Configuration &configuration);
+
+    QSize sizeHint() const;
+
+protected:
+    void paintEvent(QPaintEvent *event);
+
+private:
+    Kind curveKind;
+    Configuration configuration;
+    bool valid;
+
+    // Range of values covered by the table
+    double minimum;
+    double maximum;
+
+    QVector< float > table;
+    QVector< quint8 > states;
+
+    bool affectsCurve(const Configuration &other) const;
+    void rebuild();
+
+    double valueToUnits(double value) const;
+};
+
+#endif // TONECURVE_H
@@ -51,6 +51,15 @@ ToneForm::ToneForm(QWidget *parent) :
 
     connect(ui->modeComboBox, SIGNAL(currentIndexChanged(int)),
             this, SIGNAL(selectionChanged()));
+
+    // Redraw the preview as values are typed
+    ui->curveWidget->setKind(ToneCurve::Pitch);
+    connect(ui->minimumEdit, SIGNAL(textEdited(QString)),
+            this, SLOT(updatePreview()));
+    connect(ui->maximumEdit, SIGNAL(textEdited(QString)),
+            this, SLOT(updatePreview()));
+    connect(ui->limitComboBox, SIGNAL(activated(int)),
+            this, SLOT(updatePreview()));
 }
 
 ToneForm::~ToneForm()
@@ -61,6 +70,8 @@ ToneForm::~ToneForm()
 void ToneForm::setConfiguration(
         const Configuration &configuration)
 {
+    this->configuration = configuration;
+
     int index = ui->modeComboBox->findData(configuration.toneMode);
     ui->modeComboBox->setCurrentIndex(index);
 
@@ -96,6 +107,8 @@ void ToneForm::setConfiguration(
         ui->maximumLabel->setText(tr("Maximum:"));
         break;
     }
+
+    ui->curveWidget->setConfiguration(configuration);
 }
 
 void ToneForm::updateConfiguration(
@@ -125,3 +138,10 @@ void ToneForm::updateConfiguration(
         configuration.toneVolume = ui->volumeComboBox->currentIndex();
     }
 }
+
+void ToneForm::updatePreview()
+{
+    Configuration preview = configuration;
+    updateConfiguration(preview, Values);
+    ui->curveWidget->setConfiguration(preview);
+}
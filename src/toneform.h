@@ -24,6 +24,7 @@
 #ifndef TONEFORM_H
 #define TONEFORM_H
 
+#include "configuration.h"
 #include "configurationpage.h"
 
 namespace Ui {
@@ -46,6 +47,11 @@ public:
 
 private:
     Ui::ToneForm *ui;
+
+    Configuration configuration;
+
+private slots:
+    void updatePreview();
 };
 
 #endif // TONEFORM_H
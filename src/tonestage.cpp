@@ -0,0 +1,168 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "tonestage.h"
+
+#include <cmath>
+
+#include "track.h"
+
+ToneStage::ToneStage(
+        const Configuration &configuration) :
+    configuration(configuration),
+    pitch(0),
+    rate(0),
+    state(0),
+    hasPrevious(false),
+    prevValue(0),
+    prevTime(0)
+{
+
+}
+
+void ToneStage::start(
+        Simulation &simulation,
+        const Track &track)
+{
+    const int size = track.size();
+
+    simulation.pitch.resize(size);
+    simulation.rate.resize(size);
+    simulation.state.resize(size);
+
+    pitch = simulation.pitch.data();
+    rate = simulation.rate.data();
+    state = simulation.state.data();
+
+    hasPrevious = false;
+}
+
+bool ToneStage::rateValue(
+        const SimulationSample &sample,
+        double value,
+        double &result)
+{
+    switch (configuration.rateMode)
+    {
+    case Configuration::ValueMagnitude:
+        result = fabs(value);
+        return true;
+    case Configuration::ValueChange:
+        // Percent * 100 per second
+        if (!hasPrevious || value == 0 || sample.time <= prevTime) return false;
+        result = fabs(value - prevValue) / fabs(value) * 10000 / (sample.time - prevTime);
+        return true;
+    default:
+        result = sample.value(configuration.rateMode);
+        return true;
+    }
+}
+
+void ToneStage::process(
+        SimulationSample &sample)
+{
+    const int i = sample.index;
+    const double value = sample.value(configuration.toneMode);
+
+    double value2;
+    const bool haveValue2 = rateValue(sample, value, value2);
+
+    hasPrevious = true;
+    prevValue = value;
+    prevTime = sample.time;
+
+    pitch[i] = 0;
+    rate[i] = 0;
+    state[i] = Simulation::Silent;
+
+    // No tone below thresholds or inside silence windows
+    if (sample.silenced) return;
+    if (sample.verticalSpeed < configuration.vThreshold) return;
+    if (sample.horizontalSpeed < configuration.hThreshold) return;
+
+    double fraction;
+    state[i] = tone(configuration, value, fraction);
+    if (state[i] != Simulation::Tone) return;
+
+    pitch[i] = fraction;
+
+    // Without a rate value the beep rate stays at its minimum
+    rate[i] = beepRate(configuration, haveValue2 ? value2 : configuration.minRateValue);
+}
+
+Simulation::ToneState ToneStage::tone(
+        const Configuration &configuration,
+        double value,
+        double &pitch)
+{
+    const double range = configuration.maxTone - configuration.minTone;
+    const double fraction = (range != 0)
+            ? (value - configuration.minTone) / range
+            : (value >= configuration.minTone ? 1 : 0);
+
+    pitch = 0;
+
+    if (fraction < 0 || fraction > 1)
+    {
+        switch (configuration.limits)
+        {
+        case Configuration::NoTone:
+            return Simulation::Silent;
+        case Configuration::Clamp:
+            break;
+        case Configuration::Chirp:
+            return (fraction > 1) ? Simulation::ChirpUp : Simulation::ChirpDown;
+        case Configuration::ChirpReverse:
+            return (fraction > 1) ? Simulation::ChirpDown : Simulation::ChirpUp;
+        }
+    }
+
+    pitch = qBound(0., fraction, 1.);
+    return Simulation::Tone;
+}
+
+double ToneStage::beepRate(
+        const Configuration &configuration,
+        double value)
+{
+    // Beep rate between Min_Rate and Max_Rate
+    const double minRate = configuration.minRate / 100.;
+    const double maxRate = configuration.maxRate / 100.;
+    const double rateRange = configuration.maxRateValue - configuration.minRateValue;
+    const double rateFraction = (rateRange != 0)
+            ? (value - configuration.minRateValue) / rateRange
+            : 0;
+
+    if (rateFraction <= 0)
+    {
+        return configuration.flatline ? 0 : minRate;
+    }
+    else if (rateFraction >= 1)
+    {
+        return maxRate;
+    }
+    else
+    {
+        return minRate + rateFraction * (maxRate - minRate);
+    }
+}
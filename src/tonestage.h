@@ -0,0 +1,59 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef TONESTAGE_H
+#define TONESTAGE_H
+
+#include "configuration.h"
+#include "simulator.h"
+
+class ToneStage : public SimulationStage
+{
+public:
+    explicit ToneStage(const Configuration &configuration);
+
+    void start(Simulation &simulation, const Track &track);
+    void process(SimulationSample &sample);
+
+    // Tone state and pitch (0 to 1) for a tone value, following Limits
+    static Simulation::ToneState tone(const Configuration &configuration,
+                                      double value, double &pitch);
+
+    // Beeps per second for a rate value, 0 for continuous
+    static double beepRate(const Configuration &configuration, double value);
+
+private:
+    Configuration configuration;
+
+    float *pitch;
+    float *rate;
+    quint8 *state;
+
+    bool hasPrevious;
+    double prevValue;
+    double prevTime;
+
+    bool rateValue(const SimulationSample &sample, double value, double &result);
+};
+
+#endif // TONESTAGE_H
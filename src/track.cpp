@@ -0,0 +1,206 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "track.h"
+
+#include <limits>
+
+template< typename T >
+static void updateColumnBlocks(
+        const TrackColumn< T > &column,
+        Track::Ranges &ranges)
+{
+    const int size = column.size();
+    const T *values = column.constData();
+
+    ranges.resize((size + TRACK_BLOCK_SIZE - 1) / TRACK_BLOCK_SIZE);
+
+    for (int b = 0; b < ranges.size(); ++b)
+    {
+        const int begin = b * TRACK_BLOCK_SIZE;
+        const int end = qMin(begin + TRACK_BLOCK_SIZE, size);
+
+        T minimum = values[begin];
+        T maximum = values[begin];
+        for (int i = begin + 1; i < end; ++i)
+        {
+            minimum = qMin(minimum, values[i]);
+            maximum = qMax(maximum, values[i]);
+        }
+
+        ranges[b].minimum = minimum;
+        ranges[b].maximum = maximum;
+    }
+}
+
+void Track::resize(
+        int size)
+{
+    time.resize(size);
+    lat.resize(size);
+    lon.resize(size);
+    hMSL.resize(size);
+    velN.resize(size);
+    velE.resize(size);
+    velD.resize(size);
+    hAcc.resize(size);
+    vAcc.resize(size);
+    sAcc.resize(size);
+    numSV.resize(size);
+
+    for (int i = 0; i < ColumnCount; ++i)
+    {
+        blocks[i].clear();
+    }
+}
+
+void Track::clear()
+{
+    fileName.clear();
+    hash.clear();
+
+    time.clear();
+    lat.clear();
+    lon.clear();
+    hMSL.clear();
+    velN.clear();
+    velE.clear();
+    velD.clear();
+    hAcc.clear();
+    vAcc.clear();
+    sAcc.clear();
+    numSV.clear();
+
+    for (int i = 0; i < ColumnCount; ++i)
+    {
+        blocks[i].clear();
+    }
+}
+
+Track Track::mid(
+        int begin,
+        int end) const
+{
+    // A slice is not the file's content, so it has no hash and is not
+    // stored in caches keyed by one
+    Track result;
+    result.fileName = fileName;
+
+    result.time = time.mid(begin, end);
+    result.lat = lat.mid(begin, end);
+    result.lon = lon.mid(begin, end);
+    result.hMSL = hMSL.mid(begin, end);
+    result.velN = velN.mid(begin, end);
+    result.velE = velE.mid(begin, end);
+    result.velD = velD.mid(begin, end);
+    result.hAcc = hAcc.mid(begin, end);
+    result.vAcc = vAcc.mid(begin, end);
+    result.sAcc = sAcc.mid(begin, end);
+    result.numSV = numSV.mid(begin, end);
+
+    return result;
+}
+
+double Track::value(
+        Column column,
+        int i) const
+{
+    switch (column)
+    {
+    case Time:  return time[i];
+    case Lat:   return lat[i];
+    case Lon:   return lon[i];
+    case HMSL:  return hMSL[i];
+    case VelN:  return velN[i];
+    case VelE:  return velE[i];
+    case VelD:  return velD[i];
+    case HAcc:  return hAcc[i];
+    case VAcc:  return vAcc[i];
+    case SAcc:  return sAcc[i];
+    case NumSV: return numSV[i];
+    default:    return 0;
+    }
+}
+
+void Track::updateBlocks()
+{
+    for (int i = 0; i < ColumnCount; ++i)
+    {
+        updateBlocks((Column) i);
+    }
+}
+
+void Track::updateBlocks(
+        Column column)
+{
+    switch (column)
+    {
+    case Time:  updateColumnBlocks(time, blocks[Time]); break;
+    case Lat:   updateColumnBlocks(lat, blocks[Lat]); break;
+    case Lon:   updateColumnBlocks(lon, blocks[Lon]); break;
+    case HMSL:  updateColumnBlocks(hMSL, blocks[HMSL]); break;
+    case VelN:  updateColumnBlocks(velN, blocks[VelN]); break;
+    case VelE:  updateColumnBlocks(velE, blocks[VelE]); break;
+    case VelD:  updateColumnBlocks(velD, blocks[VelD]); break;
+    case HAcc:  updateColumnBlocks(hAcc, blocks[HAcc]); break;
+    case VAcc:  updateColumnBlocks(vAcc, blocks[VAcc]); break;
+    case SAcc:  updateColumnBlocks(sAcc, blocks[SAcc]); break;
+    case NumSV: updateColumnBlocks(numSV, blocks[NumSV]); break;
+    default:    break;
+    }
+}
+
+Track::Range Track::range(
+        Column column,
+        int begin,
+        int end) const
+{
+    Range result;
+    result.minimum = std::numeric_limits< double >::infinity();
+    result.maximum = -std::numeric_limits< double >::infinity();
+
+    const Ranges &ranges = blocks[column];
+    const bool haveBlocks = (ranges.size() == (size() + TRACK_BLOCK_SIZE - 1) / TRACK_BLOCK_SIZE);
+
+    int i = begin;
+    while (i < end)
+    {
+        // Use block summaries for whole blocks inside the range
+        if (haveBlocks && i % TRACK_BLOCK_SIZE == 0 && i + TRACK_BLOCK_SIZE <= end)
+        {
+            const Range &block = ranges[i / TRACK_BLOCK_SIZE];
+            result.minimum = qMin(result.minimum, block.minimum);
+            result.maximum = qMax(result.maximum, block.maximum);
+            i += TRACK_BLOCK_SIZE;
+        }
+        else
+        {
+            const double v = value(column, i);
+            result.minimum = qMin(result.minimum, v);
+            result.maximum = qMax(result.maximum, v);
+            ++i;
+        }
+    }
+
+    return result;
+}
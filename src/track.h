@@ -0,0 +1,94 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef TRACK_H
+#define TRACK_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+#include "trackcolumn.h"
+
+#define TRACK_BLOCK_SIZE 4096
+
+class Track
+{
+public:
+    typedef enum {
+        Time = 0,
+        Lat,
+        Lon,
+        HMSL,
+        VelN,
+        VelE,
+        VelD,
+        HAcc,
+        VAcc,
+        SAcc,
+        NumSV,
+        ColumnCount
+    } Column;
+
+    typedef struct {
+        double minimum;
+        double maximum;
+    } Range;
+
+    typedef QVector< Range > Ranges;
+
+    QString fileName;
+    QByteArray hash;                // SHA-1 of the file
+
+    TrackColumn< double > time;     // Seconds since epoch (UTC)
+    TrackColumn< double > lat;      // Degrees
+    TrackColumn< double > lon;      // Degrees
+    TrackColumn< float >  hMSL;     // m
+    TrackColumn< float >  velN;     // m/s
+    TrackColumn< float >  velE;     // m/s
+    TrackColumn< float >  velD;     // m/s
+    TrackColumn< float >  hAcc;     // m
+    TrackColumn< float >  vAcc;     // m
+    TrackColumn< float >  sAcc;     // m/s
+    TrackColumn< float >  numSV;
+
+    // Minimum and maximum of each column over blocks of TRACK_BLOCK_SIZE
+    Ranges blocks[ColumnCount];
+
+    int size() const { return time.size(); }
+    bool isEmpty() const { return time.isEmpty(); }
+
+    void resize(int size);
+    void clear();
+
+    // Samples from begin up to end, without block summaries or hash
+    Track mid(int begin, int end) const;
+
+    double value(Column column, int i) const;
+
+    void updateBlocks();
+    void updateBlocks(Column column);
+    Range range(Column column, int begin, int end) const;
+};
+
+#endif // TRACK_H
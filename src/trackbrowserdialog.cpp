@@ -0,0 +1,144 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+#include "trackbrowserdialog.h"
+#include "ui_trackbrowserdialog.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QListWidgetItem>
+#include <QPixmap>
+#include <QScrollBar>
+
+#include "trackreader.h"
+
+// Size of track sparklines (pixels)
+#define TRACK_BROWSER_WIDTH  160
+#define TRACK_BROWSER_HEIGHT  48
+
+TrackBrowserDialog::TrackBrowserDialog(
+        const QString &folder,
+        QWidget *parent) :
+    QDialog(parent),
+    ui(new Ui::TrackBrowserDialog),
+    service(QSize(TRACK_BROWSER_WIDTH, TRACK_BROWSER_HEIGHT))
+{
+    ui->setupUi(this);
+
+    setWindowTitle(tr("Logbook - %1").arg(QDir::toNativeSeparators(folder)));
+
+    ui->list->setIconSize(service.size());
+
+    // Blank icon until the sparkline is ready, so items don't move
+    QPixmap blank(service.size());
+    blank.fill(Qt::transparent);
+
+    const QDir dir(folder);
+    const QStringList fileNames = TrackReader::findTracks(folder);
+    foreach (const QString &fileName, fileNames)
+    {
+        QListWidgetItem *item = new QListWidgetItem(
+                    QIcon(blank),
+                    QDir::toNativeSeparators(dir.relativeFilePath(fileName)),
+                    ui->list);
+        item->setData(Qt::UserRole, fileName);
+        item->setToolTip(QDir::toNativeSeparators(fileName));
+        items.insert(fileName, item);
+    }
+
+    ui->statusLabel->setText(tr("%1 tracks. Double-click a track to simulate it.")
+                             .arg(fileNames.size()));
+
+    connect(&service, SIGNAL(thumbnailReady(QString)),
+            this, SLOT(setThumbnail(QString)));
+    connect(ui->list->verticalScrollBar(), SIGNAL(valueChanged(int)),
+            this, SLOT(updateVisible()));
+}
+
+TrackBrowserDialog::~TrackBrowserDialog()
+{
+    delete ui;
+}
+
+void TrackBrowserDialog::showEvent(
+        QShowEvent *event)
+{
+    QDialog::showEvent(event);
+
+    updateVisible();
+
+    // Queue the rest so they are ready when scrolled to. Visible tracks
+    // are still rendered first.
+    for (int i = 0; i < ui->list->count(); ++i)
+    {
+        setThumbnail(ui->list->item(i)->data(Qt::UserRole).toString());
+    }
+}
+
+void TrackBrowserDialog::resizeEvent(
+        QResizeEvent *event)
+{
+    QDialog::resizeEvent(event);
+    updateVisible();
+}
+
+void TrackBrowserDialog::updateVisible()
+{
+    const QRect viewport = ui->list->viewport()->rect();
+
+    QStringList fileNames;
+    for (int i = 0; i < ui->list->count(); ++i)
+    {
+        QListWidgetItem *item = ui->list->item(i);
+        if (ui->list->visualItemRect(item).intersects(viewport))
+        {
+            fileNames.append(item->data(Qt::UserRole).toString());
+        }
+    }
+
+    service.setVisible(fileNames);
+
+    foreach (const QString &fileName, fileNames)
+    {
+        setThumbnail(fileName);
+    }
+}
+
+void TrackBrowserDialog::setThumbnail(
+        const QString &fileName)
+{
+    QListWidgetItem *item = items.value(fileName);
+    if (!item) return;
+
+    // Tracks which couldn't be read keep the blank icon
+    QImage image;
+    if (service.thumbnail(fileName, image) && !image.isNull())
+    {
+        item->setIcon(QIcon(QPixmap::fromImage(image)));
+    }
+}
+
+void TrackBrowserDialog::on_list_itemActivated(
+        QListWidgetItem *item)
+{
+    emit trackActivated(item->data(Qt::UserRole).toString());
+}
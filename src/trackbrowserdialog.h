@@ -0,0 +1,69 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+#ifndef TRACKBROWSERDIALOG_H
+#define TRACKBROWSERDIALOG_H
+
+#include <QDialog>
+#include <QHash>
+
+#include "thumbnailservice.h"
+
+class QListWidgetItem;
+
+namespace Ui {
+class TrackBrowserDialog;
+}
+
+// Lists the tracks in a logbook with a sparkline of each, rendered in
+// the background as the list is scrolled
+class TrackBrowserDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit TrackBrowserDialog(const QString &folder,
+                                QWidget *parent = 0);
+    ~TrackBrowserDialog();
+
+signals:
+    // Sent when a track is double-clicked
+    void trackActivated(const QString &fileName);
+
+protected:
+    void showEvent(QShowEvent *event);
+    void resizeEvent(QResizeEvent *event);
+
+private:
+    Ui::TrackBrowserDialog *ui;
+
+    ThumbnailService service;
+    QHash< QString, QListWidgetItem* > items;
+
+private slots:
+    void updateVisible();
+    void setThumbnail(const QString &fileName);
+
+    void on_list_itemActivated(QListWidgetItem *item);
+};
+
+#endif // TRACKBROWSERDIALOG_H
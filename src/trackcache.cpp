@@ -0,0 +1,521 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "trackcache.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QObject>
+#include <QSaveFile>
+#include <QSettings>
+#include <QSharedPointer>
+#include <QStandardPaths>
+
+#include <cstring>
+
+#include "jumpsegmenter.h"
+#include "track.h"
+#include "trackreader.h"
+
+#define CACHE_MAGIC        "FSTRACK"
+#define CACHE_VERSION      1
+#define CACHE_BYTE_ORDER   0x01020304
+#define CACHE_SUFFIX       ".fscache"
+#define CACHE_ALIGNMENT    64
+#define CACHE_DEFAULT_SIZE (1024LL * 1024 * 1024)
+
+#define SEGMENT_MAGIC      0x46535347
+#define SEGMENT_VERSION    1
+#define SEGMENT_SUFFIX     ".fsseg"
+
+#define HASH_CHUNK_SIZE    (1 << 26)
+
+typedef struct {
+    qint64  offset;
+    qint64  blockOffset;
+    quint32 elementSize;
+    quint32 reserved;
+} CacheColumn;
+
+typedef struct {
+    char    magic[8];
+    quint32 version;
+    quint32 byteOrder;
+    qint64  fileSize;
+    qint64  sourceSize;
+    qint64  sourceModified;
+    char    sourceHash[20];
+    qint32  columnCount;
+    qint32  rowCount;
+    qint32  blockSize;
+    qint32  blockCount;
+    CacheColumn columns[Track::ColumnCount];
+} CacheHeader;
+
+static inline qint64 align(
+        qint64 pos)
+{
+    return (pos + CACHE_ALIGNMENT - 1) & ~(qint64) (CACHE_ALIGNMENT - 1);
+}
+
+static bool writePadding(
+        QSaveFile &file,
+        qint64 pos)
+{
+    static const char zeros[CACHE_ALIGNMENT] = { 0 };
+    const qint64 padding = pos - file.pos();
+    return padding == 0 || file.write(zeros, padding) == padding;
+}
+
+template< typename T >
+static bool writeColumn(
+        QSaveFile &file,
+        const TrackColumn< T > &column,
+        const CacheColumn &entry)
+{
+    const qint64 bytes = column.size() * (qint64) sizeof(T);
+    return writePadding(file, entry.offset)
+            && file.write((const char *) column.constData(), bytes) == bytes;
+}
+
+template< typename T >
+static bool mapColumn(
+        const QSharedPointer< QFile > &file,
+        const uchar *data,
+        const CacheHeader &header,
+        const CacheColumn &entry,
+        TrackColumn< T > &column)
+{
+    if (entry.elementSize != sizeof(T)) return false;
+    if (entry.offset < (qint64) sizeof(header)) return false;
+    if (entry.offset % sizeof(T)) return false;
+    if (entry.offset + header.rowCount * (qint64) sizeof(T) > header.fileSize) return false;
+
+    column.setMapping(file, (const T *) (data + entry.offset), header.rowCount);
+    return true;
+}
+
+TrackCache::TrackCache()
+{
+    // Initialize settings object
+    QSettings settings("FlySight", "Configurator");
+
+    const QString defaultFolder = QDir(QStandardPaths::writableLocation(
+                                           QStandardPaths::CacheLocation)).filePath("tracks");
+
+    cacheFolder = settings.value("trackCache/folder", defaultFolder).toString();
+    maxSize = settings.value("trackCache/maximumSize", CACHE_DEFAULT_SIZE).toLongLong();
+}
+
+void TrackCache::setFolder(
+        const QString &folder)
+{
+    cacheFolder = folder;
+}
+
+void TrackCache::setMaximumSize(
+        qint64 bytes)
+{
+    maxSize = bytes;
+}
+
+QString TrackCache::cachePath(
+        const QString &fileName) const
+{
+    const QString absolutePath = QFileInfo(fileName).absoluteFilePath();
+
+    // Store beside the track
+    if (cacheFolder.isEmpty()) return absolutePath + CACHE_SUFFIX;
+
+    // Store in the cache folder under a name derived from the track path
+    const QByteArray key = QCryptographicHash::hash(
+                absolutePath.toUtf8(), QCryptographicHash::Sha1).toHex();
+    return QDir(cacheFolder).filePath(QString::fromLatin1(key) + CACHE_SUFFIX);
+}
+
+QString TrackCache::segmentPath(
+        const Track &track) const
+{
+    if (track.hash.isEmpty()) return QString();
+
+    // Store beside the track
+    if (cacheFolder.isEmpty()) return QFileInfo(track.fileName).absoluteFilePath() + SEGMENT_SUFFIX;
+
+    // Store in the cache folder under the content hash
+    return QDir(cacheFolder).filePath(QString::fromLatin1(track.hash.toHex()) + SEGMENT_SUFFIX);
+}
+
+bool TrackCache::load(
+        const QString &fileName,
+        Track &track)
+{
+    const QFileInfo source(fileName);
+    if (!source.isFile())
+    {
+        error = QObject::tr("File not found");
+        return false;
+    }
+
+    // Release any entry the track still maps, so it can be replaced
+    track.clear();
+
+    const QString path = cachePath(fileName);
+    if (readCache(path, source, track))
+    {
+        track.fileName = fileName;
+        return true;
+    }
+
+    TrackReader reader;
+    if (!reader.read(fileName, track))
+    {
+        error = reader.errorString();
+        return false;
+    }
+    track.hash = contentHash(fileName);
+
+    // The cache is only an optimization, so failures are not reported
+    if (writeCache(path, source, track))
+    {
+        trim();
+    }
+
+    return true;
+}
+
+void TrackCache::segment(
+        const Track &track,
+        JumpSegmenter &segmenter) const
+{
+    const QString path = segmentPath(track);
+    if (!path.isEmpty() && readSegments(path, track, segmenter)) return;
+
+    segmenter.segment(track);
+
+    if (!path.isEmpty()) writeSegments(path, track, segmenter);
+}
+
+QByteArray TrackCache::contentHash(
+        const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) return QByteArray();
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+
+    const qint64 size = file.size();
+    uchar *data = size ? file.map(0, size) : 0;
+    if (data)
+    {
+        for (qint64 pos = 0; pos < size; pos += HASH_CHUNK_SIZE)
+        {
+            hash.addData((const char *) data + pos, qMin< qint64 >(HASH_CHUNK_SIZE, size - pos));
+        }
+        file.unmap(data);
+    }
+    else
+    {
+        hash.addData(&file);
+    }
+
+    return hash.result();
+}
+
+bool TrackCache::readCache(
+        const QString &path,
+        const QFileInfo &source,
+        Track &track) const
+{
+    QSharedPointer< QFile > file(new QFile(path));
+    if (!file->open(QIODevice::ReadOnly)) return false;
+
+    const qint64 size = file->size();
+    if (size < (qint64) sizeof(CacheHeader)) return false;
+
+    const uchar *data = file->map(0, size);
+    if (!data) return false;
+
+    CacheHeader header;
+    memcpy(&header, data, sizeof(header));
+
+    // Check format
+    if (memcmp(header.magic, CACHE_MAGIC, sizeof(header.magic))) return false;
+    if (header.version != CACHE_VERSION) return false;
+    if (header.byteOrder != CACHE_BYTE_ORDER) return false;
+    if (header.fileSize != size) return false;
+    if (header.columnCount != Track::ColumnCount) return false;
+    if (header.blockSize != TRACK_BLOCK_SIZE) return false;
+    if (header.rowCount < 0) return false;
+    if (header.blockCount != (header.rowCount + TRACK_BLOCK_SIZE - 1) / TRACK_BLOCK_SIZE) return false;
+
+    // Invalidate when the source has changed. Size and modification time
+    // reject most edits cheaply; the content hash catches the rest.
+    if (header.sourceSize != source.size()) return false;
+    if (header.sourceModified != source.lastModified().toMSecsSinceEpoch()) return false;
+
+    const QByteArray hash = contentHash(source.absoluteFilePath());
+    if (hash.size() != (int) sizeof(header.sourceHash)
+            || memcmp(header.sourceHash, hash.constData(), sizeof(header.sourceHash)))
+    {
+        return false;
+    }
+
+    track.clear();
+
+    bool ok = true;
+
+#define MAP_COLUMN(c,w)\
+ok = ok && mapColumn(file, data, header, header.columns[c], w);
+
+    MAP_COLUMN(Track::Time, track.time);
+    MAP_COLUMN(Track::Lat, track.lat);
+    MAP_COLUMN(Track::Lon, track.lon);
+    MAP_COLUMN(Track::HMSL, track.hMSL);
+    MAP_COLUMN(Track::VelN, track.velN);
+    MAP_COLUMN(Track::VelE, track.velE);
+    MAP_COLUMN(Track::VelD, track.velD);
+    MAP_COLUMN(Track::HAcc, track.hAcc);
+    MAP_COLUMN(Track::VAcc, track.vAcc);
+    MAP_COLUMN(Track::SAcc, track.sAcc);
+    MAP_COLUMN(Track::NumSV, track.numSV);
+
+#undef MAP_COLUMN
+
+    // Block summaries are small, so they are copied
+    for (int c = 0; ok && c < Track::ColumnCount; ++c)
+    {
+        const qint64 offset = header.columns[c].blockOffset;
+        const qint64 bytes = header.blockCount * (qint64) sizeof(Track::Range);
+        if (offset < (qint64) sizeof(header) || offset + bytes > size)
+        {
+            ok = false;
+            break;
+        }
+
+        track.blocks[c].resize(header.blockCount);
+        memcpy(track.blocks[c].data(), data + offset, bytes);
+    }
+
+    if (!ok)
+    {
+        // Drop the columns' references and unmap before the entry is
+        // rewritten, since a mapped file can't be replaced on Windows
+        track.clear();
+        file->unmap((uchar *) data);
+        return false;
+    }
+
+    track.hash = QByteArray(header.sourceHash, sizeof(header.sourceHash));
+
+    // Mark as recently used
+    if (!cacheFolder.isEmpty())
+    {
+        QFile touch(path);
+        if (touch.open(QIODevice::ReadWrite))
+        {
+            touch.setFileTime(QDateTime::currentDateTimeUtc(), QFileDevice::FileModificationTime);
+        }
+    }
+
+    return true;
+}
+
+bool TrackCache::writeCache(
+        const QString &path,
+        const QFileInfo &source,
+        const Track &track) const
+{
+    if (!QDir().mkpath(QFileInfo(path).absolutePath())) return false;
+
+    CacheHeader header;
+    memset(&header, 0, sizeof(header));
+
+    memcpy(header.magic, CACHE_MAGIC, sizeof(header.magic));
+    header.version = CACHE_VERSION;
+    header.byteOrder = CACHE_BYTE_ORDER;
+    header.sourceSize = source.size();
+    header.sourceModified = source.lastModified().toMSecsSinceEpoch();
+    memcpy(header.sourceHash, track.hash.constData(),
+           qMin< int >(track.hash.size(), sizeof(header.sourceHash)));
+    header.columnCount = Track::ColumnCount;
+    header.rowCount = track.size();
+    header.blockSize = TRACK_BLOCK_SIZE;
+    header.blockCount = (track.size() + TRACK_BLOCK_SIZE - 1) / TRACK_BLOCK_SIZE;
+
+    for (int c = 0; c < Track::ColumnCount; ++c)
+    {
+        if (track.blocks[c].size() != header.blockCount) return false;
+    }
+
+    // Lay out aligned column blocks followed by block summaries
+    qint64 pos = sizeof(header);
+    for (int c = 0; c < Track::ColumnCount; ++c)
+    {
+        const int elementSize = (c == Track::Time || c == Track::Lat || c == Track::Lon)
+                ? sizeof(double) : sizeof(float);
+
+        pos = align(pos);
+        header.columns[c].offset = pos;
+        header.columns[c].elementSize = elementSize;
+        pos += header.rowCount * (qint64) elementSize;
+    }
+    for (int c = 0; c < Track::ColumnCount; ++c)
+    {
+        pos = align(pos);
+        header.columns[c].blockOffset = pos;
+        pos += header.blockCount * (qint64) sizeof(Track::Range);
+    }
+    header.fileSize = pos;
+
+    // Write to a temporary file which replaces the cache on commit
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+
+    bool ok = file.write((const char *) &header, sizeof(header)) == sizeof(header);
+
+#define WRITE_COLUMN(c,w)\
+ok = ok && writeColumn(file, w, header.columns[c]);
+
+    WRITE_COLUMN(Track::Time, track.time);
+    WRITE_COLUMN(Track::Lat, track.lat);
+    WRITE_COLUMN(Track::Lon, track.lon);
+    WRITE_COLUMN(Track::HMSL, track.hMSL);
+    WRITE_COLUMN(Track::VelN, track.velN);
+    WRITE_COLUMN(Track::VelE, track.velE);
+    WRITE_COLUMN(Track::VelD, track.velD);
+    WRITE_COLUMN(Track::HAcc, track.hAcc);
+    WRITE_COLUMN(Track::VAcc, track.vAcc);
+    WRITE_COLUMN(Track::SAcc, track.sAcc);
+    WRITE_COLUMN(Track::NumSV, track.numSV);
+
+#undef WRITE_COLUMN
+
+    for (int c = 0; ok && c < Track::ColumnCount; ++c)
+    {
+        const qint64 bytes = header.blockCount * (qint64) sizeof(Track::Range);
+        ok = writePadding(file, header.columns[c].blockOffset)
+                && file.write((const char *) track.blocks[c].constData(), bytes) == bytes;
+    }
+
+    if (!ok)
+    {
+        file.cancelWriting();
+        return false;
+    }
+
+    return file.commit();
+}
+
+bool TrackCache::readSegments(
+        const QString &path,
+        const Track &track,
+        JumpSegmenter &segmenter) const
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_6);
+
+    quint32 magic, version, segmenterVersion;
+    qint32 rowCount, count;
+    in >> magic >> version >> segmenterVersion >> rowCount >> count;
+
+    // Segments go stale when the segmenter changes
+    if (magic != SEGMENT_MAGIC || version != SEGMENT_VERSION
+            || segmenterVersion != JUMP_SEGMENTER_VERSION
+            || rowCount != track.size() || count < 0 || count > rowCount)
+    {
+        return false;
+    }
+
+    JumpSegmenter::Segments segments(count);
+    for (int i = 0; i < count; ++i)
+    {
+        qint32 phase, begin, end;
+        in >> phase >> begin >> end;
+
+        // Segments are in order and within the track
+        if (phase < JumpSegmenter::Ground || phase > JumpSegmenter::Canopy) return false;
+        if (begin < (i ? segments[i - 1].end : 0) || end <= begin || end > rowCount) return false;
+
+        segments[i].phase = (JumpSegmenter::Phase) phase;
+        segments[i].begin = begin;
+        segments[i].end = end;
+    }
+
+    if (in.status() != QDataStream::Ok) return false;
+
+    segmenter.setSegments(segments);
+    return true;
+}
+
+void TrackCache::writeSegments(
+        const QString &path,
+        const Track &track,
+        const JumpSegmenter &segmenter) const
+{
+    // The cache is only an optimization, so failures are not reported
+    if (!QDir().mkpath(QFileInfo(path).absolutePath())) return;
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return;
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_6);
+    out << (quint32) SEGMENT_MAGIC << (quint32) SEGMENT_VERSION
+        << (quint32) JUMP_SEGMENTER_VERSION
+        << (qint32) track.size() << (qint32) segmenter.segments().size();
+
+    foreach (const JumpSegmenter::Segment &segment, segmenter.segments())
+    {
+        out << (qint32) segment.phase << (qint32) segment.begin << (qint32) segment.end;
+    }
+
+    file.commit();
+}
+
+void TrackCache::trim() const
+{
+    if (cacheFolder.isEmpty() || maxSize <= 0) return;
+
+    // Remove least recently used entries until the cache fits
+    const QFileInfoList entries = QDir(cacheFolder).entryInfoList(
+                QStringList() << QString("*") + CACHE_SUFFIX
+                              << QString("*") + SEGMENT_SUFFIX,
+                QDir::Files, QDir::Time);
+
+    qint64 total = 0;
+    foreach (const QFileInfo &entry, entries)
+    {
+        total += entry.size();
+        if (total > maxSize)
+        {
+            QFile::remove(entry.absoluteFilePath());
+        }
+    }
+}
@@ -0,0 +1,77 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef TRACKCACHE_H
+#define TRACKCACHE_H
+
+#include <QByteArray>
+#include <QString>
+
+class JumpSegmenter;
+class QFileInfo;
+class Track;
+
+// Parsed tracks in columnar files which are mapped rather than read.
+// An entry is used while its source has the same size, modification time
+// and content hash.
+//
+// Jump segments are kept in a small sidecar. In the cache folder it is
+// named by the content hash, so tracks with the same content share it.
+class TrackCache
+{
+public:
+    TrackCache();
+
+    // Empty folder stores the cache beside each track
+    QString folder() const { return cacheFolder; }
+    void setFolder(const QString &folder);
+
+    // Zero means no limit
+    qint64 maximumSize() const { return maxSize; }
+    void setMaximumSize(qint64 bytes);
+
+    bool load(const QString &fileName, Track &track);
+
+    // Segments a loaded track, reusing stored segments when the
+    // segmenter has not changed since they were found
+    void segment(const Track &track, JumpSegmenter &segmenter) const;
+
+    QString cachePath(const QString &fileName) const;
+    QString segmentPath(const Track &track) const;
+    QString errorString() const { return error; }
+
+    static QByteArray contentHash(const QString &fileName);
+
+private:
+    QString cacheFolder;
+    qint64  maxSize;
+    QString error;
+
+    bool readCache(const QString &path, const QFileInfo &source, Track &track) const;
+    bool writeCache(const QString &path, const QFileInfo &source, const Track &track) const;
+    bool readSegments(const QString &path, const Track &track, JumpSegmenter &segmenter) const;
+    void writeSegments(const QString &path, const Track &track, const JumpSegmenter &segmenter) const;
+    void trim() const;
+};
+
+#endif // TRACKCACHE_H
@@ -0,0 +1,134 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef TRACKCOLUMN_H
+#define TRACKCOLUMN_H
+
+#include <QFile>
+#include <QSharedPointer>
+#include <QVector>
+
+#include <cstring>
+
+// Column of track samples, either owned or viewing a memory mapped
+// file. Mapped columns are copied on the first write.
+template< typename T >
+class TrackColumn
+{
+public:
+    TrackColumn() :
+        mapped(0),
+        mappedSize(0)
+    {
+
+    }
+
+    // Shares the vector's storage
+    explicit TrackColumn(const QVector< T > &values) :
+        storage(values),
+        mapped(0),
+        mappedSize(0)
+    {
+
+    }
+
+    int size() const { return mapped ? mappedSize : storage.size(); }
+    bool isEmpty() const { return size() == 0; }
+    bool isMapped() const { return mapped != 0; }
+
+    const T *constData() const { return mapped ? mapped : storage.constData(); }
+    const T *data() const { return constData(); }
+    const T &at(int i) const { return constData()[i]; }
+    const T &operator[](int i) const { return constData()[i]; }
+
+    T *data()
+    {
+        detach();
+        return storage.data();
+    }
+
+    void resize(int size)
+    {
+        detach();
+        storage.resize(size);
+    }
+
+    void append(const T &value)
+    {
+        detach();
+        storage.append(value);
+    }
+
+    void clear()
+    {
+        storage.clear();
+        owner.clear();
+        mapped = 0;
+        mappedSize = 0;
+    }
+
+    // Samples from begin up to end. Mapped columns keep viewing the
+    // same file rather than being copied.
+    TrackColumn mid(int begin, int end) const
+    {
+        TrackColumn result;
+        if (mapped)
+        {
+            result.setMapping(owner, mapped + begin, end - begin);
+        }
+        else
+        {
+            result.storage = storage.mid(begin, end - begin);
+        }
+        return result;
+    }
+
+    void setMapping(const QSharedPointer< QFile > &file,
+                    const T *values, int size)
+    {
+        storage.clear();
+        owner = file;
+        mapped = values;
+        mappedSize = size;
+    }
+
+private:
+    QVector< T > storage;
+    QSharedPointer< QFile > owner;
+    const T *mapped;
+    int mappedSize;
+
+    void detach()
+    {
+        if (!mapped) return;
+
+        storage.resize(mappedSize);
+        memcpy(storage.data(), mapped, mappedSize * sizeof(T));
+
+        owner.clear();
+        mapped = 0;
+        mappedSize = 0;
+    }
+};
+
+#endif // TRACKCOLUMN_H
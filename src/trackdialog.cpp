@@ -0,0 +1,320 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "trackdialog.h"
+#include "ui_trackdialog.h"
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QTreeWidgetItem>
+
+#include <algorithm>
+#include <cmath>
+
+#include "jumpsegmenter.h"
+#include "track.h"
+#include "trackcache.h"
+
+TrackDialog::TrackDialog(
+        const Configuration &configuration,
+        const QString &fileName,
+        QWidget *parent) :
+    QDialog(parent),
+    ui(new Ui::TrackDialog),
+    configuration(configuration),
+    toneSeries(-1),
+    rateSeries(-1)
+{
+    ui->setupUi(this);
+
+    // Statistics follow the selection, or the visible range without one
+    connect(ui->plot, SIGNAL(selectionChanged(double,double)),
+            this, SLOT(updateStatistics()));
+    connect(ui->plot, SIGNAL(timeRangeChanged(double,double)),
+            this, SLOT(updateStatistics()));
+
+    setWindowTitle(tr("Track - %1").arg(QFileInfo(fileName).fileName()));
+
+    Track track;
+    TrackCache cache;
+    if (!cache.load(fileName, track))
+    {
+        ui->statusLabel->setText(cache.errorString());
+        return;
+    }
+
+    // Velocity smoothing windows in seconds
+    ui->smoothingComboBox->addItem(tr("None"), 0.0);
+    ui->smoothingComboBox->addItem(tr("1 s"), 1.0);
+    ui->smoothingComboBox->addItem(tr("2 s"), 2.0);
+    ui->smoothingComboBox->addItem(tr("4 s"), 4.0);
+
+    source = track;
+
+    // Jumps are found once, on the logged samples, and only the freefall
+    // of the chosen jump is simulated and plotted
+    JumpSegmenter segmenter;
+    cache.segment(track, segmenter);
+
+    ui->jumpComboBox->addItem(tr("Whole track"));
+    foreach (const JumpSegmenter::Jump &jump, segmenter.jumps())
+    {
+        jumpRanges.append(qMakePair(jump.exit, JumpSegmenter::freefallEnd(jump, track)));
+        ui->jumpComboBox->addItem(tr("Jump %1 freefall").arg(jumpRanges.size()));
+    }
+
+    // Start with the first jump
+    const int index = jumpRanges.isEmpty() ? 0 : 1;
+    ui->jumpComboBox->setCurrentIndex(index);
+    on_jumpComboBox_activated(index);
+
+    ui->statusLabel->setText(tr("%1 samples from %2. Drag to pan, Shift-drag to select, scroll to zoom, double-click to reset.")
+                             .arg(graph.track().size())
+                             .arg(QDir::toNativeSeparators(fileName)));
+}
+
+TrackDialog::~TrackDialog()
+{
+    delete ui;
+}
+
+void TrackDialog::setConfiguration(
+        const Configuration &newConfiguration)
+{
+    const bool unitsChanged = newConfiguration.displayUnits != configuration.displayUnits;
+    configuration = newConfiguration;
+
+    simulate(unitsChanged);
+}
+
+void TrackDialog::on_smoothingComboBox_activated(
+        int index)
+{
+    graph.setSmoothing(ui->smoothingComboBox->itemData(index).toDouble());
+    simulate(false);
+}
+
+void TrackDialog::simulate(
+        bool unitsChanged)
+{
+    if (graph.track().isEmpty()) return;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // Only series downstream of a recomputed node are replotted
+    const int recomputed = graph.update(configuration);
+
+    // Keep the visible range when samples are re-timed
+    if (recomputed & (1 << SimulationGraph::ResampleNode))
+    {
+        const double start = ui->plot->startTime();
+        const double end = ui->plot->endTime();
+
+        ui->plot->setTime(graph.track().time);
+        ui->plot->setTimeRange(start, end);
+    }
+
+    if (unitsChanged || (recomputed & (1 << SimulationGraph::MetricsNode)))
+    {
+        plotMetrics();
+    }
+    else if (recomputed & (1 << SimulationGraph::ToneNode))
+    {
+        plotTone();
+    }
+    else
+    {
+        return;
+    }
+
+    ui->statusLabel->setText(tr("Updated in %1 ms.")
+                             .arg(timer.nsecsElapsed() / 1e6, 0, 'f', 1));
+}
+
+void TrackDialog::plotMetrics()
+{
+    const Track &track = graph.track();
+    const Simulation &simulation = graph.simulation();
+
+    // Convert to display units once, before the plot builds its pyramids
+    const int size = track.size();
+    const double distanceScale = configuration.valueToDistanceUnits(1);
+    const double speedScale = configuration.valueToSpeedUnits(1) * 100;
+
+    QVector< float > altitude(size);
+    QVector< float > horizontalSpeed(size);
+    QVector< float > verticalSpeed(size);
+    QVector< float > glideRatio(size);
+
+    for (int i = 0; i < size; ++i)
+    {
+        const float velN = track.velN[i];
+        const float velE = track.velE[i];
+
+        altitude[i] = (track.hMSL[i] - configuration.groundElevation) * distanceScale;
+        horizontalSpeed[i] = sqrt(velN * velN + velE * velE) * speedScale;
+        verticalSpeed[i] = track.velD[i] * speedScale;
+        glideRatio[i] = (verticalSpeed[i] != 0) ? horizontalSpeed[i] / verticalSpeed[i] : 0;
+    }
+
+    // Time above the speeds where the tone is muted, and above 1:1 glide
+    statistics[HorizontalSpeedRow].build(
+                track.time, TrackColumn< float >(horizontalSpeed),
+                configuration.valueToSpeedUnits(configuration.hThreshold));
+    statistics[VerticalSpeedRow].build(
+                track.time, TrackColumn< float >(verticalSpeed),
+                configuration.valueToSpeedUnits(configuration.vThreshold));
+    statistics[GlideRatioRow].build(
+                track.time, TrackColumn< float >(glideRatio), 1);
+
+    const QString speedUnits = configuration.speedUnits();
+
+    ui->plot->clearSeries();
+    ui->plot->addSeries(tr("Altitude (%1)").arg(configuration.distanceUnits()),
+                        TrackColumn< float >(altitude), Qt::darkGreen, 0);
+    ui->plot->addSeries(tr("Horizontal speed (%1)").arg(speedUnits),
+                        TrackColumn< float >(horizontalSpeed), Qt::red, 1);
+    ui->plot->addSeries(tr("Vertical speed (%1)").arg(speedUnits),
+                        TrackColumn< float >(verticalSpeed), Qt::blue, 1);
+
+    // Skydiver's airspeed beside the ground speeds
+    if (!simulation.airspeedFactor.isEmpty())
+    {
+        QVector< float > horizontalAirspeed(size);
+        QVector< float > verticalAirspeed(size);
+
+        for (int i = 0; i < size; ++i)
+        {
+            horizontalAirspeed[i] = horizontalSpeed[i] * simulation.airspeedFactor[i];
+            verticalAirspeed[i] = verticalSpeed[i] * simulation.airspeedFactor[i];
+        }
+
+        ui->plot->addSeries(tr("Horizontal SAS (%1)").arg(speedUnits),
+                            TrackColumn< float >(horizontalAirspeed), Qt::darkRed, 1);
+        ui->plot->addSeries(tr("Vertical SAS (%1)").arg(speedUnits),
+                            TrackColumn< float >(verticalAirspeed), Qt::darkBlue, 1);
+    }
+
+    toneSeries = -1;
+    rateSeries = -1;
+    plotTone();
+}
+
+void TrackDialog::plotTone()
+{
+    const Simulation &simulation = graph.simulation();
+
+    QVector< float > pitch(simulation.pitch.size());
+    for (int i = 0; i < pitch.size(); ++i)
+    {
+        pitch[i] = simulation.pitch[i] * 100;
+    }
+
+    if (toneSeries < 0)
+    {
+        toneSeries = ui->plot->addSeries(tr("Tone (%)"),
+                                         TrackColumn< float >(pitch), Qt::darkMagenta, 2);
+        rateSeries = ui->plot->addSeries(tr("Rate (Hz)"),
+                                         TrackColumn< float >(simulation.rate), Qt::darkCyan, 3);
+    }
+    else
+    {
+        ui->plot->setSeriesValues(toneSeries, TrackColumn< float >(pitch));
+        ui->plot->setSeriesValues(rateSeries, TrackColumn< float >(simulation.rate));
+    }
+
+    // Thresholds are tone settings, which may change without new metrics
+    statistics[HorizontalSpeedRow].setThreshold(
+                configuration.valueToSpeedUnits(configuration.hThreshold));
+    statistics[VerticalSpeedRow].setThreshold(
+                configuration.valueToSpeedUnits(configuration.vThreshold));
+
+    // Time above the lowest pitch, and above the slowest beep rate
+    const Track &track = graph.track();
+    statistics[ToneRow].build(track.time, TrackColumn< float >(pitch), 0);
+    statistics[RateRow].build(track.time, TrackColumn< float >(simulation.rate),
+                              configuration.minRate / 100.);
+
+    updateStatistics();
+}
+
+void TrackDialog::updateStatistics()
+{
+    const Track &track = graph.track();
+    if (track.isEmpty()) return;
+
+    const double start = ui->plot->hasSelection()
+            ? ui->plot->selectionStartTime() : ui->plot->startTime();
+    const double end = ui->plot->hasSelection()
+            ? ui->plot->selectionEndTime() : ui->plot->endTime();
+
+    const double *time = track.time.constData();
+    const int begin = std::lower_bound(time, time + track.size(), start) - time;
+    const int stop = std::upper_bound(time, time + track.size(), end) - time;
+
+    const QString speedUnits = configuration.speedUnits();
+    const QString names[RowCount] = {
+        tr("Horizontal speed (%1)").arg(speedUnits),
+        tr("Vertical speed (%1)").arg(speedUnits),
+        tr("Glide ratio"),
+        tr("Tone (%)"),
+        tr("Rate (Hz)")
+    };
+
+    ui->statisticsTree->clear();
+    for (int row = 0; row < RowCount; ++row)
+    {
+        const RangeStatistics::Statistics s = statistics[row].range(begin, stop);
+
+        QTreeWidgetItem *item = new QTreeWidgetItem(ui->statisticsTree);
+        item->setText(0, names[row]);
+        item->setText(1, QString::number(s.minimum, 'f', 1));
+        item->setText(2, QString::number(s.maximum, 'f', 1));
+        item->setText(3, QString::number(s.mean, 'f', 1));
+        item->setText(4, tr("%1 of %2 s above %3")
+                      .arg(s.timeAbove, 0, 'f', 1)
+                      .arg(s.duration, 0, 'f', 1)
+                      .arg(statistics[row].threshold(), 0, 'f', 1));
+    }
+}
+
+void TrackDialog::on_jumpComboBox_activated(
+        int index)
+{
+    if (index == 0)
+    {
+        graph.setTrack(source);
+    }
+    else
+    {
+        const QPair< int, int > &range = jumpRanges[index - 1];
+        graph.setTrack(source.mid(range.first, range.second));
+    }
+
+    graph.update(configuration);
+
+    ui->plot->setTime(graph.track().time);
+    plotMetrics();
+}
@@ -0,0 +1,88 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef TRACKDIALOG_H
+#define TRACKDIALOG_H
+
+#include <QDialog>
+#include <QPair>
+#include <QVector>
+
+#include "configuration.h"
+#include "rangestatistics.h"
+#include "simulationgraph.h"
+
+namespace Ui {
+class TrackDialog;
+}
+
+class TrackDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit TrackDialog(const Configuration &configuration,
+                         const QString &fileName,
+                         QWidget *parent = 0);
+    ~TrackDialog();
+
+public slots:
+    void setConfiguration(const Configuration &configuration);
+
+private slots:
+    void on_jumpComboBox_activated(int index);
+    void on_smoothingComboBox_activated(int index);
+    void updateStatistics();
+
+private:
+    typedef enum {
+        HorizontalSpeedRow = 0,
+        VerticalSpeedRow,
+        GlideRatioRow,
+        ToneRow,
+        RateRow,
+        RowCount
+    } Row;
+
+    Ui::TrackDialog *ui;
+
+    Configuration configuration;
+    Track source;
+    SimulationGraph graph;
+
+    // Plot series showing simulator output, or -1 before they are added
+    int toneSeries;
+    int rateSeries;
+
+    // Built once per simulation, then queried for the selected range
+    RangeStatistics statistics[RowCount];
+
+    // Exit and deployment samples of each jump
+    QVector< QPair< int, int > > jumpRanges;
+
+    void simulate(bool unitsChanged);
+    void plotMetrics();
+    void plotTone();
+};
+
+#endif // TRACKDIALOG_H
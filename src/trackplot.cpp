@@ -0,0 +1,453 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "trackplot.h"
+
+#include <QMouseEvent>
+#include <QPainter>
+#include <QPolygonF>
+#include <QtAlgorithms>
+#include <QtMath>
+#include <QWheelEvent>
+
+#include <algorithm>
+
+// Space reserved below the lanes for time labels
+#define TIME_AXIS_HEIGHT 20
+
+// Fewest seconds shown when zoomed in
+#define MIN_TIME_SPAN 1.0
+
+TrackPlot::TrackPlot(
+        QWidget *parent) :
+    QWidget(parent),
+    lanes(0),
+    start(0),
+    end(0),
+    dragging(false),
+    dragX(0),
+    selecting(false),
+    selectionAnchor(0),
+    selectionStart(0),
+    selectionEnd(0)
+{
+    setMinimumSize(320, 240);
+    setFocusPolicy(Qt::WheelFocus);
+}
+
+TrackPlot::~TrackPlot()
+{
+    qDeleteAll(series);
+}
+
+void TrackPlot::setTime(
+        const TrackColumn< double > &newTime)
+{
+    time = newTime;
+    resetZoom();
+}
+
+int TrackPlot::addSeries(
+        const QString &name,
+        const TrackColumn< float > &values,
+        const QColor &color,
+        int lane)
+{
+    Series *s = new Series;
+    s->name = name;
+    s->color = color;
+    s->lane = lane;
+
+    series.append(s);
+    lanes = qMax(lanes, lane + 1);
+
+    setSeriesValues(series.size() - 1, values);
+
+    return series.size() - 1;
+}
+
+void TrackPlot::setSeriesValues(
+        int index,
+        const TrackColumn< float > &values)
+{
+    Series *s = series[index];
+
+    s->values = values;
+    s->pyramid.build(s->values.constData(), s->values.size());
+    s->pyramid.range(0, s->values.size(), s->minimum, s->maximum);
+
+    update();
+}
+
+void TrackPlot::clearSeries()
+{
+    qDeleteAll(series);
+    series.clear();
+    lanes = 0;
+
+    update();
+}
+
+void TrackPlot::clear()
+{
+    clearSeries();
+    time.clear();
+
+    clearSelection();
+    resetZoom();
+}
+
+void TrackPlot::setTimeRange(
+        double newStart,
+        double newEnd)
+{
+    if (time.isEmpty()) return;
+
+    const double first = time[0];
+    const double last = time[time.size() - 1];
+
+    // Keep the span within the track, and no shorter than the minimum
+    double span = qMin(newEnd - newStart, last - first);
+    span = qMax(span, qMin(MIN_TIME_SPAN, last - first));
+
+    newStart = qBound(first, newStart, last - span);
+
+    if (newStart == start && newStart + span == end) return;
+
+    start = newStart;
+    end = newStart + span;
+
+    emit timeRangeChanged(start, end);
+    update();
+}
+
+void TrackPlot::resetZoom()
+{
+    if (time.isEmpty())
+    {
+        start = end = 0;
+        update();
+        return;
+    }
+
+    setTimeRange(time[0], time[time.size() - 1]);
+}
+
+void TrackPlot::clearSelection()
+{
+    select(0, 0);
+}
+
+void TrackPlot::select(
+        double from,
+        double to)
+{
+    if (to < from) qSwap(from, to);
+    if (from == selectionStart && to == selectionEnd) return;
+
+    selectionStart = from;
+    selectionEnd = to;
+
+    emit selectionChanged(selectionStart, selectionEnd);
+    update();
+}
+
+QRect TrackPlot::plotRect() const
+{
+    return rect().adjusted(0, 0, -1, -TIME_AXIS_HEIGHT);
+}
+
+double TrackPlot::timeAt(
+        int x) const
+{
+    const QRect plot = plotRect();
+    const double fraction = qBound(0., (double) (x - plot.left()) / qMax(plot.width(), 1), 1.);
+    return start + fraction * (end - start);
+}
+
+QRectF TrackPlot::laneRect(
+        int lane) const
+{
+    const QRect plot = plotRect();
+    const double height = (double) plot.height() / qMax(lanes, 1);
+
+    return QRectF(plot.left(), plot.top() + lane * height,
+                  plot.width(), height);
+}
+
+void TrackPlot::paintEvent(
+        QPaintEvent *event)
+{
+    Q_UNUSED(event);
+
+    QPainter painter(this);
+    painter.fillRect(rect(), palette().base());
+
+    if (time.isEmpty() || end <= start) return;
+
+    const QRect plot = plotRect();
+
+    if (hasSelection())
+    {
+        const double scale = plot.width() / (end - start);
+        const double left = plot.left() + (selectionStart - start) * scale;
+        const double right = plot.left() + (selectionEnd - start) * scale;
+
+        QColor color = palette().highlight().color();
+        color.setAlpha(48);
+        painter.fillRect(QRectF(left, plot.top(), right - left, plot.height())
+                         .intersected(plot), color);
+    }
+
+    drawGrid(painter, plot);
+
+    // Lane separators
+    painter.setPen(palette().mid().color());
+    for (int lane = 1; lane < lanes; ++lane)
+    {
+        const double y = laneRect(lane).top();
+        painter.drawLine(QPointF(plot.left(), y), QPointF(plot.right(), y));
+    }
+
+    // Series share the time axis, so visible samples are found once
+    int first, last;
+    QVector< int > stops;
+    visibleSamples(plot.width(), first, last, stops);
+
+    // Series, with a legend in the corner of each lane
+    QVector< int > legendX(lanes, plot.left() + 4);
+    QPolygonF points;
+
+    painter.setClipRect(plot);
+    foreach (const Series *s, series)
+    {
+        const QRectF lane = laneRect(s->lane).adjusted(0, 4, 0, -4);
+
+        points.clear();
+        appendPoints(*s, lane, first, last, stops, points);
+
+        painter.setPen(s->color);
+        painter.drawPolyline(points);
+
+        // An empty series has no range to show
+        const QString label = s->values.isEmpty() ? s->name
+                : QString("%1 [%2, %3]")
+                  .arg(s->name)
+                  .arg(s->minimum, 0, 'f', 1)
+                  .arg(s->maximum, 0, 'f', 1);
+        painter.drawText(QPointF(legendX[s->lane], lane.top() + fontMetrics().ascent()),
+                         label);
+#if QT_VERSION >= QT_VERSION_CHECK(5, 11, 0)
+        legendX[s->lane] += fontMetrics().horizontalAdvance(label) + 12;
+#else
+        legendX[s->lane] += fontMetrics().width(label) + 12;
+#endif
+    }
+}
+
+void TrackPlot::drawGrid(
+        QPainter &painter,
+        const QRect &rect) const
+{
+    // Pick a step of 1, 2 or 5 times a power of ten, about 100 px apart
+    const double span = end - start;
+    const double target = span * 100 / qMax(rect.width(), 1);
+    const double power = qPow(10, qFloor(log10(target)));
+
+    double step = power;
+    if (target > 5 * power) step = 10 * power;
+    else if (target > 2 * power) step = 5 * power;
+    else if (target > power) step = 2 * power;
+
+    const double first = time[0];
+    const double scale = rect.width() / span;
+
+    for (double t = qCeil((start - first) / step) * step; first + t <= end; t += step)
+    {
+        const double x = rect.left() + (first + t - start) * scale;
+
+        painter.setPen(palette().midlight().color());
+        painter.drawLine(QPointF(x, rect.top()), QPointF(x, rect.bottom()));
+
+        painter.setPen(palette().text().color());
+        painter.drawText(QRectF(x - 50, rect.bottom(), 100, TIME_AXIS_HEIGHT),
+                         Qt::AlignCenter, tr("%1 s").arg(t));
+    }
+}
+
+void TrackPlot::visibleSamples(
+        double width,
+        int &first,
+        int &last,
+        QVector< int > &stops) const
+{
+    const int size = time.size();
+    const double *t = time.constData();
+
+    // Visible samples, plus one on either side so lines reach the edges
+    first = std::lower_bound(t, t + size, start) - t;
+    last = std::upper_bound(t, t + size, end) - t;
+    if (first > 0) --first;
+    if (last < size) ++last;
+
+    // Few enough samples are drawn as they are, without columns
+    const int columns = qCeil(width);
+    stops.clear();
+    if (last - first <= 2 * columns) return;
+
+    // End of the samples under each pixel column
+    const double xScale = width / (end - start);
+    int begin = first;
+    stops.resize(columns);
+    for (int x = 0; x < columns; ++x)
+    {
+        const double edge = start + (x + 1) / xScale;
+        stops[x] = (x + 1 < columns) ?
+                    std::lower_bound(t + begin, t + last, edge) - t : last;
+        begin = stops[x];
+    }
+}
+
+void TrackPlot::appendPoints(
+        const Series &s,
+        const QRectF &rect,
+        int first,
+        int last,
+        const QVector< int > &stops,
+        QPolygonF &points) const
+{
+    const double *t = time.constData();
+    const float *values = s.values.constData();
+
+    // Series may be shorter than the time axis
+    last = qMin(last, s.values.size());
+
+    const double xScale = rect.width() / (end - start);
+    const double yScale = (s.maximum > s.minimum) ?
+                rect.height() / (s.maximum - s.minimum) : 0;
+
+    if (stops.isEmpty())
+    {
+        for (int i = first; i < last; ++i)
+        {
+            points << QPointF(rect.left() + (t[i] - start) * xScale,
+                              rect.bottom() - (values[i] - s.minimum) * yScale);
+        }
+        return;
+    }
+
+    // Minimum and maximum of the samples under each pixel column
+    int begin = first;
+    for (int x = 0; x < stops.size() && begin < last; ++x)
+    {
+        const int stop = qMin(stops[x], last);
+        if (stop == begin) continue;
+
+        float minimum, maximum;
+        s.pyramid.range(begin, stop, minimum, maximum);
+
+        const double px = rect.left() + x + 0.5;
+        points << QPointF(px, rect.bottom() - (minimum - s.minimum) * yScale)
+               << QPointF(px, rect.bottom() - (maximum - s.minimum) * yScale);
+
+        begin = stop;
+    }
+}
+
+void TrackPlot::mousePressEvent(
+        QMouseEvent *event)
+{
+    if (event->button() != Qt::LeftButton || end <= start) return;
+
+    if (event->modifiers() & Qt::ShiftModifier)
+    {
+        selecting = true;
+        selectionAnchor = timeAt(event->x());
+        select(selectionAnchor, selectionAnchor);
+    }
+    else
+    {
+        dragging = true;
+        dragX = event->x();
+        setCursor(Qt::ClosedHandCursor);
+    }
+}
+
+void TrackPlot::mouseMoveEvent(
+        QMouseEvent *event)
+{
+    if (selecting)
+    {
+        select(selectionAnchor, timeAt(event->x()));
+        return;
+    }
+
+    if (!dragging) return;
+
+    // Pan by the distance dragged
+    const double dt = (dragX - event->x()) * (end - start) / qMax(plotRect().width(), 1);
+    dragX = event->x();
+
+    setTimeRange(start + dt, end + dt);
+}
+
+void TrackPlot::mouseReleaseEvent(
+        QMouseEvent *event)
+{
+    if (event->button() == Qt::LeftButton)
+    {
+        dragging = false;
+        selecting = false;
+        unsetCursor();
+    }
+}
+
+void TrackPlot::mouseDoubleClickEvent(
+        QMouseEvent *event)
+{
+    Q_UNUSED(event);
+    resetZoom();
+}
+
+void TrackPlot::wheelEvent(
+        QWheelEvent *event)
+{
+    if (end <= start) return;
+
+    // Zoom about the time under the cursor, doubling per two notches
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+    const double x = event->position().x();
+#else
+    const double x = event->posF().x();
+#endif
+
+    const QRect plot = plotRect();
+    const double fraction = qBound(0., (x - plot.left()) / qMax(plot.width(), 1), 1.);
+    const double t = start + fraction * (end - start);
+    const double factor = qPow(2, -event->angleDelta().y() / 240.);
+
+    setTimeRange(t - fraction * (end - start) * factor,
+                 t + (1 - fraction) * (end - start) * factor);
+
+    event->accept();
+}
@@ -0,0 +1,116 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef TRACKPLOT_H
+#define TRACKPLOT_H
+
+#include <QColor>
+#include <QWidget>
+
+#include "trackcolumn.h"
+#include "trackpyramid.h"
+
+class QPolygonF;
+
+// Plots track series against time in stacked lanes. Long tracks are
+// decimated to a minimum and maximum per pixel column, so panning and
+// zooming cost depends on the plot width rather than the track length.
+class TrackPlot : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit TrackPlot(QWidget *parent = 0);
+    ~TrackPlot();
+
+    void setTime(const TrackColumn< double > &time);
+    int addSeries(const QString &name, const TrackColumn< float > &values,
+                  const QColor &color, int lane);
+    void setSeriesValues(int index, const TrackColumn< float > &values);
+    void clearSeries();
+    void clear();
+
+    double startTime() const { return start; }
+    double endTime() const { return end; }
+    void setTimeRange(double start, double end);
+    void resetZoom();
+
+    // Time range chosen by dragging with Shift held
+    bool hasSelection() const { return selectionEnd > selectionStart; }
+    double selectionStartTime() const { return selectionStart; }
+    double selectionEndTime() const { return selectionEnd; }
+    void clearSelection();
+
+signals:
+    void timeRangeChanged(double start, double end);
+    void selectionChanged(double start, double end);
+
+protected:
+    void paintEvent(QPaintEvent *event);
+    void mousePressEvent(QMouseEvent *event);
+    void mouseMoveEvent(QMouseEvent *event);
+    void mouseReleaseEvent(QMouseEvent *event);
+    void mouseDoubleClickEvent(QMouseEvent *event);
+    void wheelEvent(QWheelEvent *event);
+
+private:
+    class Series
+    {
+    public:
+        QString name;
+        TrackColumn< float > values;
+        TrackPyramid pyramid;
+        QColor color;
+        int lane;
+        float minimum;
+        float maximum;
+    };
+
+    TrackColumn< double > time;
+    QVector< Series * > series;
+    int lanes;
+
+    double start;
+    double end;
+
+    bool dragging;
+    int dragX;
+
+    bool selecting;
+    double selectionAnchor;
+    double selectionStart;
+    double selectionEnd;
+
+    QRect plotRect() const;
+    double timeAt(int x) const;
+    void select(double from, double to);
+    QRectF laneRect(int lane) const;
+
+    void drawGrid(QPainter &painter, const QRect &rect) const;
+    void visibleSamples(double width, int &first, int &last,
+                        QVector< int > &stops) const;
+    void appendPoints(const Series &s, const QRectF &rect, int first, int last,
+                      const QVector< int > &stops, QPolygonF &points) const;
+};
+
+#endif // TRACKPLOT_H
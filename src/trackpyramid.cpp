@@ -0,0 +1,158 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "trackpyramid.h"
+
+#include <limits>
+
+TrackPyramid::TrackPyramid() :
+    values(0),
+    count(0)
+{
+
+}
+
+void TrackPyramid::build(
+        const float *data,
+        int size)
+{
+    clear();
+
+    values = data;
+    count = size;
+
+    // Finest level is built from the series
+    const int buckets = (size + PYRAMID_BASE - 1) / PYRAMID_BASE;
+    if (buckets == 0) return;
+
+    QVector< float > levelMinimums(buckets);
+    QVector< float > levelMaximums(buckets);
+
+    for (int b = 0; b < buckets; ++b)
+    {
+        const int begin = b * PYRAMID_BASE;
+        const int end = qMin(begin + PYRAMID_BASE, size);
+
+        float minimum = data[begin];
+        float maximum = data[begin];
+        for (int i = begin + 1; i < end; ++i)
+        {
+            minimum = qMin(minimum, data[i]);
+            maximum = qMax(maximum, data[i]);
+        }
+
+        levelMinimums[b] = minimum;
+        levelMaximums[b] = maximum;
+    }
+
+    minimums.append(levelMinimums);
+    maximums.append(levelMaximums);
+
+    // Each coarser level combines pairs from the level below
+    while (minimums.last().size() > 1)
+    {
+        const QVector< float > &lowerMinimums = minimums.last();
+        const QVector< float > &lowerMaximums = maximums.last();
+        const int lowerSize = lowerMinimums.size();
+        const int upperSize = (lowerSize + 1) / 2;
+
+        QVector< float > upperMinimums(upperSize);
+        QVector< float > upperMaximums(upperSize);
+
+        for (int b = 0; b < upperSize; ++b)
+        {
+            const int left = 2 * b;
+            const int right = qMin(left + 1, lowerSize - 1);
+
+            upperMinimums[b] = qMin(lowerMinimums[left], lowerMinimums[right]);
+            upperMaximums[b] = qMax(lowerMaximums[left], lowerMaximums[right]);
+        }
+
+        minimums.append(upperMinimums);
+        maximums.append(upperMaximums);
+    }
+}
+
+void TrackPyramid::clear()
+{
+    values = 0;
+    count = 0;
+
+    minimums.clear();
+    maximums.clear();
+}
+
+void TrackPyramid::range(
+        int begin,
+        int end,
+        float &minimum,
+        float &maximum) const
+{
+    minimum = std::numeric_limits< float >::infinity();
+    maximum = -std::numeric_limits< float >::infinity();
+
+    begin = qMax(begin, 0);
+    end = qMin(end, count);
+
+    // Read partial buckets from the series
+    while (begin < end && begin % PYRAMID_BASE)
+    {
+        minimum = qMin(minimum, values[begin]);
+        maximum = qMax(maximum, values[begin]);
+        ++begin;
+    }
+    while (end > begin && end % PYRAMID_BASE && end != count)
+    {
+        --end;
+        minimum = qMin(minimum, values[end]);
+        maximum = qMax(maximum, values[end]);
+    }
+
+    if (begin >= end) return;
+
+    // Walk up the levels, taking unpaired buckets at either end
+    int b = begin / PYRAMID_BASE;
+    int e = (end + PYRAMID_BASE - 1) / PYRAMID_BASE;
+
+    for (int level = 0; b < e && level < minimums.size(); ++level)
+    {
+        const QVector< float > &levelMinimums = minimums[level];
+        const QVector< float > &levelMaximums = maximums[level];
+
+        if (b & 1)
+        {
+            minimum = qMin(minimum, levelMinimums[b]);
+            maximum = qMax(maximum, levelMaximums[b]);
+            ++b;
+        }
+        if (e & 1)
+        {
+            --e;
+            minimum = qMin(minimum, levelMinimums[e]);
+            maximum = qMax(maximum, levelMaximums[e]);
+        }
+
+        b /= 2;
+        e /= 2;
+    }
+}
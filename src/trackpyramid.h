@@ -0,0 +1,55 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef TRACKPYRAMID_H
+#define TRACKPYRAMID_H
+
+#include <QVector>
+
+// Samples per bucket at the finest level
+#define PYRAMID_BASE 8
+
+// Minimum and maximum of a series over buckets which double in size
+// from one level to the next. Partial buckets at the ends of a range
+// are read from the series itself, which must outlive the pyramid.
+class TrackPyramid
+{
+public:
+    TrackPyramid();
+
+    void build(const float *values, int size);
+    void clear();
+
+    int size() const { return count; }
+
+    void range(int begin, int end, float &minimum, float &maximum) const;
+
+private:
+    const float *values;
+    int count;
+
+    QVector< QVector< float > > minimums;
+    QVector< QVector< float > > maximums;
+};
+
+#endif // TRACKPYRAMID_H
@@ -0,0 +1,588 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "trackreader.h"
+
+#include <QDirIterator>
+#include <QFile>
+#include <QObject>
+#include <QtAlgorithms>
+
+#include <climits>
+#include <cmath>
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "track.h"
+
+#define MAX_FIELDS 32
+
+typedef enum {
+    IgnoreColumn = -1,
+    TimeColumn   = 0,
+    LatColumn,
+    LonColumn,
+    HMSLColumn,
+    VelNColumn,
+    VelEColumn,
+    VelDColumn,
+    HAccColumn,
+    VAccColumn,
+    SAccColumn,
+    NumSVColumn,
+    ColumnCount
+} Column;
+
+static const char *const columnNames[ColumnCount] =
+{
+    "time", "lat", "lon", "hMSL", "velN", "velE", "velD",
+    "hAcc", "vAcc", "sAcc", "numSV"
+};
+
+// Columns which must be present for a row to be accepted
+static const int requiredColumns =
+        (1 << TimeColumn) | (1 << LatColumn) | (1 << LonColumn)
+        | (1 << HMSLColumn) | (1 << VelNColumn) | (1 << VelEColumn)
+        | (1 << VelDColumn);
+
+// Powers of ten which are exactly representable as doubles
+static const double exactPowersOfTen[] =
+{
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+    1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+    1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static inline bool isDigit(
+        char c)
+{
+    return (unsigned) (c - '0') < 10;
+}
+
+// Returns a bit mask with one bit set for each ',' or '\n' in the 16 bytes
+// starting at p
+static inline quint32 delimiterMask(
+        const char *p)
+{
+#ifdef __SSE2__
+    const __m128i chunk = _mm_loadu_si128((const __m128i *) p);
+    const __m128i commas = _mm_cmpeq_epi8(chunk, _mm_set1_epi8(','));
+    const __m128i newlines = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n'));
+    return _mm_movemask_epi8(_mm_or_si128(commas, newlines));
+#else
+    quint32 mask = 0;
+    for (int i = 0; i < 16; ++i)
+    {
+        if (p[i] == ',' || p[i] == '\n') mask |= 1u << i;
+    }
+    return mask;
+#endif
+}
+
+// Days since 1970-01-01 in the proleptic Gregorian calendar
+static qint64 daysFromCivil(
+        int y,
+        int m,
+        int d)
+{
+    y -= m <= 2;
+    const int era = (y >= 0 ? y : y - 399) / 400;
+    const int yoe = y - era * 400;
+    const int doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return (qint64) era * 146097 + doe - 719468;
+}
+
+static inline bool parseDigits(
+        const char *p,
+        int count,
+        int &value)
+{
+    value = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        if (!isDigit(p[i])) return false;
+        value = value * 10 + (p[i] - '0');
+    }
+    return true;
+}
+
+class TrackParser
+{
+public:
+    TrackParser(const int *columns, int numColumns, Track &track) :
+        columns(columns),
+        numColumns(numColumns),
+        time(track.time.data()),
+        lat(track.lat.data()),
+        lon(track.lon.data()),
+        hMSL(track.hMSL.data()),
+        velN(track.velN.data()),
+        velE(track.velE.data()),
+        velD(track.velD.data()),
+        hAcc(track.hAcc.data()),
+        vAcc(track.vAcc.data()),
+        sAcc(track.sAcc.data()),
+        numSV(track.numSV.data()),
+        rows(0),
+        field(0),
+        parsed(0),
+        valid(true)
+    {
+        for (int i = 0; i < ColumnCount; ++i) row[i] = 0;
+    }
+
+    inline void delimiter(
+            const char *begin,
+            const char *delim)
+    {
+        if (*delim == '\n')
+        {
+            // Strip carriage return from CRLF line endings
+            const char *end = delim;
+            if (end > begin && end[-1] == '\r') --end;
+
+            value(begin, end);
+            endRow();
+        }
+        else
+        {
+            value(begin, delim);
+            ++field;
+        }
+    }
+
+    inline void finish(
+            const char *begin,
+            const char *end)
+    {
+        if (end > begin && end[-1] == '\r') --end;
+        value(begin, end);
+        endRow();
+    }
+
+    int rowCount() const { return rows; }
+
+private:
+    const int *columns;
+    int numColumns;
+
+    double *time;
+    double *lat;
+    double *lon;
+    float *hMSL;
+    float *velN;
+    float *velE;
+    float *velD;
+    float *hAcc;
+    float *vAcc;
+    float *sAcc;
+    float *numSV;
+
+    int rows;
+    int field;
+    int parsed;
+    bool valid;
+    double row[ColumnCount];
+
+    inline void value(
+            const char *begin,
+            const char *end)
+    {
+        const int column = (field < numColumns) ? columns[field] : IgnoreColumn;
+        if (column == IgnoreColumn) return;
+
+        if (column == TimeColumn)
+        {
+            valid &= TrackReader::parseTime(begin, end, row[column]);
+        }
+        else
+        {
+            valid &= TrackReader::parseNumber(begin, end, row[column]);
+        }
+        parsed |= 1 << column;
+    }
+
+    inline void endRow()
+    {
+        // Header units row and damaged lines are skipped
+        if (valid && (parsed & requiredColumns) == requiredColumns)
+        {
+            time[rows]  = row[TimeColumn];
+            lat[rows]   = row[LatColumn];
+            lon[rows]   = row[LonColumn];
+            hMSL[rows]  = row[HMSLColumn];
+            velN[rows]  = row[VelNColumn];
+            velE[rows]  = row[VelEColumn];
+            velD[rows]  = row[VelDColumn];
+            hAcc[rows]  = row[HAccColumn];
+            vAcc[rows]  = row[VAccColumn];
+            sAcc[rows]  = row[SAccColumn];
+            numSV[rows] = row[NumSVColumn];
+            ++rows;
+        }
+
+        // Optional columns missing from the next row read as zero
+        row[HAccColumn] = 0;
+        row[VAccColumn] = 0;
+        row[SAccColumn] = 0;
+        row[NumSVColumn] = 0;
+
+        field = 0;
+        parsed = 0;
+        valid = true;
+    }
+};
+
+TrackReader::TrackReader()
+{
+
+}
+
+bool TrackReader::read(
+        const QString &fileName,
+        Track &track)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        error = file.errorString();
+        return false;
+    }
+
+    const qint64 size = file.size();
+    if (size == 0)
+    {
+        error = QObject::tr("File is empty");
+        return false;
+    }
+
+    bool result;
+
+    // Map the whole file to avoid copying it through a read buffer
+    uchar *data = file.map(0, size);
+    if (data)
+    {
+        result = read((const char *) data, size, track);
+        file.unmap(data);
+    }
+    else
+    {
+        // Fall back to reading into memory when the file can't be mapped
+        const QByteArray buffer = file.readAll();
+        result = read(buffer.constData(), buffer.size(), track);
+    }
+
+    if (result)
+    {
+        track.fileName = fileName;
+    }
+
+    return result;
+}
+
+bool TrackReader::read(
+        const char *data,
+        qint64 size,
+        Track &track)
+{
+    const char *p = data;
+    const char *end = data + size;
+
+    // Find column names
+    const char *eol = (const char *) memchr(p, '\n', size);
+    if (!eol) eol = end;
+
+    int columns[MAX_FIELDS];
+    int numColumns = 0;
+    int found = 0;
+
+    while (p <= eol && numColumns < MAX_FIELDS)
+    {
+        const char *q = p;
+        while (q < eol && *q != ',') ++q;
+
+        const char *nameEnd = q;
+        if (nameEnd > p && nameEnd[-1] == '\r') --nameEnd;
+
+        int column = IgnoreColumn;
+        for (int i = 0; i < ColumnCount; ++i)
+        {
+            const int length = strlen(columnNames[i]);
+            if (nameEnd - p == length && !memcmp(p, columnNames[i], length))
+            {
+                column = i;
+                found |= 1 << i;
+                break;
+            }
+        }
+        columns[numColumns++] = column;
+
+        p = q + 1;
+    }
+
+    if ((found & requiredColumns) != requiredColumns)
+    {
+        error = QObject::tr("Not a FlySight track file");
+        return false;
+    }
+
+    p = (eol < end) ? eol + 1 : end;
+
+    // Size columns for the worst case so rows are written in place
+    const qint64 maxRows = countLines(p, end - p) + 1;
+    if (maxRows > INT_MAX)
+    {
+        error = QObject::tr("Track file is too large");
+        return false;
+    }
+    track.clear();
+    track.resize(maxRows);
+
+    TrackParser parser(columns, numColumns, track);
+
+    // Visit every field delimiter found by the byte scan
+    const char *fieldBegin = p;
+    const qint64 length = end - p;
+    qint64 i = 0;
+
+    for (; i + 16 <= length; i += 16)
+    {
+        quint32 mask = delimiterMask(p + i);
+        while (mask)
+        {
+            const char *delim = p + i + qCountTrailingZeroBits(mask);
+            mask &= mask - 1;
+
+            parser.delimiter(fieldBegin, delim);
+            fieldBegin = delim + 1;
+        }
+    }
+
+    for (const char *q = p + i; q < end; ++q)
+    {
+        if (*q == ',' || *q == '\n')
+        {
+            parser.delimiter(fieldBegin, q);
+            fieldBegin = q + 1;
+        }
+    }
+
+    // Last line may not be terminated
+    if (fieldBegin < end)
+    {
+        parser.finish(fieldBegin, end);
+    }
+
+    track.resize(parser.rowCount());
+    track.updateBlocks();
+
+    return true;
+}
+
+bool TrackReader::parseNumber(
+        const char *begin,
+        const char *end,
+        double &value)
+{
+    const char *p = begin;
+
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+'))
+    {
+        negative = (*p == '-');
+        ++p;
+    }
+
+    // Accumulate up to 19 significant digits in an integer
+    quint64 mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    bool any = false;
+
+    for (; p < end && isDigit(*p); ++p)
+    {
+        if (digits < 19)
+        {
+            mantissa = mantissa * 10 + (*p - '0');
+            if (mantissa) ++digits;
+        }
+        else
+        {
+            ++exponent;
+        }
+        any = true;
+    }
+
+    if (p < end && *p == '.')
+    {
+        for (++p; p < end && isDigit(*p); ++p)
+        {
+            if (digits < 19)
+            {
+                mantissa = mantissa * 10 + (*p - '0');
+                if (mantissa) ++digits;
+                --exponent;
+            }
+            any = true;
+        }
+    }
+
+    if (!any) return false;
+
+    if (p < end && (*p == 'e' || *p == 'E'))
+    {
+        ++p;
+
+        bool negativeExponent = false;
+        if (p < end && (*p == '-' || *p == '+'))
+        {
+            negativeExponent = (*p == '-');
+            ++p;
+        }
+
+        if (p == end) return false;
+
+        int e = 0;
+        for (; p < end && isDigit(*p); ++p)
+        {
+            if (e < 10000) e = e * 10 + (*p - '0');
+        }
+        exponent += negativeExponent ? -e : e;
+    }
+
+    if (p != end) return false;
+
+    // Exact when the mantissa fits in 53 bits and the scale is exact
+    double result = (double) mantissa;
+    if (exponent < 0)
+    {
+        if (exponent >= -22) result /= exactPowersOfTen[-exponent];
+        else result *= pow(10., exponent);
+    }
+    else if (exponent > 0)
+    {
+        if (exponent <= 22) result *= exactPowersOfTen[exponent];
+        else result *= pow(10., exponent);
+    }
+
+    value = negative ? -result : result;
+    return true;
+}
+
+bool TrackReader::parseTime(
+        const char *begin,
+        const char *end,
+        double &value)
+{
+    // YYYY-MM-DDTHH:MM:SS[.sss][Z]
+    if (end - begin < 19) return false;
+    if (begin[4] != '-' || begin[7] != '-' || begin[10] != 'T'
+            || begin[13] != ':' || begin[16] != ':')
+    {
+        return false;
+    }
+
+    int year, month, day, hour, minute, second;
+    if (!parseDigits(begin, 4, year)) return false;
+    if (!parseDigits(begin + 5, 2, month)) return false;
+    if (!parseDigits(begin + 8, 2, day)) return false;
+    if (!parseDigits(begin + 11, 2, hour)) return false;
+    if (!parseDigits(begin + 14, 2, minute)) return false;
+    if (!parseDigits(begin + 17, 2, second)) return false;
+
+    if (month < 1 || month > 12 || day < 1 || day > 31) return false;
+    if (hour > 23 || minute > 59 || second > 60) return false;
+
+    const char *p = begin + 19;
+
+    double fraction = 0;
+    if (p < end && *p == '.')
+    {
+        int digits = 0;
+        qint64 numerator = 0;
+        for (++p; p < end && isDigit(*p); ++p)
+        {
+            if (digits < 18)
+            {
+                numerator = numerator * 10 + (*p - '0');
+                ++digits;
+            }
+        }
+        fraction = numerator / exactPowersOfTen[digits];
+    }
+
+    if (p < end && *p == 'Z') ++p;
+    if (p != end) return false;
+
+    const qint64 seconds = daysFromCivil(year, month, day) * 86400
+            + hour * 3600 + minute * 60 + second;
+
+    value = seconds + fraction;
+    return true;
+}
+
+qint64 TrackReader::countLines(
+        const char *data,
+        qint64 size)
+{
+    qint64 count = 0;
+    qint64 i = 0;
+
+#ifdef __SSE2__
+    const __m128i newline = _mm_set1_epi8('\n');
+    for (; i + 16 <= size; i += 16)
+    {
+        const __m128i chunk = _mm_loadu_si128((const __m128i *) (data + i));
+        count += qPopulationCount((quint32) _mm_movemask_epi8(
+                                      _mm_cmpeq_epi8(chunk, newline)));
+    }
+#endif
+
+    for (; i < size; ++i)
+    {
+        if (data[i] == '\n') ++count;
+    }
+
+    return count;
+}
+
+QStringList TrackReader::findTracks(
+        const QString &folder)
+{
+    QStringList fileNames;
+
+    // Logs are stored in one folder per day
+    QDirIterator it(folder, QStringList() << "*.csv",
+                    QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext())
+    {
+        fileNames.append(it.next());
+    }
+
+    fileNames.sort();
+    return fileNames;
+}
@@ -0,0 +1,53 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef TRACKREADER_H
+#define TRACKREADER_H
+
+#include <QString>
+#include <QStringList>
+
+class Track;
+
+class TrackReader
+{
+public:
+    TrackReader();
+
+    bool read(const QString &fileName, Track &track);
+    bool read(const char *data, qint64 size, Track &track);
+
+    QString errorString() const { return error; }
+
+    static bool parseNumber(const char *begin, const char *end, double &value);
+    static bool parseTime(const char *begin, const char *end, double &value);
+
+    static qint64 countLines(const char *data, qint64 size);
+
+    static QStringList findTracks(const QString &folder);
+
+private:
+    QString error;
+};
+
+#endif // TRACKREADER_H
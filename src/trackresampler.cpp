@@ -0,0 +1,181 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "trackresampler.h"
+
+#include <cmath>
+
+#include "track.h"
+
+// Spacing error (s) still treated as uniform
+#define RESAMPLE_TOLERANCE 0.002
+
+TrackResampler::TrackResampler(
+        const Configuration &configuration) :
+    period(configuration.rate / 1000.)
+{
+
+}
+
+bool TrackResampler::isUniform(
+        const Track &track) const
+{
+    const double *time = track.time.constData();
+
+    for (int i = 1; i < track.size(); ++i)
+    {
+        if (fabs(time[i] - time[i - 1] - period) > RESAMPLE_TOLERANCE)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+Track TrackResampler::resample(
+        const Track &source) const
+{
+    const int size = source.size();
+    if (size < 2 || period <= 0 || isUniform(source)) return source;
+
+    const double *time = source.time.constData();
+    const double first = time[0];
+    const int maxRows = (int) floor((time[size - 1] - first) / period) + 1;
+
+    Track track;
+    track.fileName = source.fileName;
+    track.resize(maxRows);
+
+    Taps taps;
+    taps.reserve(RESAMPLE_BLOCK_SIZE);
+
+    double *outTime = track.time.data();
+    int rows = 0;
+    int j = 0;
+
+    for (int k = 0; k < maxRows; ++k)
+    {
+        const double t = first + k * period;
+
+        // Interval containing this output time
+        while (j + 2 < size && time[j + 1] <= t) ++j;
+
+        const double h = time[j + 1] - time[j];
+        if (h > 0 && h <= RESAMPLE_MAX_GAP)
+        {
+            const double u = (t - time[j]) / h;
+            const double u2 = u * u;
+            const double u3 = u2 * u;
+
+            Tap tap;
+            tap.index = j;
+            tap.before = qMax(j - 1, 0);
+            tap.after = qMin(j + 2, size - 1);
+            tap.w0 = 2 * u3 - 3 * u2 + 1;
+            tap.w1 = -2 * u3 + 3 * u2;
+            tap.d0 = (u3 - 2 * u2 + u) * h;
+            tap.d1 = (u3 - u2) * h;
+            tap.s0 = (time[j + 1] > time[tap.before]) ? 1 / (time[j + 1] - time[tap.before]) : 0;
+            tap.s1 = (time[tap.after] > time[j]) ? 1 / (time[tap.after] - time[j]) : 0;
+            tap.nearEnd = u >= 0.5;
+
+            outTime[rows + taps.size()] = t;
+            taps.append(tap);
+        }
+
+        // Weights are shared by every column in the block
+        if (taps.size() == RESAMPLE_BLOCK_SIZE || (k + 1 == maxRows && !taps.isEmpty()))
+        {
+            interpolate(source, taps, track, rows);
+            rows += taps.size();
+            taps.resize(0);
+        }
+    }
+
+    track.resize(rows);
+    track.updateBlocks();
+
+    return track;
+}
+
+void TrackResampler::interpolate(
+        const Track &source,
+        const Taps &taps,
+        Track &track,
+        int offset) const
+{
+    cubic(source.lat.constData(), taps, track.lat.data() + offset);
+    cubic(source.lon.constData(), taps, track.lon.data() + offset);
+    cubic(source.velN.constData(), taps, track.velN.data() + offset);
+    cubic(source.velE.constData(), taps, track.velE.data() + offset);
+    cubic(source.velD.constData(), taps, track.velD.data() + offset);
+
+    // Altitude uses the measured climb rate as its slope
+    const float *hMSL = source.hMSL.constData();
+    const float *velD = source.velD.constData();
+    float *out = track.hMSL.data() + offset;
+
+    for (int i = 0; i < taps.size(); ++i)
+    {
+        const Tap &tap = taps[i];
+        out[i] = tap.w0 * hMSL[tap.index] + tap.w1 * hMSL[tap.index + 1]
+                - tap.d0 * velD[tap.index] - tap.d1 * velD[tap.index + 1];
+    }
+
+    nearest(source.hAcc.constData(), taps, track.hAcc.data() + offset);
+    nearest(source.vAcc.constData(), taps, track.vAcc.data() + offset);
+    nearest(source.sAcc.constData(), taps, track.sAcc.data() + offset);
+    nearest(source.numSV.constData(), taps, track.numSV.data() + offset);
+}
+
+template< typename T >
+void TrackResampler::cubic(
+        const T *in,
+        const Taps &taps,
+        T *out)
+{
+    for (int i = 0; i < taps.size(); ++i)
+    {
+        const Tap &tap = taps[i];
+        const T y0 = in[tap.index];
+        const T y1 = in[tap.index + 1];
+
+        out[i] = tap.w0 * y0 + tap.w1 * y1
+                + tap.d0 * tap.s0 * (y1 - in[tap.before])
+                + tap.d1 * tap.s1 * (in[tap.after] - y0);
+    }
+}
+
+template< typename T >
+void TrackResampler::nearest(
+        const T *in,
+        const Taps &taps,
+        T *out)
+{
+    for (int i = 0; i < taps.size(); ++i)
+    {
+        const Tap &tap = taps[i];
+        out[i] = in[tap.nearEnd ? tap.index + 1 : tap.index];
+    }
+}
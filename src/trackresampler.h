@@ -0,0 +1,84 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef TRACKRESAMPLER_H
+#define TRACKRESAMPLER_H
+
+#include <QVector>
+
+#include "configuration.h"
+
+class Track;
+
+// Output samples interpolated together
+#define RESAMPLE_BLOCK_SIZE 1024
+
+// Source intervals longer than this (s) are left without samples
+#define RESAMPLE_MAX_GAP 5.0
+
+// Re-times a track to the measurement period in Rate, so a track
+// recorded at one rate can be simulated at another. Positions and
+// velocities use cubic Hermite interpolation, and accuracy columns take
+// the nearest sample.
+class TrackResampler
+{
+public:
+    explicit TrackResampler(const Configuration &configuration);
+
+    // True if samples are already spaced at the period
+    bool isUniform(const Track &track) const;
+
+    // Returns the track itself, sharing its columns, if it is uniform
+    Track resample(const Track &track) const;
+
+private:
+    class Tap
+    {
+    public:
+        int index;          // Interval start
+        int before;         // Sample before the start, for its slope
+        int after;          // Sample after the end, for its slope
+        double w0;          // Weight of the start value
+        double w1;          // Weight of the end value
+        double d0;          // Weight of the start derivative
+        double d1;          // Weight of the end derivative
+        double s0;          // Reciprocal of the span for the start slope
+        double s1;          // Reciprocal of the span for the end slope
+        bool nearEnd;       // End sample is the nearest
+    };
+
+    typedef QVector< Tap > Taps;
+
+    double period;
+
+    void interpolate(const Track &source, const Taps &taps,
+                     Track &track, int offset) const;
+
+    template< typename T >
+    static void cubic(const T *in, const Taps &taps, T *out);
+
+    template< typename T >
+    static void nearest(const T *in, const Taps &taps, T *out);
+};
+
+#endif // TRACKRESAMPLER_H
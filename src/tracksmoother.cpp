@@ -0,0 +1,268 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "tracksmoother.h"
+
+#include <QtGlobal>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "track.h"
+
+static float dot(
+        const float *values,
+        const float *weights,
+        int width)
+{
+    float sum = 0;
+    for (int j = 0; j < width; ++j)
+    {
+        sum += weights[j] * values[j];
+    }
+    return sum;
+}
+
+TrackSmoother::Weights::Weights(
+        int halfWidth) :
+    halfWidth(halfWidth),
+    width(2 * halfWidth + 1),
+    table(width * width)
+{
+    const int order = qMin(SMOOTH_ORDER, width - 1);
+    const int n = order + 1;
+
+    // Normal equations of the fit, which depend only on the window
+    double normal[SMOOTH_ORDER + 1][SMOOTH_ORDER + 1];
+    for (int a = 0; a < n; ++a)
+    {
+        for (int b = 0; b < n; ++b)
+        {
+            normal[a][b] = 0;
+            for (int j = -halfWidth; j <= halfWidth; ++j)
+            {
+                double power = 1;
+                for (int k = 0; k < a + b; ++k) power *= j;
+                normal[a][b] += power;
+            }
+        }
+    }
+
+    for (int r = 0; r < width; ++r)
+    {
+        // Solve for c such that the fit at t is the sum of c[a] * j^a
+        // times each sample j
+        const double t = r - halfWidth;
+
+        double m[SMOOTH_ORDER + 1][SMOOTH_ORDER + 2];
+        for (int a = 0; a < n; ++a)
+        {
+            for (int b = 0; b < n; ++b)
+            {
+                m[a][b] = normal[a][b];
+            }
+
+            double power = 1;
+            for (int k = 0; k < a; ++k) power *= t;
+            m[a][n] = power;
+        }
+
+        // Gauss-Jordan elimination with partial pivoting
+        for (int a = 0; a < n; ++a)
+        {
+            int pivot = a;
+            for (int b = a + 1; b < n; ++b)
+            {
+                if (qAbs(m[b][a]) > qAbs(m[pivot][a])) pivot = b;
+            }
+
+            for (int b = 0; b <= n; ++b)
+            {
+                qSwap(m[a][b], m[pivot][b]);
+            }
+
+            for (int b = 0; b < n; ++b)
+            {
+                if (b == a) continue;
+
+                const double f = m[b][a] / m[a][a];
+                for (int k = a; k <= n; ++k)
+                {
+                    m[b][k] -= f * m[a][k];
+                }
+            }
+        }
+
+        float *weights = table.data() + r * width;
+        for (int j = -halfWidth; j <= halfWidth; ++j)
+        {
+            double w = 0, power = 1;
+            for (int a = 0; a < n; ++a)
+            {
+                w += m[a][n] / m[a][a] * power;
+                power *= j;
+            }
+            weights[j + halfWidth] = w;
+        }
+    }
+}
+
+TrackSmoother::TrackSmoother(
+        double window) :
+    window(window)
+{
+
+}
+
+int TrackSmoother::halfWidth(
+        const Track &track) const
+{
+    if (window <= 0) return 0;
+
+    // Mean spacing, ignoring gaps between segments
+    const double *time = track.time.constData();
+    double sum = 0;
+    int count = 0;
+
+    for (int i = 1; i < track.size(); ++i)
+    {
+        const double dt = time[i] - time[i - 1];
+        if (dt > 0 && dt <= SMOOTH_MAX_GAP)
+        {
+            sum += dt;
+            ++count;
+        }
+    }
+
+    if (count == 0) return 0;
+
+    return qRound(window * count / sum / 2);
+}
+
+Track TrackSmoother::smooth(
+        const Track &track) const
+{
+    Track result = track;
+
+    const int halfWidth = this->halfWidth(track);
+    if (halfWidth <= 0) return result;
+
+    const Weights weights(halfWidth);
+
+    const int size = track.size();
+    const double *time = track.time.constData();
+    const float *velN = track.velN.constData();
+    const float *velE = track.velE.constData();
+    const float *velD = track.velD.constData();
+
+    QVector< float > outN(size), outE(size), outD(size);
+
+    int begin = 0;
+    for (int end = 1; end <= size; ++end)
+    {
+        if (end < size && time[end] - time[end - 1] <= SMOOTH_MAX_GAP) continue;
+
+        // Short segments use a narrower window
+        const int length = end - begin;
+        const int segmentHalfWidth = qMin(halfWidth, (length - 1) / 2);
+        const Weights narrow(segmentHalfWidth < halfWidth ? segmentHalfWidth : 0);
+        const Weights &w = (segmentHalfWidth < halfWidth) ? narrow : weights;
+
+        // Blocks keep each column's window in cache between outputs
+        for (int offset = 0; offset < length; offset += SMOOTH_BLOCK_SIZE)
+        {
+            const int count = qMin(SMOOTH_BLOCK_SIZE, length - offset);
+            smoothColumn(velN, outN.data(), begin, end, offset, count, w);
+            smoothColumn(velE, outE.data(), begin, end, offset, count, w);
+            smoothColumn(velD, outD.data(), begin, end, offset, count, w);
+        }
+
+        begin = end;
+    }
+
+    result.velN = TrackColumn< float >(outN);
+    result.velE = TrackColumn< float >(outE);
+    result.velD = TrackColumn< float >(outD);
+
+    result.updateBlocks(Track::VelN);
+    result.updateBlocks(Track::VelE);
+    result.updateBlocks(Track::VelD);
+
+    return result;
+}
+
+void TrackSmoother::smoothColumn(
+        const float *in,
+        float *out,
+        int begin,
+        int end,
+        int offset,
+        int count,
+        const Weights &weights)
+{
+    const int halfWidth = weights.halfWidth;
+    const int width = weights.width;
+    const int size = end - begin;
+    const int stop = offset + count;
+
+    in += begin;
+    out += begin;
+
+    int k = offset;
+
+    // Fits near the start of the segment share its first window
+    for (; k < stop && k < halfWidth; ++k)
+    {
+        out[k] = dot(in, weights.row(k), width);
+    }
+
+    const int middleEnd = qMin(stop, size - halfWidth);
+    const float *centre = weights.row(halfWidth);
+
+#ifdef __SSE2__
+    // Four outputs at a time, each summing the same weights
+    for (; k + 4 <= middleEnd; k += 4)
+    {
+        const float *x = in + k - halfWidth;
+        __m128 sum = _mm_setzero_ps();
+        for (int j = 0; j < width; ++j)
+        {
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(centre[j]),
+                                             _mm_loadu_ps(x + j)));
+        }
+        _mm_storeu_ps(out + k, sum);
+    }
+#endif
+
+    for (; k < middleEnd; ++k)
+    {
+        out[k] = dot(in + k - halfWidth, centre, width);
+    }
+
+    // Fits near the end of the segment share its last window
+    for (; k < stop; ++k)
+    {
+        out[k] = dot(in + size - width, weights.row(k - (size - width)), width);
+    }
+}
@@ -0,0 +1,78 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Configurator                                                 **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef TRACKSMOOTHER_H
+#define TRACKSMOOTHER_H
+
+#include <QVector>
+
+class Track;
+
+// Output samples smoothed together, column by column
+#define SMOOTH_BLOCK_SIZE 4096
+
+// Degree of the fitted polynomial
+#define SMOOTH_ORDER 2
+
+// Samples further apart than this (s) are smoothed separately
+#define SMOOTH_MAX_GAP 5.0
+
+// Savitzky-Golay smoothing of the velocity columns. Each output is a
+// least squares quadratic fit over a window of samples, which reduces
+// noise without flattening peaks as much as a moving average.
+class TrackSmoother
+{
+public:
+    // Window length in seconds, or zero to leave tracks unchanged
+    explicit TrackSmoother(double window);
+
+    // Returns the track with velN, velE and velD smoothed, sharing its
+    // other columns
+    Track smooth(const Track &track) const;
+
+    // Samples on each side of the centre for the track's sample spacing
+    int halfWidth(const Track &track) const;
+
+private:
+    // Fit weights for a window of 2 * halfWidth + 1 samples. Row r gives
+    // the fit at sample r of the window, so the middle row is used away
+    // from the ends of a segment.
+    class Weights
+    {
+    public:
+        explicit Weights(int halfWidth);
+
+        int halfWidth;
+        int width;
+        QVector< float > table;
+
+        const float *row(int r) const { return table.constData() + r * width; }
+    };
+
+    double window;
+
+    static void smoothColumn(const float *in, float *out, int begin, int end,
+                             int offset, int count, const Weights &weights);
+};
+
+#endif // TRACKSMOOTHER_H